@@ -0,0 +1,112 @@
+/** Benchmark of the generated equations of state against HEOS
+ *
+ * Evaluates pressure, enthalpy, and entropy with first and second
+ * derivatives at random single-phase states, once by the generated code
+ * (see propssieosgen.h) and once through CoolProp's HEOS backend as the
+ * library does without PROPSSI_EOSGEN (see evalprops()). Reports the time
+ * per evaluation and the largest relative deviation.
+ *
+ * Usage:
+ *
+ *   eosbench [fluid [npoints]]
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o eosbench eosbench.c propssieosgen.c propssiengine.c propssicache.c
+ *       libCoolProp.[so|dylib] -lm -lpthread [-lrt on Linux]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "CoolPropLib.h"
+#include "propssiengine.h"
+#include "propssieosgen.h"
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   static const char* props[] = { "P", "H", "S" };
+   const char* fluid = argc > 1 ? argv[1] : "Water";
+   int npoints = argc > 2 ? atoi(argv[2]) : 1000;
+   char msg[ENGINE_MSGSIZE];
+   double* T;
+   double* D;
+   double Tc, Dc;
+   int i, p;
+
+   if( !eosgenhas(fluid) )
+   {
+      fprintf(stderr, "eosbench: no generated equation of state for %s\n", fluid);
+      return 1;
+   }
+   if( npoints <= 0 )
+      npoints = 1000;
+
+   Tc = Props1SI(fluid, "Tcrit");
+   Dc = Props1SI(fluid, "rhomass_critical");
+   T = malloc(npoints * sizeof(double));
+   D = malloc(npoints * sizeof(double));
+   srand(1);
+   for( i = 0; i < npoints; ++i )
+   {
+      T[i] = Tc * (1.05 + rand() / (double)RAND_MAX);
+      D[i] = Dc * (0.05 + 1.5 * rand() / (double)RAND_MAX);
+   }
+
+   printf("%s, %d states, value with first and second derivatives\n", fluid, npoints);
+   printf("%-4s %14s %14s %10s %12s\n", "Prop", "eosgen [us]", "HEOS [us]", "speedup", "max reldev");
+   for( p = 0; p < 3; ++p )
+   {
+      double dgen[6], dheos[6];
+      double maxdev = 0.0;
+      double sum = 0.0;
+      clock_t start;
+      double tgen, theos;
+
+      start = clock();
+      for( i = 0; i < npoints; ++i )
+      {
+         eosgenprops(props[p], T[i], D[i], fluid, dgen);
+         sum += dgen[0];
+      }
+      tgen = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+      start = clock();
+      for( i = 0; i < npoints; ++i )
+      {
+         if( evalprops(NULL, props[p], "T", T[i], "D", D[i], fluid, 2, dheos, msg) != 0 )
+         {
+            fprintf(stderr, "eosbench: %s\n", msg);
+            return 1;
+         }
+         sum -= dheos[0];
+      }
+      theos = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+      for( i = 0; i < npoints; ++i )
+      {
+         int k;
+         eosgenprops(props[p], T[i], D[i], fluid, dgen);
+         evalprops(NULL, props[p], "T", T[i], "D", D[i], fluid, 2, dheos, msg);
+         for( k = 0; k < 6; ++k )
+         {
+            double dev = fabs(dgen[k] - dheos[k]) / (fabs(dheos[k]) > 1e-10 ? fabs(dheos[k]) : 1.0);
+            if( dev > maxdev )
+               maxdev = dev;
+         }
+      }
+
+      printf("%-4s %14.3f %14.3f %10.1f %12.2e\n", props[p], 1e6 * tgen / npoints, 1e6 * theos / npoints,
+         tgen > 0.0 ? theos / tgen : 0.0, maxdev);
+      (void)sum;
+   }
+
+   free(T);
+   free(D);
+   return 0;
+}
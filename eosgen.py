@@ -0,0 +1,174 @@
+#!/usr/bin/env python
+
+'''
+This script generates C code for the Helmholtz energy equations of state
+of selected fluids from CoolProp's fluid data, see propssieosgen.h.
+
+Usage:
+    ./eosgen.py {<fluid>|<file.json>}
+
+Fluids given by name are taken from the CoolProp Python package, which
+should be of the same version as the CoolProp library that is linked.
+Fluid data can also be read from files as written by
+CoolProp.CoolProp.get_fluid_param_string(<fluid>, "JSON").
+If called without arguments, code is generated for the fluids of FLUID2
+in propssicclib.c.
+
+The output is written to propssieosgen.c.
+
+This script requires Python >= 3.0.
+Additionally, we require Jinja (http://jinja.pocoo.org/docs/).
+'''
+
+import os;
+import sys;
+import json;
+import jinja2;
+
+# fluids of FLUID2 in propssicclib.c
+DEFAULTFLUIDS = ['Water', 'R134a', 'Air'];
+
+# dual numbers carry Taylor coefficients in (T, D) up to this order
+ORDER = 3;
+
+# the Taylor coefficients in the order they are stored
+MONOMIALS = [(k - j, j) for k in range(ORDER + 1) for j in range(k + 1)];
+
+def lit(x) :
+    '''C literal for a coefficient'''
+    return repr(float(x));
+
+def loadfluid(arg) :
+    '''returns the fluid data as dictionary'''
+    if arg.endswith('.json') :
+        with open(arg) as f :
+            data = json.load(f);
+    else :
+        import CoolProp.CoolProp as CP;
+        data = json.loads(CP.get_fluid_param_string(arg, 'JSON'));
+    # CoolProp returns a list with one fluid
+    if isinstance(data, list) :
+        data = data[0];
+    return data;
+
+def termlist(term, keys) :
+    '''zips the coefficient lists of a term'''
+    return list(zip(*[term[k] for k in keys]));
+
+def alphar(terms) :
+    '''C statements accumulating the residual Helmholtz energy in ar'''
+    code = [];
+    for term in terms :
+        if term['type'] == 'ResidualHelmholtzPower' :
+            for n, d, t, l in termlist(term, ['n', 'd', 't', 'l']) :
+                code.append(exponential(n, d, t, 1.0 if l != 0 else 0.0, l));
+        elif term['type'] == 'ResidualHelmholtzExponential' :
+            for n, d, t, g, l in termlist(term, ['n', 'd', 't', 'g', 'l']) :
+                code.append(exponential(n, d, t, g, l));
+        elif term['type'] == 'ResidualHelmholtzGaussian' :
+            for n, d, t, eta, eps, beta, gam in termlist(term, ['n', 'd', 't', 'eta', 'epsilon', 'beta', 'gamma']) :
+                code.append('x = duallin(%s, lnd, %s, lnt);' % (lit(d), lit(t)));
+                code.append('u = dualshift(delta, %s);' % lit(-eps));
+                code.append('x = dualaxpy(x, %s, dualmul(u, u));' % lit(-eta));
+                code.append('u = dualshift(tau, %s);' % lit(-gam));
+                code.append('x = dualaxpy(x, %s, dualmul(u, u));' % lit(-beta));
+                code.append('ar = dualaxpy(ar, %s, dualexp(x));' % lit(n));
+        elif term['type'] == 'ResidualHelmholtzNonAnalytic' :
+            # n Delta^b delta psi with ((delta-1)^2)^p written as |delta-1|^(2p)
+            code.append('v = dualabsnz(dualshift(delta, -1.0));');
+            code.append('w = dualshift(tau, -1.0);');
+            for n, a, b, beta, A, B, C, D in termlist(term, ['n', 'a', 'b', 'beta', 'A', 'B', 'C', 'D']) :
+                code.append('x = dualaxpy(dualshift(dualscale(tau, -1.0), 1.0), %s, dualpow(v, %s));' % (lit(A), lit(1.0 / beta)));
+                code.append('x = dualaxpy(dualmul(x, x), %s, dualpow(v, %s));' % (lit(B), lit(2.0 * a)));
+                code.append('u = dualexp(dualaxpy(dualscale(dualmul(v, v), %s), %s, dualmul(w, w)));' % (lit(-C), lit(-D)));
+                code.append('ar = dualaxpy(ar, %s, dualmul(dualmul(dualpow(x, %s), delta), u));' % (lit(n), lit(b)));
+        else :
+            raise ValueError('residual term ' + term['type'] + ' not supported');
+    return code;
+
+def exponential(n, d, t, g, l) :
+    '''C statement for n delta^d tau^t exp(-g delta^l)'''
+    if g == 0 :
+        return 'ar = dualaxpy(ar, %s, dualexp(duallin(%s, lnd, %s, lnt)));' % (lit(n), lit(d), lit(t));
+    return 'ar = dualaxpy(ar, %s, dualexp(dualaxpy(duallin(%s, lnd, %s, lnt), %s, dualexp(dualscale(lnd, %s)))));' % (lit(n), lit(d), lit(t), lit(-g), lit(l));
+
+def alpha0(terms) :
+    '''C statements accumulating the ideal-gas Helmholtz energy in a0'''
+    a1 = 0.0;
+    a2 = 0.0;
+    logtau = 0.0;
+    code = [];
+    for term in terms :
+        if term['type'] in ['IdealGasHelmholtzLead', 'IdealGasHelmholtzEnthalpyEntropyOffset'] :
+            a1 += term['a1'];
+            a2 += term['a2'];
+        elif term['type'] == 'IdealGasHelmholtzLogTau' :
+            logtau += term['a'] if 'a' in term else term['a1'];
+        elif term['type'] == 'IdealGasHelmholtzPower' :
+            for n, t in termlist(term, ['n', 't']) :
+                code.append('a0 = dualaxpy(a0, %s, dualexp(dualscale(lnt, %s)));' % (lit(n), lit(t)));
+        elif term['type'] == 'IdealGasHelmholtzPlanckEinstein' :
+            for n, t in termlist(term, ['n', 't']) :
+                code.append('a0 = dualaxpy(a0, %s, duallog(dualshift(dualscale(dualexp(dualscale(tau, %s)), -1.0), 1.0)));' % (lit(n), lit(-t)));
+        elif term['type'] == 'IdealGasHelmholtzPlanckEinsteinGeneralized' :
+            for n, t, c, d in termlist(term, ['n', 't', 'c', 'd']) :
+                code.append('a0 = dualaxpy(a0, %s, duallog(dualshift(dualscale(dualexp(dualscale(tau, %s)), %s), %s)));' % (lit(n), lit(t), lit(d), lit(c)));
+        else :
+            raise ValueError('ideal-gas term ' + term['type'] + ' not supported');
+    code.insert(0, 'a0 = dualaxpy(dualaxpy(dualshift(dualscale(tau, %s), %s), %s, lnt), 1.0, lnd);' % (lit(a2), lit(a1), lit(logtau)));
+    return code;
+
+def ancillary(anc) :
+    '''C expression for a saturated molar density ancillary at temperature t'''
+    theta = '(1.0 - t / %s)' % lit(anc['T_r']);
+    s = ' + '.join('%s * pow(%s, %s)' % (lit(n), theta, lit(t)) for n, t in zip(anc['n'], anc['t']));
+    if anc['type'] == 'rhoLnoexp' :
+        return '%s * (1.0 + %s)' % (lit(anc['reducing_value']), s);
+    if anc.get('using_tau_r', False) :
+        return '%s * exp(%s / t * (%s))' % (lit(anc['reducing_value']), lit(anc['T_r']), s);
+    return '%s * exp(%s)' % (lit(anc['reducing_value']), s);
+
+def processFluid(arg) :
+    data = loadfluid(arg);
+    eos = data['EOS'][0];
+    anc = data['ANCILLARIES'];
+    fluid = {};
+    fluid['name'] = data['INFO']['NAME'];
+    fluid['cname'] = ''.join(c if c.isalnum() else '_' for c in fluid['name']);
+    fluid['reference'] = eos.get('BibTeX_EOS', '');
+    fluid['R'] = lit(eos['gas_constant']);
+    fluid['M'] = lit(eos['molar_mass']);
+    fluid['Tr'] = lit(eos['STATES']['reducing']['T']);
+    fluid['rhor'] = lit(eos['STATES']['reducing']['rhomolar']);
+    fluid['alphar'] = alphar(eos['alphar']);
+    fluid['alpha0'] = alpha0(eos['alpha0']);
+    # states closer to the ancillaries than their stated uncertainty are left to CoolProp
+    fluid['rhoL'] = ancillary(anc['rhoL']);
+    fluid['rhoV'] = ancillary(anc['rhoV']);
+    fluid['marginL'] = lit(0.01 + 0.02 * anc['rhoL'].get('max_abserror_percentage', 5.0));
+    fluid['marginV'] = lit(0.01 + 0.02 * anc['rhoV'].get('max_abserror_percentage', 5.0));
+    fluid['Tsingle'] = lit(max(anc['rhoL']['Tmax'], anc['rhoV']['Tmax']));
+    fluid['Tlow'] = lit(max(anc['rhoL']['Tmin'], anc['rhoV']['Tmin']));
+    fluid['TL'] = lit(anc['rhoL']['Tmax']);
+    fluid['TV'] = lit(anc['rhoV']['Tmax']);
+    return fluid;
+
+def dualmultable() :
+    '''for each Taylor coefficient of a product, the pairs of factor coefficients contributing to it'''
+    table = [];
+    for (i, j) in MONOMIALS :
+        table.append([(MONOMIALS.index((i1, j1)), MONOMIALS.index((i - i1, j - j1)))
+                      for (i1, j1) in MONOMIALS if i1 <= i and j1 <= j]);
+    return table;
+
+args = sys.argv[1:] if len(sys.argv) > 1 else DEFAULTFLUIDS;
+fluids = [processFluid(a) for a in args];
+
+env = jinja2.Environment(loader = jinja2.FileSystemLoader(os.path.dirname(os.path.abspath(__file__))),
+                         line_statement_prefix = '#',
+                         line_comment_prefix = '##');
+template = env.get_template('eosgen_template.c');
+outname = 'propssieosgen.c';
+print('Generating', outname);
+outfile = open(outname, 'w');
+print(template.render(fluids = fluids, order = ORDER, monomials = MONOMIALS, multable = dualmultable(), ncoef = len(MONOMIALS)), file=outfile);
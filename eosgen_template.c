@@ -0,0 +1,357 @@
+/* Generated equations of state, see propssieosgen.h
+ * This file is created by eosgen.py.
+ */
+
+{{'#'}}include <stdio.h>
+{{'#'}}include <string.h>
+{{'#'}}include <math.h>
+
+{{'#'}}include "CoolPropLib.h"
+{{'#'}}include "propssieosgen.h"
+
+/** forward-mode dual number in (T, D)
+ *
+ * Holds the Taylor coefficients of a quantity up to order {{order}} in T and D,
+ * so that outputs involving first derivatives of the Helmholtz energy,
+ * like pressure or enthalpy, still have exact second derivatives.
+ * The coefficients are stored in the order
+# for m in monomials
+ *   T^{{m[0]}} D^{{m[1]}}
+# endfor
+ */
+typedef struct
+{
+   double c[{{ncoef}}];
+} DUAL;
+
+static DUAL dualshift(
+   DUAL                  a,
+   double                s
+   )
+{
+   a.c[0] += s;
+   return a;
+}
+
+static DUAL dualscale(
+   DUAL                  a,
+   double                s
+   )
+{
+# for k in range(ncoef)
+   a.c[{{k}}] *= s;
+# endfor
+   return a;
+}
+
+/** a + s b */
+static DUAL dualaxpy(
+   DUAL                  a,
+   double                s,
+   DUAL                  b
+   )
+{
+# for k in range(ncoef)
+   a.c[{{k}}] += s * b.c[{{k}}];
+# endfor
+   return a;
+}
+
+/** s a + t b */
+static DUAL duallin(
+   double                s,
+   DUAL                  a,
+   double                t,
+   DUAL                  b
+   )
+{
+# for k in range(ncoef)
+   a.c[{{k}}] = s * a.c[{{k}}] + t * b.c[{{k}}];
+# endfor
+   return a;
+}
+
+static DUAL dualmul(
+   DUAL                  a,
+   DUAL                  b
+   )
+{
+   DUAL r;
+# for k in range(ncoef)
+   r.c[{{k}}] = {% for p in multable[k] %}{{' + ' if not loop.first}}a.c[{{p[0]}}] * b.c[{{p[1]}}]{% endfor %};
+# endfor
+   return r;
+}
+
+/** f(a) for a scalar function with Taylor coefficients f[] at the value of a */
+static DUAL dualseries(
+   DUAL                  a,
+   const double          f[{{order+1}}]
+   )
+{
+   DUAL h = a;
+   DUAL r;
+   DUAL hk;
+   int k;
+
+   h.c[0] = 0.0;
+   hk = h;
+   r = dualscale(h, f[1]);
+   r.c[0] = f[0];
+   for( k = 2; k <= {{order}}; ++k )
+   {
+      hk = dualmul(hk, h);
+      r = dualaxpy(r, f[k], hk);
+   }
+   return r;
+}
+
+static DUAL dualexp(
+   DUAL                  a
+   )
+{
+   double e = exp(a.c[0]);
+   double f[4] = { e, e, e / 2.0, e / 6.0 };
+   return dualseries(a, f);
+}
+
+static DUAL duallog(
+   DUAL                  a
+   )
+{
+   double x = 1.0 / a.c[0];
+   double f[4] = { log(a.c[0]), x, -x * x / 2.0, x * x * x / 3.0 };
+   return dualseries(a, f);
+}
+
+/** a^p for a > 0 */
+static DUAL dualpow(
+   DUAL                  a,
+   double                p
+   )
+{
+   double x = pow(a.c[0], p - 3.0);
+   double f[4];
+
+   f[3] = p * (p - 1.0) * (p - 2.0) / 6.0 * x;
+   x *= a.c[0];
+   f[2] = p * (p - 1.0) / 2.0 * x;
+   x *= a.c[0];
+   f[1] = p * x;
+   f[0] = x * a.c[0];
+   return dualseries(a, f);
+}
+
+/** |a|, kept away from 0 where the non-analytic terms are singular */
+static DUAL dualabsnz(
+   DUAL                  a
+   )
+{
+   if( a.c[0] < 0.0 )
+      a = dualscale(a, -1.0);
+   if( a.c[0] < 1e-12 )
+      a.c[0] = 1e-12;
+   return a;
+}
+
+/** partial derivative with respect to T (var = 0) or D (var = 1); the result is exact up to order {{order-1}} */
+static DUAL dualdiff(
+   DUAL                  a,
+   int                   var
+   )
+{
+   DUAL r;
+
+   memset(&r, 0, sizeof(r));
+   if( var == 0 )
+   {
+# for m in monomials
+#  if m[0] > 0
+      r.c[{{monomials.index((m[0]-1, m[1]))}}] = {{m[0]}} * a.c[{{loop.index0}}];
+#  endif
+# endfor
+   }
+   else
+   {
+# for m in monomials
+#  if m[1] > 0
+      r.c[{{monomials.index((m[0], m[1]-1))}}] = {{m[1]}} * a.c[{{loop.index0}}];
+#  endif
+# endfor
+   }
+   return r;
+}
+
+# for f in fluids
+/*
+ * {{f['name']}} ({{f['reference']}})
+ */
+
+/** specific Helmholtz energy of {{f['name']}} in J/kg */
+static DUAL helmholtz_{{f['cname']}}(
+   DUAL                  T,
+   DUAL                  D
+   )
+{
+   DUAL tau, delta, lnt, lnd, a0, ar, x, u, v, w;
+
+   tau = dualscale(dualpow(T, -1.0), {{f['Tr']}});
+   delta = dualscale(D, 1.0 / ({{f['M']}} * {{f['rhor']}}));
+   lnt = duallog(tau);
+   lnd = duallog(delta);
+   memset(&ar, 0, sizeof(ar));
+   (void)x; (void)u; (void)v; (void)w;
+
+#  for line in f['alphar']
+   {{line}}
+#  endfor
+
+#  for line in f['alpha0']
+   {{line}}
+#  endfor
+
+   return dualscale(dualmul(T, dualaxpy(a0, 1.0, ar)), {{f['R']}} / {{f['M']}});
+}
+
+/** whether a state of {{f['name']}} may be two-phase */
+static int twophase_{{f['cname']}}(
+   double                t,
+   double                D
+   )
+{
+   double rho = D / {{f['M']}};
+   double tl = t < {{f['TL']}} ? t : {{f['TL']}};
+   double tv = t < {{f['TV']}} ? t : {{f['TV']}};
+
+   if( t >= {{f['Tsingle']}} )
+      return 0;
+   if( t < {{f['Tlow']}} )
+      return 1;
+   t = tv;
+   if( rho <= ({{f['rhoV']}}) * (1.0 - {{f['marginV']}}) )
+      return 0;
+   t = tl;
+   return rho < ({{f['rhoL']}}) * (1.0 + {{f['marginL']}});
+}
+
+# endfor
+/** generated fluids */
+static const struct
+{
+   const char* name;
+   DUAL (*helmholtz)(DUAL T, DUAL D);
+   int (*twophase)(double T, double D);
+} eosgens[] =
+{
+# for f in fluids
+   { "{{f['name']}}", helmholtz_{{f['cname']}}, twophase_{{f['cname']}} },
+# endfor
+   { NULL, NULL, NULL }
+};
+
+static int eosgenindex(
+   const char*           Fluid
+   )
+{
+   int i;
+
+   for( i = 0; eosgens[i].name != NULL; ++i )
+      if( strcmp(eosgens[i].name, Fluid) == 0 )
+         return i;
+   return -1;
+}
+
+int eosgenhas(
+   const char*           Fluid
+   )
+{
+   return eosgenindex(Fluid) >= 0;
+}
+
+int eosgenprops(
+   const char*           Prop,
+   double                T,
+   double                D,
+   const char*           Fluid,
+   double                d[6]
+   )
+{
+   DUAL t, rho, a, r;
+   int i = eosgenindex(Fluid);
+
+   if( i < 0 )
+      return 1;
+   if( strcmp(Prop, "T") == 0 || strcmp(Prop, "D") == 0 || strcmp(Prop, "Dmass") == 0 )
+   {
+      memset(d, 0, 6 * sizeof(double));
+      d[0] = Prop[0] == 'T' ? T : D;
+      d[Prop[0] == 'T' ? 1 : 2] = 1.0;
+      return 0;
+   }
+   if( strcmp(Prop, "P") != 0 && !((Prop[0] == 'H' || Prop[0] == 'S' || Prop[0] == 'U')
+         && (Prop[1] == '\0' || strcmp(Prop + 1, "mass") == 0)) )
+      return 1;
+   if( eosgens[i].twophase(T, D) )
+      return 2;
+
+   memset(&t, 0, sizeof(t));
+   memset(&rho, 0, sizeof(rho));
+   t.c[0] = T;
+   t.c[1] = 1.0;
+   rho.c[0] = D;
+   rho.c[2] = 1.0;
+   a = eosgens[i].helmholtz(t, rho);
+
+   switch( Prop[0] )
+   {
+      case 'P' :
+         /* p = D^2 da/dD */
+         r = dualmul(dualmul(rho, rho), dualdiff(a, 1));
+         break;
+      case 'S' :
+         /* s = -da/dT */
+         r = dualscale(dualdiff(a, 0), -1.0);
+         break;
+      case 'U' :
+         /* u = a - T da/dT */
+         r = dualaxpy(a, -1.0, dualmul(t, dualdiff(a, 0)));
+         break;
+      default :
+         /* h = a - T da/dT + D da/dD */
+         r = dualaxpy(dualaxpy(a, -1.0, dualmul(t, dualdiff(a, 0))), 1.0, dualmul(rho, dualdiff(a, 1)));
+         break;
+   }
+
+   d[0] = r.c[0];
+   d[1] = r.c[1];
+   d[2] = r.c[2];
+   d[3] = 2.0 * r.c[3];
+   d[4] = r.c[4];
+   d[5] = 2.0 * r.c[5];
+   return 0;
+}
+
+int eosgencheck(
+   const char*           Fluid,
+   char*                 errmsg
+   )
+{
+   static const char* props[] = { "P", "H", "S" };
+   double T = 1.5 * Props1SI(Fluid, "Tcrit");
+   double D = 0.5 * Props1SI(Fluid, "rhomass_critical");
+   double d[6];
+   int i;
+
+   errmsg[0] = '\0';
+   for( i = 0; i < 3; ++i )
+   {
+      double ref = PropsSI(props[i], "T", T, "D", D, Fluid);
+      if( eosgenprops(props[i], T, D, Fluid, d) != 0 || !(fabs(d[0] - ref) <= 1e-8 * fabs(ref)) )
+      {
+         snprintf(errmsg, 255, "Generated equation of state for %s deviates from CoolProp in %s: %.10g vs. %.10g.",
+            Fluid, props[i], d[0], ref);
+         return 1;
+      }
+   }
+   return 0;
+}
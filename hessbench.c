@@ -0,0 +1,319 @@
+/** Benchmark of the quasi-Newton Hessian modes against exact Hessians
+ *
+ * Solves, through the GAMS API of the library, problems whose Hessian is
+ * made of the second derivatives of PropsSI2, with Newton's method as an
+ * NLP solver would: each problem minimizes the availability
+ *
+ *   A(P, T) = u(P, T) + P0 / D(P, T) - T0 s(P, T)
+ *
+ * of a pure fluid of FLUID2 in propssicclib.c with respect to an
+ * environment at (P0, T0). Its minimum is the state (P0, T0). The
+ * environments are random supercritical states between 1.3 and 1.8 times
+ * the critical temperature and 0.2 and 2 times the critical pressure,
+ * the starting points random within a relative distance of them.
+ *
+ * Every problem is solved with exact Hessians and in the modes bfgs and
+ * sr1 of PROPSSI_HESSIAN, each on a new instance of the library. Reports
+ * per mode the problems solved, Newton iterations, PropsSI2 calls, wall
+ * time, and the largest relative distance of a solution from (P0, T0).
+ * The remaining configuration of the library is taken from the
+ * environment as usual; a shared state cache (PROPSSI_SHMCACHE) would
+ * carry states from one mode to the next.
+ *
+ * Usage:
+ *
+ *   hessbench [-n problems] [-r distance] [-e tolerance] [-m radius]
+ *
+ * The defaults are 50 problems per fluid, starting points within 0.2,
+ * convergence at steps below 1e-9 relative, and the default radius of
+ * the quasi-Newton modes.
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o hessbench hessbench.c propssicclib.c propssicache.c propssiengine.c
+ *       propssiserver.c propssieosgen.c propssimixture.c propssicheb.c libCoolProp.[so|dylib]
+ *       -lm -lpthread [-lrt on Linux]
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "extrfunc.h"
+#include "CoolPropLib.h"
+#include "propssimixture.h"
+
+#define BENCH_MAXFLUIDS 20
+#define BENCH_MAXITER   100
+
+EXTRFUNC_DECL_FUNCCALL(PropsSI2);
+EXTRFUNC_API void EXTRFUNC_CALLCONV xcreate(EXTRFUNC_DATA** data);
+EXTRFUNC_API void EXTRFUNC_CALLCONV xfree(EXTRFUNC_DATA** data);
+EXTRFUNC_API int EXTRFUNC_CALLCONV libinit(EXTRFUNC_DATA* data, int version, char* msg);
+
+extern char* FLUID2[];
+
+/** one minimization */
+typedef struct
+{
+   int    fluid;                             /**< index in FLUID2 */
+   double P0, T0;                            /**< environment */
+   double P, T;                              /**< starting point */
+} PROBLEM;
+
+static unsigned long ncalls = 0;
+
+static EXTRFUNC_RETURN EXTRFUNC_CALLCONV ignoreerror(
+   EXTRFUNC_RETURN       retcode,
+   EXTRFUNC_EVALERROR    exccode,
+   char*                 msg,
+   void*                 usrmem
+   )
+{
+   (void)exccode;
+   (void)msg;
+   (void)usrmem;
+   return retcode;
+}
+
+static double walltime(void)
+{
+   struct timespec t;
+
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static double uniform(
+   double                lo,
+   double                hi
+   )
+{
+   return lo + (hi - lo) * rand() / (double)RAND_MAX;
+}
+
+/** Evaluates the availability with its gradient and Hessian in the scaled variables P/P0 and T/T0
+ *
+ * @return 0 if successful, <> 0 if PropsSI2 failed.
+ */
+static int availability(
+   EXTRFUNC_DATA*        data,
+   const PROBLEM*        pb,
+   double                P,
+   double                T,
+   double*               A,
+   double                g[2],            /**< buffer for gradient, NULL if not needed */
+   double                H[3]             /**< buffer for Hessian as H11, H12, H22, NULL if not needed */
+   )
+{
+   static const double props[3] = { 3, 2, 5 };   /* U, D, S in PROPERTY */
+   double x[6], f[3], gradient[3][6], hessian[3][36];
+   double scale[2];
+   int derivrequest = H != NULL ? 2 : g != NULL ? 1 : 0;
+   int k, i, j;
+
+   x[1] = 0;                                      /* P */
+   x[2] = P;
+   x[3] = 1;                                      /* T */
+   x[4] = T;
+   x[5] = pb->fluid;
+   for( k = 0; k < 3; ++k )
+   {
+      x[0] = props[k];
+      ++ncalls;
+      if( PropsSI2(data, derivrequest, 6, x, &f[k], gradient[k], hessian[k], ignoreerror, NULL) != EXTRFUNC_RETURN_OK
+         || !isfinite(f[k]) || !(f[k] != 0.0 || k != 1) )
+         return 1;
+   }
+
+   *A = f[0] + pb->P0 / f[1] - pb->T0 * f[2];
+   if( derivrequest == 0 )
+      return 0;
+
+   /* derivatives of A in P and T, then scaled */
+   scale[0] = pb->P0;
+   scale[1] = pb->T0;
+   for( i = 0; i < 2; ++i )
+   {
+      double Di = gradient[1][2 + 2*i];
+
+      g[i] = (gradient[0][2 + 2*i] - pb->P0 * Di / (f[1] * f[1]) - pb->T0 * gradient[2][2 + 2*i]) * scale[i];
+      if( H == NULL )
+         continue;
+      for( j = i; j < 2; ++j )
+      {
+         int ij = 6 * (2 + 2*i) + 2 + 2*j;
+         double Dj = gradient[1][2 + 2*j];
+         double vij = (2.0 * Di * Dj / f[1] - hessian[1][ij]) / (f[1] * f[1]);
+
+         H[i + j] = (hessian[0][ij] + pb->P0 * vij - pb->T0 * hessian[2][ij]) * scale[i] * scale[j];
+      }
+   }
+   return 0;
+}
+
+/** Minimizes the availability by Newton's method with a backtracking line search
+ *
+ * Where the Hessian is not positive definite, a multiple of the identity
+ * is added to it. Converged when a full step is below the tolerance in
+ * the scaled variables.
+ *
+ * @return number of iterations, -1 if not converged or a state failed.
+ */
+static int solve(
+   EXTRFUNC_DATA*        data,
+   const PROBLEM*        pb,
+   double                tol,
+   double*               P,
+   double*               T
+   )
+{
+   double A, g[2], H[3];
+   int iter;
+
+   *P = pb->P;
+   *T = pb->T;
+   for( iter = 0; iter < BENCH_MAXITER; ++iter )
+   {
+      double shift = 0.0, det, dz[2], Anew, slope, alpha;
+
+      if( availability(data, pb, *P, *T, &A, g, H) )
+         return -1;
+      for( ;; )
+      {
+         det = (H[0] + shift) * (H[2] + shift) - H[1] * H[1];
+         if( H[0] + shift > 0.0 && det > 0.0 )
+            break;
+         shift = shift == 0.0 ? 1e-8 * (fabs(H[0]) + fabs(H[2]) + 1.0) : 10.0 * shift;
+      }
+      dz[0] = -((H[2] + shift) * g[0] - H[1] * g[1]) / det;
+      dz[1] = -((H[0] + shift) * g[1] - H[1] * g[0]) / det;
+      if( fmax(fabs(dz[0]), fabs(dz[1])) < tol )
+         return iter + 1;
+
+      slope = g[0] * dz[0] + g[1] * dz[1];
+      for( alpha = 1.0; alpha > 1e-10; alpha *= 0.5 )
+      {
+         double Pnew = *P + alpha * dz[0] * pb->P0;
+         double Tnew = *T + alpha * dz[1] * pb->T0;
+
+         if( availability(data, pb, Pnew, Tnew, &Anew, NULL, NULL) == 0 && Anew <= A + 1e-4 * alpha * slope + 1e-14 * fabs(A) )
+         {
+            *P = Pnew;
+            *T = Tnew;
+            break;
+         }
+      }
+      if( !(alpha > 1e-10) )
+         return -1;
+   }
+   return -1;
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   static const char* modes[3] = { "exact", "bfgs", "sr1" };
+   char msg[EXTRFUNC_STRSIZE];
+   char mode[64];
+   const char* radius = NULL;
+   double dist = 0.2, tol = 1e-9;
+   int nper = 50;
+   int nproblems = 0, nfluids;
+   PROBLEM* problems;
+   int opt;
+   int m, i;
+
+   while( (opt = getopt(argc, argv, "n:r:e:m:")) != -1 )
+   {
+      if( (opt == 'n' && (nper = atoi(optarg)) > 0)
+         || (opt == 'r' && (dist = atof(optarg)) > 0.0 && dist < 0.3)
+         || (opt == 'e' && (tol = atof(optarg)) > 0.0)
+         || (opt == 'm' && atof(optarg) > 0.0 && (radius = optarg) != NULL) )
+         continue;
+      fprintf(stderr, "usage: hessbench [-n problems] [-r distance < 0.3] [-e tolerance] [-m radius]\n");
+      return 1;
+   }
+   if( mixtureconfig(msg) != 0 )
+   {
+      fprintf(stderr, "hessbench: %s\n", msg);
+      return 1;
+   }
+
+   for( nfluids = 0; nfluids < BENCH_MAXFLUIDS && FLUID2[nfluids][0] != '\0'; ++nfluids )
+      ;
+   problems = malloc(nfluids * nper * sizeof(PROBLEM));
+   srand(1);
+   for( i = 0; i < nfluids; ++i )
+   {
+      double Tc, pc;
+      int k;
+
+      if( mixtureis(FLUID2[i]) )
+         continue;
+      Tc = Props1SI(FLUID2[i], "Tcrit");
+      pc = Props1SI(FLUID2[i], "pcrit");
+      if( !(Tc > 0.0) || !(pc > 0.0) || !isfinite(Tc) || !isfinite(pc) )
+         continue;
+      for( k = 0; k < nper; ++k )
+      {
+         PROBLEM* pb = &problems[nproblems++];
+
+         pb->fluid = i;
+         pb->T0 = Tc * uniform(1.3, 1.8);
+         pb->P0 = pc * exp(uniform(log(0.2), log(2.0)));
+         pb->T = pb->T0 * (1.0 + uniform(-dist, dist));
+         pb->P = pb->P0 * (1.0 + uniform(-dist, dist));
+      }
+   }
+
+   printf("%-6s %8s %10s %10s %10s %12s %12s\n", "mode", "solved", "iters", "calls", "time [s]", "ms/problem", "max dev");
+   for( m = 0; m < 3; ++m )
+   {
+      EXTRFUNC_DATA* data;
+      unsigned long iters = 0;
+      double devmax = 0.0, t;
+      int solved = 0;
+
+      if( radius != NULL && m > 0 )
+         snprintf(mode, sizeof(mode), "%s:%s", modes[m], radius);
+      else
+         snprintf(mode, sizeof(mode), "%s", modes[m]);
+      setenv("PROPSSI_HESSIAN", mode, 1);
+      xcreate(&data);
+      if( libinit(data, 1, msg) != 0 )
+      {
+         fprintf(stderr, "hessbench: libinit: %.*s\n", (int)(unsigned char)msg[0], msg+1);
+         return 1;
+      }
+      ncalls = 0;
+      t = walltime();
+      for( i = 0; i < nproblems; ++i )
+      {
+         double P, T;
+         int n = solve(data, &problems[i], tol, &P, &T);
+
+         if( n < 0 )
+            continue;
+         ++solved;
+         iters += n;
+         devmax = fmax(devmax, fmax(fabs(P / problems[i].P0 - 1.0), fabs(T / problems[i].T0 - 1.0)));
+      }
+      t = walltime() - t;
+      xfree(&data);
+      printf("%-6s %4d/%-4d %10lu %10lu %10.3f %12.3f %12.3g\n", modes[m], solved, nproblems, iters, ncalls, t,
+         nproblems > 0 ? 1000.0 * t / nproblems : 0.0, devmax);
+   }
+   free(problems);
+
+   return 0;
+}
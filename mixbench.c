@@ -0,0 +1,172 @@
+/** Benchmark of the cubic mixture backends against HEOS
+ *
+ * Evaluates density, isobaric heat capacity, and enthalpy with first
+ * derivatives at random pressure-temperature states of each mixture, as
+ * the library does (see mixtureeval()), once on HEOS and once on each of
+ * the PR and SRK backends with the parameters of PROPSSI_CUBIC (see
+ * propssimixture.h). Reports the time per evaluation and the largest
+ * relative deviation from HEOS. Enthalpies are compared as differences
+ * to the first state, since the backends use different reference states;
+ * their deviation is relative to the largest difference on HEOS.
+ *
+ * Usage:
+ *
+ *   mixbench [-n npoints] [-T Tmin,Tmax] [-p pmin,pmax] [mixture ...]
+ *
+ * The default mixture is the natural gas of FLUID2 in propssicclib.c,
+ * between 250 and 450 K and 1 and 50 bar.
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o mixbench mixbench.c propssimixture.c propssiengine.c propssicache.c
+ *       libCoolProp.[so|dylib] -lm -lpthread [-lrt on Linux]
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "CoolPropLib.h"
+#include "propssiengine.h"
+#include "propssimixture.h"
+
+#define NPROPS 3
+
+static const char* props[NPROPS] = { "D", "Cpmass", "H" };
+static const char* backends[] = { "HEOS", "PR", "SRK" };
+
+/** Evaluates all states of a mixture on a backend
+ *
+ * @return time per evaluation in microseconds, or -1 if the handle could not be created.
+ */
+static double evalall(
+   const char*           Fluid,
+   const char*           backend,
+   int                   npoints,
+   const double*         p,
+   const double*         T,
+   double*               values           /**< buffer for NPROPS values per state, NaN if failed */
+   )
+{
+   struct timespec start, stop;
+   char msg[ENGINE_MSGSIZE];
+   MIXTURE* mix;
+   double d[6];
+   int i, k;
+
+   mix = mixturecreate(Fluid, backend, msg);
+   if( mix == NULL )
+   {
+      fprintf(stderr, "mixbench: %s on %s: %s\n", Fluid, backend, msg);
+      return -1.0;
+   }
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for( i = 0; i < npoints; ++i )
+      for( k = 0; k < NPROPS; ++k )
+         values[NPROPS*i + k] = mixtureeval(mix, props[k], "P", p[i], "T", T[i], Fluid, 1, d, msg) == 0 ? d[0] : NAN;
+   clock_gettime(CLOCK_MONOTONIC, &stop);
+   mixturefree(mix);
+
+   return 1e6 * ((stop.tv_sec - start.tv_sec) + 1e-9 * (stop.tv_nsec - start.tv_nsec)) / (npoints * NPROPS);
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   static const char* defmixture = "Methane[0.9]&Ethane[0.07]&Propane[0.03]";
+   char msg[ENGINE_MSGSIZE];
+   double Tmin = 250.0, Tmax = 450.0;
+   double pmin = 1e5, pmax = 5e6;
+   int npoints = 1000;
+   double *p, *T, *ref, *val;
+   int opt;
+   int m, b, i, k;
+
+   while( (opt = getopt(argc, argv, "n:T:p:")) != -1 )
+   {
+      if( (opt == 'n' && (npoints = atoi(optarg)) > 0)
+         || (opt == 'T' && sscanf(optarg, "%lf,%lf", &Tmin, &Tmax) == 2)
+         || (opt == 'p' && sscanf(optarg, "%lf,%lf", &pmin, &pmax) == 2) )
+         continue;
+      fprintf(stderr, "usage: mixbench [-n npoints] [-T Tmin,Tmax] [-p pmin,pmax] [mixture ...]\n");
+      return 1;
+   }
+   if( mixtureconfig(msg) != 0 )
+   {
+      fprintf(stderr, "mixbench: %s\n", msg);
+      return 1;
+   }
+
+   p = malloc(npoints * sizeof(double));
+   T = malloc(npoints * sizeof(double));
+   ref = malloc(NPROPS * npoints * sizeof(double));
+   val = malloc(NPROPS * npoints * sizeof(double));
+   srand(1);
+   for( i = 0; i < npoints; ++i )
+   {
+      /* log-uniform in pressure */
+      p[i] = pmin * pow(pmax / pmin, rand() / (double)RAND_MAX);
+      T[i] = Tmin + (Tmax - Tmin) * rand() / (double)RAND_MAX;
+   }
+
+   printf("%-45s %-5s %10s %10s %10s %10s %8s\n", "mixture", "eos", "us/eval", "max dD", "max dcp", "max ddH", "failed");
+   for( m = optind < argc ? optind : -1; m < argc; ++m )
+   {
+      const char* Fluid = m < 0 ? defmixture : argv[m];
+      double t0;
+
+      t0 = evalall(Fluid, "HEOS", npoints, p, T, ref);
+      if( t0 < 0.0 )
+         continue;
+      for( b = 0; b < 3; ++b )
+      {
+         double dev[NPROPS] = { 0.0, 0.0, 0.0 };
+         double dhmax = 0.0;
+         double t = b == 0 ? t0 : evalall(Fluid, backends[b], npoints, p, T, val);
+         int failed = 0;
+
+         if( t < 0.0 )
+            continue;
+         if( b == 0 )
+            memcpy(val, ref, NPROPS * npoints * sizeof(double));
+         for( i = 0; i < npoints; ++i )
+            if( isfinite(ref[NPROPS*i + 2]) && isfinite(ref[2]) )
+               dhmax = fmax(dhmax, fabs(ref[NPROPS*i + 2] - ref[2]));
+         for( i = 0; i < npoints; ++i )
+         {
+            const double* r = &ref[NPROPS*i];
+            const double* v = &val[NPROPS*i];
+
+            if( !isfinite(v[0]) || !isfinite(v[1]) || !isfinite(v[2]) )
+            {
+               ++failed;
+               continue;
+            }
+            if( !isfinite(r[0]) || !isfinite(r[1]) || !isfinite(r[2]) || !isfinite(ref[2]) || !isfinite(val[2]) )
+               continue;
+            for( k = 0; k < 2; ++k )
+               dev[k] = fmax(dev[k], fabs(v[k] - r[k]) / fabs(r[k]));
+            if( dhmax > 0.0 )
+               dev[2] = fmax(dev[2], fabs((v[2] - val[2]) - (r[2] - ref[2])) / dhmax);
+         }
+         printf("%-45.45s %-5s %10.2f %10.2e %10.2e %10.2e %8d\n", b == 0 ? Fluid : "", backends[b], t, dev[0], dev[1], dev[2], failed);
+      }
+      if( m < 0 )
+         break;
+   }
+
+   free(p);
+   free(T);
+   free(ref);
+   free(val);
+   return 0;
+}
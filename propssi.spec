@@ -56,3 +56,72 @@ Description = CoolProp PropsSI implementation for GAMS
 Arguments = Prop Prop1 Value1 Prop2 Value2 Fluid
 MaxDerivative = 2
 
+
+[CompressorOut]
+Description = Outlet property of a compressor with isentropic efficiency
+Arguments = Prop Pin Tin Pout Eta Fluid
+Endogenous = Pin Tin Pout Eta
+MaxDerivative = 2
+
+[TurbineOut]
+Description = Outlet property of a turbine with isentropic efficiency
+Arguments = Prop Pin Tin Pout Eta Fluid
+Endogenous = Pin Tin Pout Eta
+MaxDerivative = 2
+
+[HXPinch]
+Description = Minimum temperature difference of a counter-flow heat exchanger
+Arguments = ThIn PhIn Mh TcIn PcIn Mc Q HotFluid ColdFluid | N
+Endogenous = ThIn PhIn Mh TcIn PcIn Mc Q
+Derivative = discontinuous
+MaxDerivative = 2
+
+[Tsat]
+Description = Saturation temperature for given pressure
+Arguments = P Fluid
+Endogenous = P
+MaxDerivative = 2
+
+[Psat]
+Description = Saturation pressure for given temperature
+Arguments = T Fluid
+Endogenous = T
+MaxDerivative = 2
+
+[SatProp]
+Description = Property of saturated liquid (Q=0) or vapour (Q=1)
+Arguments = Prop Q Input Value Fluid
+Endogenous = Value
+MaxDerivative = 2
+
+[Exergy]
+Description = Specific flow exergy h - h0 - T0 (s - s0) for given state and dead state
+Arguments = Prop1 Value1 Prop2 Value2 T0 P0 Fluid
+MaxDerivative = 2
+
+[IsentropicExp]
+Description = Isentropic exponent rho c^2 / p
+Arguments = Prop1 Value1 Prop2 Value2 Fluid
+MaxDerivative = 2
+
+[HeatCapRatio]
+Description = Ratio of isobaric and isochoric heat capacities cp/cv
+Arguments = Prop1 Value1 Prop2 Value2 Fluid
+MaxDerivative = 2
+
+[JouleThomson]
+Description = Joule-Thomson coefficient (dT/dp) at constant enthalpy
+Arguments = Prop1 Value1 Prop2 Value2 Fluid
+MaxDerivative = 2
+
+[PropsSIFidelity]
+Description = Full equation of state for all states (Mode 1, e.g. before a final solve) or multi-fidelity anew (Mode 0)
+Arguments = Mode
+NotInEquation = 1
+MaxDerivative = 0
+
+[PropsSIBound]
+Description = Sampled lower (Side 0) or upper (Side 1) bound of a property over a box of the two inputs
+Arguments = Prop Prop1 Lo1 Hi1 Prop2 Lo2 Hi2 Fluid Side
+NotInEquation = 1
+MaxDerivative = 0
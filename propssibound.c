@@ -0,0 +1,135 @@
+/** Batch evaluation of property bounds over boxes of state inputs
+ *
+ * Computes lower and upper bounds of properties over boxes of the two
+ * state inputs, e.g., to derive .lo and .up bounds of enthalpy and
+ * entropy variables in a preprocessing step. Each row gives
+ *
+ *   output,name1,lo1,hi1,name2,lo2,hi2,fluid
+ *
+ * where output and the input names are PropsSI names (e.g. H, P, T), and
+ * is written with the bounds appended:
+ *
+ *   output,name1,lo1,hi1,name2,lo2,hi2,fluid,lower,upper
+ *
+ * The bounds are computed as by the PropsSIBound function of the
+ * library (see evalbounds()); they are sampled, not guaranteed. Boxes
+ * without any state CoolProp can evaluate give NA. Lines starting with #
+ * and a header line are copied.
+ *
+ * Usage:
+ *
+ *   propssibound [-j threads] [-o outfile] [infile]
+ *
+ * Input and output default to standard input and output; the number of
+ * threads to sample each box on defaults to the number of online
+ * processors.
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o propssibound propssibound.c propssiengine.c propssicache.c
+ *       libCoolProp.[so|dylib] -lm -lpthread [-lrt on Linux]
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "propssiengine.h"
+
+#define BOUND_LINESIZE 512
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   char line[BOUND_LINESIZE];
+   char msg[ENGINE_MSGSIZE];
+   FILE* in = stdin;
+   FILE* out = stdout;
+   int nthreads;
+   long lineno = 0;
+   long rows = 0;
+   long failed = 0;
+   int opt;
+
+   nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   while( (opt = getopt(argc, argv, "j:o:")) != -1 )
+   {
+      switch( opt )
+      {
+         case 'j' :
+            nthreads = atoi(optarg);
+            break;
+         case 'o' :
+            out = fopen(optarg, "w");
+            if( out == NULL )
+            {
+               perror(optarg);
+               return 1;
+            }
+            break;
+         default :
+            fprintf(stderr, "usage: propssibound [-j threads] [-o outfile] [infile]\n");
+            return 1;
+      }
+   }
+   if( optind < argc )
+   {
+      in = fopen(argv[optind], "r");
+      if( in == NULL )
+      {
+         perror(argv[optind]);
+         return 1;
+      }
+   }
+
+   while( fgets(line, sizeof(line), in) != NULL )
+   {
+      char prop[64], name1[16], name2[16], fluid[256];
+      double lo1, hi1, lo2, hi2;
+      double bounds[2];
+      int nfailed;
+
+      ++lineno;
+      line[strcspn(line, "\r\n")] = '\0';
+      if( line[0] == '#' || line[0] == '\0' )
+      {
+         fprintf(out, "%s\n", line);
+         continue;
+      }
+      if( sscanf(line, "%63[^,],%15[^,],%lf,%lf,%15[^,],%lf,%lf,%255[^,]", prop, name1, &lo1, &hi1, name2, &lo2, &hi2, fluid) != 8 )
+      {
+         if( lineno == 1 )
+         {
+            fprintf(out, "%s,lower,upper\n", line);
+            continue;
+         }
+         fprintf(stderr, "propssibound: line %ld: expected output,name1,lo1,hi1,name2,lo2,hi2,fluid\n", lineno);
+         return 1;
+      }
+
+      ++rows;
+      if( evalbounds(prop, name1, lo1, hi1, name2, lo2, hi2, fluid, nthreads, bounds, &nfailed, msg) != 0 )
+      {
+         fprintf(stderr, "propssibound: line %ld: %s\n", lineno, msg);
+         fprintf(out, "%s,NA,NA\n", line);
+         ++failed;
+         continue;
+      }
+      fprintf(out, "%s,%.17g,%.17g\n", line, bounds[0], bounds[1]);
+   }
+
+   fprintf(stderr, "propssibound: %ld boxes (%ld failed)\n", rows, failed);
+
+   if( in != stdin )
+      fclose(in);
+   if( out != stdout )
+      fclose(out);
+   return 0;
+}
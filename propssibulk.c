@@ -0,0 +1,406 @@
+/** Bulk property evaluator for the extrinsic CoolProp library
+ *
+ * Evaluates tables of states outside of GAMS, e.g., to precompute
+ * property parameters over set products before a solve. Each row gives
+ *
+ *   output,pair,value1,value2,fluid
+ *
+ * where output is a CoolProp parameter name (e.g. Hmass), pair is a
+ * CoolProp input pair name (e.g. PT_INPUTS), and the values are in the
+ * order of the pair. The rows are evaluated in parallel by the engine of
+ * the function library (see evalprops()), as PropsSI2 evaluates them, so
+ * that backend prefixes and mixtures work as there and the state cache of
+ * PROPSSI_SHMCACHE is used and filled. They are written in the same
+ * format with the result appended:
+ *
+ *   output,pair,value1,value2,fluid,result
+ *
+ * Failed states give NA, which GAMS reads as not available. Lines starting
+ * with # and a header line are copied. In binary mode (-b), input and output
+ * are flat arrays of BULKROW records, with the result stored in the
+ * record's value field (NaN if failed). Rows are processed in chunks, so
+ * the input may be streamed through a pipe. Throughput is reported on
+ * standard error.
+ *
+ * Usage:
+ *
+ *   propssibulk [-b] [-j threads] [-o outfile] [infile]
+ *
+ * Input and output default to standard input and output; the number of
+ * threads defaults to the number of online processors.
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o propssibulk propssibulk.c propssiengine.c propssicache.c
+ *       libCoolProp.[so|dylib] -lm -lpthread [-lrt on Linux]
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "propssiengine.h"
+
+#define BULK_CHUNK       65536
+#define BULK_MAXTHREADS  256
+#define BULK_MAXFLUIDS   64
+#define BULK_LINESIZE    512
+
+/** record of the binary format */
+typedef struct
+{
+   char   output[16];       /**< CoolProp parameter name */
+   char   pair[24];         /**< CoolProp input pair name */
+   char   fluid[64];        /**< fluid name */
+   double value1;           /**< first input value */
+   double value2;           /**< second input value */
+   double value;            /**< result, ignored on input */
+} BULKROW;
+
+/** chunk of rows being evaluated */
+typedef struct
+{
+   int      n;
+   BULKROW  rows[BULK_CHUNK];
+   char     name1[BULK_CHUNK][16];    /**< first input name of the pair, empty if the pair is unknown */
+   char     name2[BULK_CHUNK][16];    /**< second input name of the pair */
+   char*    text[BULK_CHUNK];         /**< line to copy instead of a row (CSV only), or NULL */
+} CHUNK;
+
+static PROPSSICACHE* cache = NULL;
+static char* fluids[BULK_MAXFLUIDS];
+static int nfluids = 0;
+static int nthreads = 1;
+
+/** Splits an input pair name, e.g. HmassP_INPUTS, into its input names
+ *
+ * @return 0 if successful, 1 if the pair is unknown.
+ */
+static int pairnames(
+   const char*           pair,
+   char*                 name1,
+   char*                 name2
+   )
+{
+   static const char* names[] = { "P", "T", "Q", "Dmass", "Dmolar", "Hmass", "Hmolar", "Smass", "Smolar", "Umass", "Umolar" };
+   const int nnames = (int)(sizeof(names) / sizeof(names[0]));
+   size_t len = strlen(pair);
+   int i, j;
+
+   if( len < 7 || strcmp(pair + len - 7, "_INPUTS") != 0 )
+      return 1;
+   len -= 7;
+   for( i = 0; i < nnames; ++i )
+      for( j = 0; j < nnames; ++j )
+         if( strlen(names[i]) + strlen(names[j]) == len && strncmp(pair, names[i], strlen(names[i])) == 0
+            && strncmp(pair + strlen(names[i]), names[j], strlen(names[j])) == 0 )
+         {
+            strcpy(name1, names[i]);
+            strcpy(name2, names[j]);
+            return 0;
+         }
+   return 1;
+}
+
+/** Evaluates the first row of each fluid on the main thread
+ *
+ * CoolProp loads the data of a fluid on first use, which must not happen
+ * on several threads at once.
+ */
+static void warmup(
+   CHUNK*                c,
+   int                   i
+   )
+{
+   BULKROW* r = &c->rows[i];
+   char errmsg[ENGINE_MSGSIZE];
+   double d[6];
+   int k;
+
+   for( k = 0; k < nfluids; ++k )
+      if( strcmp(fluids[k], r->fluid) == 0 )
+         return;
+   if( nfluids == BULK_MAXFLUIDS )
+      return;
+   fluids[nfluids++] = strdup(r->fluid);
+   if( evalprops(cache, r->output, c->name1[i], r->value1, c->name2[i], r->value2, r->fluid, 0, d, errmsg) != 0 )
+      fprintf(stderr, "propssibulk: %s: %s\n", r->fluid, errmsg);
+}
+
+/** Resolves the names of a row */
+static void resolve(
+   CHUNK*                c,
+   int                   i
+   )
+{
+   BULKROW* r = &c->rows[i];
+
+   r->output[sizeof(r->output)-1] = '\0';
+   r->pair[sizeof(r->pair)-1] = '\0';
+   r->fluid[sizeof(r->fluid)-1] = '\0';
+   c->text[i] = NULL;
+   if( pairnames(r->pair, c->name1[i], c->name2[i]) != 0 )
+   {
+      c->name1[i][0] = '\0';
+      return;
+   }
+   warmup(c, i);
+}
+
+/** Copies the next comma-separated field of a line */
+static int csvfield(
+   char**                p,
+   char*                 field,
+   size_t                size
+   )
+{
+   size_t n = strcspn(*p, ",\r\n");
+
+   if( n >= size )
+      return 1;
+   memcpy(field, *p, n);
+   field[n] = '\0';
+   *p += n;
+   if( **p == ',' )
+      ++*p;
+   return 0;
+}
+
+/** Reads the next chunk of CSV rows
+ *
+ * @return number of lines read
+ */
+static int readcsv(
+   FILE*                 in,
+   CHUNK*                c,
+   long*                 lineno
+   )
+{
+   char line[BULK_LINESIZE];
+
+   c->n = 0;
+   while( c->n < BULK_CHUNK && fgets(line, sizeof(line), in) != NULL )
+   {
+      BULKROW* r = &c->rows[c->n];
+      char v1[64], v2[64];
+      char* end1;
+      char* end2;
+      char* p = line;
+
+      ++*lineno;
+      if( line[0] == '#' || line[0] == '\n' || line[0] == '\r' )
+      {
+         c->text[c->n++] = strdup(line);
+         continue;
+      }
+      if( csvfield(&p, r->output, sizeof(r->output)) || csvfield(&p, r->pair, sizeof(r->pair))
+         || csvfield(&p, v1, sizeof(v1)) || csvfield(&p, v2, sizeof(v2)) || csvfield(&p, r->fluid, sizeof(r->fluid)) )
+      {
+         fprintf(stderr, "propssibulk: line %ld: field too long\n", *lineno);
+         exit(1);
+      }
+      r->value1 = strtod(v1, &end1);
+      r->value2 = strtod(v2, &end2);
+      if( end1 == v1 || end2 == v2 )
+      {
+         /* header */
+         line[strcspn(line, "\r\n")] = '\0';
+         strcat(line, ",result\n");
+         c->text[c->n++] = strdup(line);
+         continue;
+      }
+      resolve(c, c->n++);
+   }
+   return c->n;
+}
+
+static void writecsv(
+   FILE*                 out,
+   CHUNK*                c
+   )
+{
+   int i;
+
+   for( i = 0; i < c->n; ++i )
+   {
+      BULKROW* r = &c->rows[i];
+
+      if( c->text[i] != NULL )
+      {
+         fputs(c->text[i], out);
+         free(c->text[i]);
+         continue;
+      }
+      fprintf(out, "%s,%s,%.17g,%.17g,%s,", r->output, r->pair, r->value1, r->value2, r->fluid);
+      if( isfinite(r->value) )
+         fprintf(out, "%.17g\n", r->value);
+      else
+         fprintf(out, "NA\n");
+   }
+}
+
+static int readbin(
+   FILE*                 in,
+   CHUNK*                c
+   )
+{
+   int i;
+
+   c->n = (int)fread(c->rows, sizeof(BULKROW), BULK_CHUNK, in);
+   for( i = 0; i < c->n; ++i )
+      resolve(c, i);
+   return c->n;
+}
+
+/** work of one thread */
+typedef struct
+{
+   CHUNK*   chunk;
+   int      first;
+   int      last;
+   long     failed;
+} WORK;
+
+static void* evalrows(
+   void*                 arg
+   )
+{
+   WORK* w = (WORK*)arg;
+   CHUNK* c = w->chunk;
+   char errmsg[ENGINE_MSGSIZE];
+   double d[6];
+   int i;
+
+   for( i = w->first; i < w->last; ++i )
+   {
+      BULKROW* r = &c->rows[i];
+
+      if( c->text[i] != NULL )
+         continue;
+      r->value = NAN;
+      if( c->name1[i][0] == '\0'
+         || evalprops(cache, r->output, c->name1[i], r->value1, c->name2[i], r->value2, r->fluid, 0, d, errmsg) != 0
+         || !isfinite(d[0]) )
+      {
+         ++w->failed;
+         continue;
+      }
+      r->value = d[0];
+   }
+   return NULL;
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   static CHUNK chunk;
+   WORK work[BULK_MAXTHREADS];
+   pthread_t threads[BULK_MAXTHREADS];
+   int started[BULK_MAXTHREADS];
+   struct timespec start, stop;
+   char msg[ENGINE_MSGSIZE];
+   FILE* in = stdin;
+   FILE* out = stdout;
+   int binary = 0;
+   long rows = 0;
+   long failed = 0;
+   long lineno = 0;
+   double secs;
+   int opt;
+   int t;
+
+   nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   while( (opt = getopt(argc, argv, "bj:o:")) != -1 )
+   {
+      switch( opt )
+      {
+         case 'b' :
+            binary = 1;
+            break;
+         case 'j' :
+            nthreads = atoi(optarg);
+            break;
+         case 'o' :
+            out = fopen(optarg, binary ? "wb" : "w");
+            if( out == NULL )
+            {
+               perror(optarg);
+               return 1;
+            }
+            break;
+         default :
+            fprintf(stderr, "usage: propssibulk [-b] [-j threads] [-o outfile] [infile]\n");
+            return 1;
+      }
+   }
+   if( nthreads < 1 )
+      nthreads = 1;
+   if( nthreads > BULK_MAXTHREADS )
+      nthreads = BULK_MAXTHREADS;
+   if( optind < argc )
+   {
+      in = fopen(argv[optind], binary ? "rb" : "r");
+      if( in == NULL )
+      {
+         perror(argv[optind]);
+         return 1;
+      }
+   }
+
+   cache = cachecreate(msg);
+   if( cache == NULL && msg[0] != '\0' )
+      fprintf(stderr, "propssibulk: %s Continuing without the state cache.\n", msg);
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   while( (binary ? readbin(in, &chunk) : readcsv(in, &chunk, &lineno)) > 0 )
+   {
+      /* contiguous blocks keep rows of the same fluid and pair on one thread */
+      for( t = 0; t < nthreads; ++t )
+      {
+         work[t].chunk = &chunk;
+         work[t].first = (int)((long)chunk.n * t / nthreads);
+         work[t].last = (int)((long)chunk.n * (t+1) / nthreads);
+         work[t].failed = 0;
+         started[t] = t > 0 && pthread_create(&threads[t], NULL, evalrows, &work[t]) == 0;
+      }
+      evalrows(&work[0]);
+      for( t = 1; t < nthreads; ++t )
+         if( started[t] )
+            pthread_join(threads[t], NULL);
+         else
+            evalrows(&work[t]);
+      for( t = 0; t < nthreads; ++t )
+         failed += work[t].failed;
+
+      for( t = 0; t < chunk.n; ++t )
+         rows += chunk.text[t] == NULL;
+      if( binary )
+         fwrite(chunk.rows, sizeof(BULKROW), chunk.n, out);
+      else
+         writecsv(out, &chunk);
+   }
+   clock_gettime(CLOCK_MONOTONIC, &stop);
+   secs = (stop.tv_sec - start.tv_sec) + 1e-9 * (stop.tv_nsec - start.tv_nsec);
+
+   fprintf(stderr, "propssibulk: %ld rows (%ld failed) in %.3f s with %d threads, %.0f rows/s\n",
+      rows, failed, secs, nthreads, secs > 0.0 ? rows / secs : 0.0);
+
+   if( in != stdin )
+      fclose(in);
+   if( out != stdout )
+      fclose(out);
+   cachefree(cache);
+   for( t = 0; t < nfluids; ++t )
+      free(fluids[t]);
+   return 0;
+}
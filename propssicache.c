@@ -0,0 +1,663 @@
+/** State cache for the extrinsic CoolProp library
+ *
+ * See propssicache.h for the configuration of the cache.
+ *
+ * Every slot carries a sequence counter: 0 means empty, an odd value means
+ * that a writer owns the slot, and an even value means that the slot holds
+ * a complete entry. Writers claim a slot by a compare-and-swap to an odd
+ * value and release it by storing the next even value. Readers copy a slot
+ * and accept the copy only if the counter was even and did not change
+ * meanwhile. Thus, processes sharing the table never wait on each other;
+ * a reader that races with a writer simply sees a miss.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "CoolPropLib.h"
+#include "propssicache.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__)
+# define CACHE_LOAD(p)          __atomic_load_n(p, __ATOMIC_RELAXED)
+# define CACHE_LOADACQ(p)       __atomic_load_n(p, __ATOMIC_ACQUIRE)
+# define CACHE_STORE(p, v)      __atomic_store_n(p, v, __ATOMIC_RELAXED)
+# define CACHE_STOREREL(p, v)   __atomic_store_n(p, v, __ATOMIC_RELEASE)
+# define CACHE_CAS(p, o, n)     __atomic_compare_exchange_n(p, &(o), n, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)
+# define CACHE_FENCEACQ()       __atomic_thread_fence(__ATOMIC_ACQUIRE)
+# define CACHE_FENCEREL()       __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+/* without GNU atomics, the cache is private to the (single-threaded) GAMS process */
+# define CACHE_LOAD(p)          (*(p))
+# define CACHE_LOADACQ(p)       (*(p))
+# define CACHE_STORE(p, v)      (*(p) = (v))
+# define CACHE_STOREREL(p, v)   (*(p) = (v))
+# define CACHE_CAS(p, o, n)     (*(p) == (o) ? (*(p) = (n), 1) : ((o) = *(p), 0))
+# define CACHE_FENCEACQ()
+# define CACHE_FENCEREL()
+#endif
+
+#define CACHE_MAGIC     0x50524f5053534931ULL   /* "PROPSSI1" */
+#define CACHE_LAYOUT    2                       /* version of header and slot layout */
+#define CACHE_DEFSIZE   65536
+#define CACHE_MAXPROBE  8
+#define CACHE_MAXTOLS   8
+
+/** words of a slot besides the sequence counter */
+enum
+{
+   W_KEY = 0,     /**< key from cachekey() */
+   W_VAL1,        /**< bits of first input value */
+   W_VAL2,        /**< bits of second input value */
+   W_LEVEL,       /**< highest derivative stored */
+   W_D,           /**< first of six words for value and derivatives */
+   W_NWORDS = W_D + 6
+};
+
+/** slot of the hash table */
+typedef struct
+{
+   uint64_t seq;             /**< sequence counter */
+   uint64_t w[W_NWORDS];     /**< entry */
+} CACHESLOT;
+
+/** header of the hash table, followed by the slots */
+typedef struct
+{
+   uint64_t magic;           /**< CACHE_MAGIC once the table is initialized */
+   uint64_t layout;          /**< CACHE_LAYOUT */
+   uint64_t config;          /**< hash of the configuration the entries depend on, see confighash() */
+   uint64_t nslots;          /**< number of slots, a power of two */
+} CACHEHEADER;
+
+struct PROPSSICACHE
+{
+   CACHEHEADER* header;      /**< table header */
+   uint64_t     config;      /**< hash of the configuration of this process */
+   CACHESLOT*   slots;       /**< table slots */
+   uint64_t     mask;        /**< nslots - 1 */
+   size_t       size;        /**< size of mapping in bytes */
+   int          shared;      /**< whether the table is in shared memory */
+   double       tolall;      /**< relative tolerance of inputs not listed in tolnames, 0 if exact */
+   int          ntols;       /**< number of inputs with their own tolerance */
+   char         tolnames[CACHE_MAXTOLS][16]; /**< input names with their own tolerance */
+   double       tols[CACHE_MAXTOLS];         /**< relative tolerances of those inputs */
+};
+
+static uint64_t dbits(
+   double                v
+   )
+{
+   uint64_t b;
+
+   memcpy(&b, &v, sizeof(b));
+   return b;
+}
+
+static double bitsd(
+   uint64_t              b
+   )
+{
+   double v;
+
+   memcpy(&v, &b, sizeof(v));
+   return v;
+}
+
+/** finalizer of splitmix64 */
+static uint64_t mix(
+   uint64_t              h
+   )
+{
+   h ^= h >> 30;
+   h *= 0xbf58476d1ce4e5b9ULL;
+   h ^= h >> 27;
+   h *= 0x94d049bb133111ebULL;
+   h ^= h >> 31;
+   return h;
+}
+
+/** FNV-1a hash of a string, continuing from h */
+static uint64_t fnv(
+   uint64_t              h,
+   const char*           s
+   )
+{
+   const unsigned char* c;
+
+   for( c = (const unsigned char*)s; *c != '\0'; ++c )
+      h = (h ^ *c) * 0x100000001b3ULL;
+   return h;
+}
+
+/** Hashes the configuration that the entries depend on
+ *
+ * These are the CoolProp build, whose version also fixes the reference
+ * states of the fluids, and the tolerances of PROPSSI_CACHETOL, in any
+ * order of the inputs. Called by cachecreate(), thus by libinit; the
+ * version and git revision are constant strings of CoolProp, so asking
+ * for them does not load its fluid database.
+ */
+static uint64_t confighash(
+   const PROPSSICACHE*   cache
+   )
+{
+   char buf[256];
+   uint64_t h = 0xcbf29ce484222325ULL;
+   uint64_t tols = 0;
+   int i;
+
+   buf[0] = '\0';
+   get_global_param_string("version", buf, sizeof(buf));
+   h = fnv(h, buf);
+   h = fnv(h, "|");
+   buf[0] = '\0';
+   get_global_param_string("gitrevision", buf, sizeof(buf));
+   h = fnv(h, buf);
+   for( i = 0; i < cache->ntols; ++i )
+      tols += mix(fnv(0xcbf29ce484222325ULL, cache->tolnames[i]) ^ mix(dbits(cache->tols[i])));
+   return mix(h ^ mix(dbits(cache->tolall) ^ mix(tols)));
+}
+
+static uint64_t slotindex(
+   uint64_t              key,
+   uint64_t              v1,
+   uint64_t              v2
+   )
+{
+   return mix(key ^ mix(v1 ^ mix(v2)));
+}
+
+#if !defined(_WIN32)
+/** waits a millisecond for another process setting up the shared table */
+static void pause1ms(void)
+{
+   struct timespec ts = { 0, 1000000L };
+
+   nanosleep(&ts, NULL);
+}
+
+/** Creates or attaches the table in a POSIX shared memory object */
+static int openshared(
+   PROPSSICACHE*         cache,
+   const char*           name,
+   uint64_t              nslots,
+   char*                 msg
+   )
+{
+   struct stat st;
+   void* p;
+   int fd;
+   int creator = 1;
+   int i;
+
+   cache->size = sizeof(CACHEHEADER) + nslots * sizeof(CACHESLOT);
+
+   fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+   if( fd < 0 )
+   {
+      creator = 0;
+      fd = shm_open(name, O_RDWR, 0600);
+   }
+   if( fd < 0 )
+   {
+      snprintf(msg, 255, "Cannot open shared memory cache %s.", name);
+      return 1;
+   }
+
+   if( creator )
+   {
+      if( ftruncate(fd, (off_t)cache->size) != 0 )
+      {
+         snprintf(msg, 255, "Cannot size shared memory cache %s.", name);
+         close(fd);
+         shm_unlink(name);
+         return 1;
+      }
+   }
+   else
+   {
+      /* the creator may still be sizing the object */
+      for( i = 0; i < 1000 && fstat(fd, &st) == 0 && st.st_size < (off_t)sizeof(CACHEHEADER); ++i )
+         pause1ms();
+      if( fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CACHEHEADER) )
+      {
+         snprintf(msg, 255, "Shared memory cache %s is not initialized.", name);
+         close(fd);
+         return 1;
+      }
+      cache->size = (size_t)st.st_size;
+   }
+
+   p = mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close(fd);
+   if( p == MAP_FAILED )
+   {
+      snprintf(msg, 255, "Cannot map shared memory cache %s.", name);
+      return 1;
+   }
+   cache->header = (CACHEHEADER*)p;
+   cache->slots = (CACHESLOT*)(cache->header + 1);
+   cache->shared = 1;
+
+   if( creator )
+   {
+      cache->header->layout = CACHE_LAYOUT;
+      cache->header->config = cache->config;
+      cache->header->nslots = nslots;
+      CACHE_STOREREL(&cache->header->magic, CACHE_MAGIC);
+   }
+   else
+   {
+      for( i = 0; i < 1000 && CACHE_LOADACQ(&cache->header->magic) != CACHE_MAGIC; ++i )
+         pause1ms();
+      nslots = cache->header->nslots;
+      if( CACHE_LOADACQ(&cache->header->magic) != CACHE_MAGIC
+         || cache->header->layout != CACHE_LAYOUT
+         || (nslots & (nslots - 1)) != 0
+         || sizeof(CACHEHEADER) + nslots * sizeof(CACHESLOT) > cache->size )
+      {
+         snprintf(msg, 255, "Shared memory cache %s has an unexpected layout.", name);
+         munmap(p, cache->size);
+         return 1;
+      }
+      if( cache->header->config != cache->config )
+      {
+         snprintf(msg, 255, "Shared memory cache %s was created with another CoolProp build or PROPSSI_CACHETOL.", name);
+         munmap(p, cache->size);
+         return 1;
+      }
+   }
+   cache->mask = nslots - 1;
+
+   return 0;
+}
+#endif
+
+/** Parses the relative tolerances of PROPSSI_CACHETOL, e.g. "1e-10" or "1e-12,P=1e-9,H=1e-8" */
+static int parsetolerances(
+   PROPSSICACHE*         cache,
+   const char*           env,
+   char*                 msg
+   )
+{
+   const char* p = env;
+
+   while( *p != '\0' )
+   {
+      size_t n = strcspn(p, ",");
+      size_t eq = strcspn(p, "=,");
+      char* end;
+      double tol;
+
+      tol = strtod(eq < n ? p + eq + 1 : p, &end);
+      if( n == 0 || end != p + n || !(tol >= 0.0 && tol < 1.0)
+         || (eq < n && (eq == 0 || eq >= sizeof(cache->tolnames[0]) || cache->ntols == CACHE_MAXTOLS)) )
+      {
+         snprintf(msg, 255, "Invalid tolerance PROPSSI_CACHETOL=%.100s, expected e.g. 1e-10 or P=1e-9,T=1e-10.", env);
+         return 1;
+      }
+      if( eq < n )
+      {
+         memcpy(cache->tolnames[cache->ntols], p, eq);
+         cache->tolnames[cache->ntols][eq] = '\0';
+         cache->tols[cache->ntols++] = tol;
+      }
+      else
+         cache->tolall = tol;
+      p += n;
+      if( *p == ',' )
+         ++p;
+   }
+   return 0;
+}
+
+PROPSSICACHE* cachecreate(
+   char*                 msg
+   )
+{
+   PROPSSICACHE* cache;
+   const char* env;
+   uint64_t nslots = CACHE_DEFSIZE;
+
+   msg[0] = '\0';
+
+   env = getenv("PROPSSI_CACHESIZE");
+   if( env != NULL && env[0] != '\0' )
+   {
+      char* end;
+      long long n = strtoll(env, &end, 10);
+      if( end == env || *end != '\0' || n < 0 )
+      {
+         snprintf(msg, 255, "Invalid state cache size PROPSSI_CACHESIZE=%.100s.", env);
+         return NULL;
+      }
+      if( n == 0 )
+         return NULL;
+      for( nslots = 1; nslots < (uint64_t)n; nslots <<= 1 )
+         ;
+   }
+
+   cache = calloc(1, sizeof(PROPSSICACHE));
+   if( cache == NULL )
+   {
+      snprintf(msg, 255, "Out of memory for state cache.");
+      return NULL;
+   }
+
+   env = getenv("PROPSSI_CACHETOL");
+   if( env != NULL && parsetolerances(cache, env, msg) != 0 )
+   {
+      free(cache);
+      return NULL;
+   }
+
+   env = getenv("PROPSSI_SHMCACHE");
+   if( env != NULL && env[0] != '\0' )
+   {
+#if !defined(_WIN32)
+      cache->config = confighash(cache);
+      if( openshared(cache, env, nslots, msg) != 0 )
+      {
+         free(cache);
+         return NULL;
+      }
+      return cache;
+#else
+      snprintf(msg, 255, "Shared memory cache is not available on this platform.");
+      free(cache);
+      return NULL;
+#endif
+   }
+
+   cache->size = sizeof(CACHEHEADER) + nslots * sizeof(CACHESLOT);
+   cache->header = calloc(1, cache->size);
+   if( cache->header == NULL )
+   {
+      snprintf(msg, 255, "Out of memory for state cache.");
+      free(cache);
+      return NULL;
+   }
+   cache->header->magic = CACHE_MAGIC;
+   cache->header->layout = CACHE_LAYOUT;
+   cache->header->nslots = nslots;
+   cache->slots = (CACHESLOT*)(cache->header + 1);
+   cache->mask = nslots - 1;
+
+   return cache;
+}
+
+void cachefree(
+   PROPSSICACHE*         cache
+   )
+{
+   if( cache == NULL )
+      return;
+#if !defined(_WIN32)
+   if( cache->shared )
+      munmap(cache->header, cache->size);
+   else
+#endif
+      free(cache->header);
+   free(cache);
+}
+
+uint64_t cacheused(
+   PROPSSICACHE*         cache,
+   uint64_t*             nslots
+   )
+{
+   uint64_t used = 0;
+   uint64_t i;
+
+   *nslots = cache != NULL ? cache->mask + 1 : 0;
+   for( i = 0; i < *nslots; ++i )
+      if( CACHE_LOAD(&cache->slots[i].seq) != 0 )
+         ++used;
+   return used;
+}
+
+uint64_t cachekey(
+   const char*           Prop,
+   const char*           Name1,
+   const char*           Name2,
+   const char*           Fluid
+   )
+{
+   const char* s[4] = { Prop, Name1, Name2, Fluid };
+   uint64_t h = 0xcbf29ce484222325ULL;   /* FNV-1a */
+   int i;
+
+   for( i = 0; i < 4; ++i )
+      h = fnv(fnv(h, s[i]), "|");
+   return h;
+}
+
+/** Rounds the mantissa of a value to a relative tolerance; a tolerance of 0 keeps all bits */
+static uint64_t quantize(
+   uint64_t              v,
+   double                tol
+   )
+{
+   int keep;
+   uint64_t drop;
+
+   if( tol <= 0.0 )
+      return v;
+   keep = (int)ceil(-log2(tol));
+   if( keep >= 52 )
+      return v;
+   if( keep < 0 )
+      keep = 0;
+   drop = 1ULL << (52 - keep);
+   return (v + (drop >> 1)) & ~(drop - 1);
+}
+
+/** Looks up the entry of a state, matching the input values after quantization */
+static int lookupslot(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   double                Val1,
+   double                Val2,
+   double                tol1,
+   double                tol2,
+   int                   derivrequest,
+   uint64_t              w[W_NWORDS]
+   )
+{
+   uint64_t v1 = quantize(dbits(Val1), tol1);
+   uint64_t v2 = quantize(dbits(Val2), tol2);
+   uint64_t h;
+   int probe, i;
+
+   h = slotindex(key, v1, v2);
+   for( probe = 0; probe < CACHE_MAXPROBE; ++probe )
+   {
+      CACHESLOT* slot = &cache->slots[(h + probe) & cache->mask];
+      uint64_t seq = CACHE_LOADACQ(&slot->seq);
+
+      if( seq == 0 )
+         return 0;
+      if( seq & 1 )
+         continue;
+      for( i = 0; i < W_NWORDS; ++i )
+         w[i] = CACHE_LOAD(&slot->w[i]);
+      CACHE_FENCEACQ();
+      if( CACHE_LOAD(&slot->seq) != seq )
+         continue;
+      if( w[W_KEY] != key || quantize(w[W_VAL1], tol1) != v1 || quantize(w[W_VAL2], tol2) != v2 )
+         continue;
+      return (int)w[W_LEVEL] >= derivrequest;
+   }
+   return 0;
+}
+
+/** Stores the entry of a state, replacing an entry that matches the input values after quantization */
+static void insertslot(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   double                Val1,
+   double                Val2,
+   double                tol1,
+   double                tol2,
+   int                   derivrequest,
+   const double          d[6]
+   )
+{
+   uint64_t v1 = quantize(dbits(Val1), tol1);
+   uint64_t v2 = quantize(dbits(Val2), tol2);
+   uint64_t h;
+   CACHESLOT* slot = NULL;
+   uint64_t seq = 0;
+   int probe, i;
+
+   /* take the first empty slot or the slot of the same state in the probe window */
+   h = slotindex(key, v1, v2);
+   for( probe = 0; probe < CACHE_MAXPROBE; ++probe )
+   {
+      CACHESLOT* s = &cache->slots[(h + probe) & cache->mask];
+      uint64_t sseq = CACHE_LOADACQ(&s->seq);
+
+      if( sseq & 1 )
+         continue;
+      if( sseq == 0
+         || (CACHE_LOAD(&s->w[W_KEY]) == key && quantize(CACHE_LOAD(&s->w[W_VAL1]), tol1) == v1
+            && quantize(CACHE_LOAD(&s->w[W_VAL2]), tol2) == v2) )
+      {
+         slot = s;
+         seq = sseq;
+         break;
+      }
+   }
+   /* otherwise replace the entry in the home slot */
+   if( slot == NULL )
+   {
+      slot = &cache->slots[h & cache->mask];
+      seq = CACHE_LOADACQ(&slot->seq);
+      if( seq & 1 )
+         return;
+   }
+
+   if( !CACHE_CAS(&slot->seq, seq, seq + 1) )
+      return;
+   CACHE_FENCEREL();
+   CACHE_STORE(&slot->w[W_KEY], key);
+   CACHE_STORE(&slot->w[W_VAL1], dbits(Val1));
+   CACHE_STORE(&slot->w[W_VAL2], dbits(Val2));
+   CACHE_STORE(&slot->w[W_LEVEL], (uint64_t)derivrequest);
+   for( i = 0; i < 6; ++i )
+      CACHE_STORE(&slot->w[W_D + i], dbits(d[i]));
+   CACHE_STOREREL(&slot->seq, seq + 2);
+}
+
+/** Computes the key of the tolerant entries of a state, distinct from the exact key and the tolerances */
+static uint64_t nearkey(
+   uint64_t              key,
+   double                tol1,
+   double                tol2
+   )
+{
+   return mix(key ^ 0x6e656172ULL ^ mix(dbits(tol1) ^ mix(dbits(tol2))));
+}
+
+int cachelookup(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   double                Val1,
+   double                Val2,
+   int                   derivrequest,
+   double                d[6]
+   )
+{
+   uint64_t w[W_NWORDS];
+   int i;
+
+   if( cache == NULL || !lookupslot(cache, key, Val1, Val2, 0.0, 0.0, derivrequest, w) )
+      return 0;
+   for( i = 0; i < 6; ++i )
+      d[i] = bitsd(w[W_D + i]);
+   return 1;
+}
+
+void cacheinsert(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   double                Val1,
+   double                Val2,
+   int                   derivrequest,
+   const double          d[6]
+   )
+{
+   if( cache != NULL )
+      insertslot(cache, key, Val1, Val2, 0.0, 0.0, derivrequest, d);
+}
+
+double cachetolerance(
+   const PROPSSICACHE*   cache,
+   const char*           Name
+   )
+{
+   int i;
+
+   if( cache == NULL )
+      return 0.0;
+   for( i = 0; i < cache->ntols; ++i )
+      if( strcmp(cache->tolnames[i], Name) == 0 )
+         return cache->tols[i];
+   return cache->tolall;
+}
+
+int cachelookupnear(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   double                Val1,
+   double                Val2,
+   double                tol1,
+   double                tol2,
+   int                   derivrequest,
+   double                d[6],
+   double*               x1,
+   double*               x2,
+   int*                  level
+   )
+{
+   uint64_t w[W_NWORDS];
+   int i;
+
+   if( cache == NULL || !lookupslot(cache, nearkey(key, tol1, tol2), Val1, Val2, tol1, tol2, derivrequest, w) )
+      return 0;
+   for( i = 0; i < 6; ++i )
+      d[i] = bitsd(w[W_D + i]);
+   *x1 = bitsd(w[W_VAL1]);
+   *x2 = bitsd(w[W_VAL2]);
+   *level = (int)w[W_LEVEL];
+   return 1;
+}
+
+void cacheinsertnear(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   double                Val1,
+   double                Val2,
+   double                tol1,
+   double                tol2,
+   int                   derivrequest,
+   const double          d[6]
+   )
+{
+   if( cache != NULL )
+      insertslot(cache, nearkey(key, tol1, tol2), Val1, Val2, tol1, tol2, derivrequest, d);
+}
@@ -0,0 +1,135 @@
+/** State cache for the extrinsic CoolProp library
+ *
+ * Solved states are stored in an open-addressing hash table keyed by
+ * fluid, output and input names and the two input values. Each entry
+ * holds the value and the partial derivatives computed for the state,
+ * see evalstate() in propssicclib.c.
+ *
+ * By default, the table lives in private memory of the process.
+ * If the environment variable PROPSSI_SHMCACHE names a POSIX shared
+ * memory object (e.g. "/propssi"), the first process calling libinit
+ * creates the table there and later processes attach to it, so that
+ * concurrent GAMS jobs reuse each other's evaluations. Slots are
+ * protected by sequence counters, so readers and writers never block.
+ * The shared object stays until it is removed (e.g. rm /dev/shm/propssi).
+ * Its header records the layout of the table and a hash of the CoolProp
+ * build and of PROPSSI_CACHETOL; a process with a different layout or
+ * configuration refuses to attach, since the entries would not be valid
+ * for it.
+ *
+ * PROPSSI_CACHESIZE sets the number of slots (rounded up to a power
+ * of two, default 65536); 0 disables the cache, and libinit fails on a
+ * value that is not a number of slots.
+ *
+ * Solvers often ask for states that differ only in the last digits of
+ * the inputs, e.g. after scaling or between line search steps. By default,
+ * such states miss the cache. PROPSSI_CACHETOL sets relative tolerances
+ * of the inputs, either for all inputs ("1e-10"), per input name
+ * ("P=1e-9,T=1e-10"), or both ("1e-12,H=1e-8"). States are then also
+ * stored with their inputs rounded to the tolerances, and a state missing
+ * the cache is answered from a stored state with the same rounded inputs,
+ * corrected by a Taylor step, see evalprops(). Processes sharing the
+ * table must use the same tolerances.
+ */
+
+#ifndef PROPSSICACHE_H_
+#define PROPSSICACHE_H_
+
+#include <stdint.h>
+
+/** State cache */
+typedef struct PROPSSICACHE PROPSSICACHE;
+
+/** Creates the state cache as configured by the environment.
+ *
+ * @return cache, or NULL if caching is disabled (msg empty) or failed (msg set).
+ */
+PROPSSICACHE* cachecreate(
+   char*                 msg              /**< buffer of length 255 to store error message (as C string!) */
+   );
+
+/** Detaches from and frees the state cache */
+void cachefree(
+   PROPSSICACHE*         cache            /**< cache, may be NULL */
+   );
+
+/** Counts the slots of the state cache that hold an entry
+ *
+ * @return number of occupied slots.
+ */
+uint64_t cacheused(
+   PROPSSICACHE*         cache,           /**< cache, may be NULL */
+   uint64_t*             nslots           /**< buffer to store the number of slots */
+   );
+
+/** Computes the key of a state for given output, input names, and fluid */
+uint64_t cachekey(
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   const char*           Name2,           /**< second input property */
+   const char*           Fluid            /**< fluid name */
+   );
+
+/** Looks up a state
+ *
+ * @return 1 if found with at least the requested derivatives, 0 otherwise.
+ */
+int cachelookup(
+   PROPSSICACHE*         cache,           /**< cache, may be NULL */
+   uint64_t              key,             /**< key from cachekey() */
+   double                Val1,            /**< first input value */
+   double                Val2,            /**< second input value */
+   int                   derivrequest,    /**< highest derivative needed */
+   double                d[6]             /**< buffer to store value and derivatives */
+   );
+
+/** Stores a state, replacing an entry for the same state */
+void cacheinsert(
+   PROPSSICACHE*         cache,           /**< cache, may be NULL */
+   uint64_t              key,             /**< key from cachekey() */
+   double                Val1,            /**< first input value */
+   double                Val2,            /**< second input value */
+   int                   derivrequest,    /**< highest derivative stored in d */
+   const double          d[6]             /**< value and derivatives */
+   );
+
+/** Returns the relative tolerance of an input configured by PROPSSI_CACHETOL
+ *
+ * @return tolerance, 0 if the input must match exactly.
+ */
+double cachetolerance(
+   const PROPSSICACHE*   cache,           /**< cache, may be NULL */
+   const char*           Name             /**< input property */
+   );
+
+/** Looks up a state stored by cacheinsertnear() with the same inputs after rounding to the tolerances
+ *
+ * @return 1 if found with at least the requested derivatives, 0 otherwise.
+ */
+int cachelookupnear(
+   PROPSSICACHE*         cache,           /**< cache, may be NULL */
+   uint64_t              key,             /**< key from cachekey() */
+   double                Val1,            /**< first input value */
+   double                Val2,            /**< second input value */
+   double                tol1,            /**< relative tolerance of first input */
+   double                tol2,            /**< relative tolerance of second input */
+   int                   derivrequest,    /**< highest derivative needed */
+   double                d[6],            /**< buffer to store value and derivatives of the stored state */
+   double*               x1,              /**< buffer to store first input value of the stored state */
+   double*               x2,              /**< buffer to store second input value of the stored state */
+   int*                  level            /**< buffer to store highest derivative of the stored state */
+   );
+
+/** Stores a state to be found by cachelookupnear(), replacing an entry with the same rounded inputs */
+void cacheinsertnear(
+   PROPSSICACHE*         cache,           /**< cache, may be NULL */
+   uint64_t              key,             /**< key from cachekey() */
+   double                Val1,            /**< first input value */
+   double                Val2,            /**< second input value */
+   double                tol1,            /**< relative tolerance of first input */
+   double                tol2,            /**< relative tolerance of second input */
+   int                   derivrequest,    /**< highest derivative stored in d */
+   const double          d[6]             /**< value and derivatives */
+   );
+
+#endif /* PROPSSICACHE_H_ */
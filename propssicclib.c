@@ -7,25 +7,59 @@
  *
  *   - GNU Compiler (macOS, Linux, Windows):
  *     gcc -fPIC -shared -olibpropssi[32|64].[dll|so|dylib] 
- *         propssicclib.c propssicclibql.c libCoolProp.dylib 
- *         -lm -arch [x86_64|i386]
+ *         propssicclib.c propssicclibql.c propssicache.c propssiengine.c
+ *         propssiserver.c propssieosgen.c propssimixture.c propssicheb.c
+ *         libCoolProp.dylib
+ *         -lm -lpthread [-lrt on Linux] -arch [x86_64|i386]
  *
  *   - MS Visual Studio Compiler (Windows):
- *     cl.exe -LD -Fepropssilib[64].dll propssicclib.c propssicclibql.c CoolProp.dll  
+ *     cl.exe -LD -Fepropssilib[64].dll propssicclib.c propssicclibql.c propssicache.c
+ *            propssiengine.c propssiserver.c propssieosgen.c propssimixture.c
+ *            propssicheb.c CoolProp.dll
  *            -link -def:tricclib.def
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <time.h>
 #include <math.h>
 #include <string.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2
+#endif
 
 /* include GAMS extrinsic functions API definition */
 #include "extrfunc.h"
 #include "CoolPropLib.h"
+#include "propssicache.h"
+#include "propssiengine.h"
+#include "propssiserver.h"
+#include "propssieosgen.h"
+#include "propssimixture.h"
+#include "propssicheb.h"
 
 #define CMPVER     1
+#define MAXFLUIDS  20
+#define HX_MAXSEG  500
+
+// Footprint assumed per handle and mixture component where the heap
+// usage cannot be measured.
+#define POOL_FOOTPRINT (512 * 1024)
+
+// Saturation temperatures are found by Newton steps on Q-T flashes,
+// starting from the saturation ancillary. If the iteration budget is
+// exhausted, we fall back to CoolProp's own P-Q flash.
+#define SAT_MAXITER 4
+#define SAT_RELTOL  1e-11
 
 // Since GAMS only accepts floats and integer as function
 // argument we need to select the correct index number for
@@ -33,7 +67,8 @@
 // This array can be extended to include more fluids.
 // Please check the CoolProp documentation for the available fluids.
 // http://www.coolprop.org/fluid_properties/PurePseudoPure.html
-char* FLUID2[20] = {"Water", "R134a", "Air", "\0"};
+// Mixtures are given with their mole fractions, see propssimixture.h.
+char* FLUID2[MAXFLUIDS] = {"Water", "R134a", "Air", "Methane[0.9]&Ethane[0.07]&Propane[0.03]", "\0"};
 
 // Similarily, we need to select the correct index number
 // for the property name.
@@ -43,16 +78,123 @@ char* FLUID2[20] = {"Water", "R134a", "Air", "\0"};
 // http://www.coolprop.org/coolprop/HighLevelAPI.html#table-of-string-inputs-to-propssi-function
 char* PROPERTY[20] ={"P", "T", "D", "U", "H", "S", "Q", "\0"};
 
+// Compound functions carry first and second derivatives of their
+// intermediate states with respect to the function arguments.
+// A jet stores such a quantity indexed by argument position, so that
+// it can be copied directly into the gradient and Hessian buffers.
+#define JET_MAXARGS 20
+
+/** value of an intermediate quantity together with its derivatives
+ * with respect to the function arguments
+ */
+typedef struct
+{
+   int    n;                                /**< number of function arguments */
+   double val;                              /**< value */
+   double grad[JET_MAXARGS];                /**< first derivatives */
+   double hess[JET_MAXARGS * JET_MAXARGS];  /**< second derivatives in dense form */
+} JET;
+
+// In the quasi-Newton Hessian mode (PROPSSI_HESSIAN), the Hessian of a
+// property in its two state inputs is approximated from the gradients at
+// successive states with the same output, input names, and fluid. These
+// signatures share QN_SLOTS slots by their hash. A step larger than
+// QN_RADIUS (relative to the last state, unless configured otherwise)
+// seeds the approximation anew with the exact Hessian; a step below
+// QN_MINSTEP leaves it unchanged, since the change of the gradient is
+// then lost in its rounding.
+#define QN_SLOTS   64
+#define QN_RADIUS  0.1
+#define QN_MINSTEP 1e-8
+
+/** source of the Hessians of states */
+enum
+{
+   HESSIAN_EXACT = 0,                       /**< second derivatives of CoolProp */
+   HESSIAN_BFGS,                            /**< damped BFGS approximation */
+   HESSIAN_SR1                              /**< symmetric rank-one approximation */
+};
+
+/** quasi-Newton approximation of the Hessian of a property in its two state inputs */
+typedef struct
+{
+   uint64_t key;                            /**< cachekey() of output, input names, and fluid, 0 if unused */
+   double   x[2];                           /**< inputs of the last state */
+   double   g[2];                           /**< gradient at the last state */
+   double   B[3];                           /**< approximation of d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+} QNENTRY;
+
 /** function library data
  *
  * The struct EXTRFUNC_Data has been predefined in extrfunc.h.
  * An instantiation of this struct is used to store the libraries own data.
- * In this example, we have to store the function mode that the library
- * is currently operating in.
+ * We keep one CoolProp AbstractState handle per entry of FLUID2 so that
+ * functions evaluating many states of the same stream do not pay the
+ * fluid setup cost of PropsSI for every point. Solved states are kept
+ * in a state cache (see propssicache.h), which is created by libinit.
+ * If a property server is configured (see propssiserver.h), states are
+ * evaluated there instead. For the fluids listed in PROPSSI_EOSGEN, states
+ * given by temperature and density are evaluated by generated code (see
+ * propssieosgen.h). Mixtures share one handle per set of components
+ * (see propssimixture.h), on the backend selected by PROPSSI_CUBIC.
+ * Saturation and two-phase states of the fluids in the saturation file
+ * of PROPSSI_CHEBYSHEV are evaluated from its expansions (see
+ * propssicheb.h). If PROPSSI_HESSIAN selects a quasi-Newton mode, Hessians
+ * are approximated from gradients instead of evaluated (see quasistate()).
+ *
+ * Handles and mixtures form a pool whose footprint can be bounded by
+ * PROPSSI_HANDLEMEM (in MB). At the start of each function call, the
+ * least recently used entries are freed until the pool fits; they are
+ * created again when needed. Handles in use by a call are thus never
+ * freed during the call.
+ *
+ * libinit does not evaluate states with CoolProp, so that jobs whose states
+ * are all served by the shared cache or the property server never load
+ * CoolProp's fluid database; the checks of the generated code are done on
+ * its first use. The one exception is the shared cache (PROPSSI_SHMCACHE),
+ * which asks CoolProp for its version and git revision to tag the table
+ * (see cachecreate()); these are constant strings of the library and do
+ * not load the database.
+ * The time spent in the startup steps is reported with the statistics.
  *
  * The type EXTRFUNC_DATA has been typedef'ed to struct EXTRFUNC_Data.
  */
 struct EXTRFUNC_Data{
+   long handle[MAXFLUIDS];   /**< AbstractState handle per fluid, -1 if not created yet */
+   PROPSSICACHE* cache;      /**< state cache, NULL if disabled */
+   int  server;              /**< socket of property server, -1 if evaluating in-process */
+   char errstring[ENGINE_MSGSIZE]; /**< message of the last failed state evaluation */
+   char eosgen[ENGINE_MSGSIZE];    /**< space-separated fluids evaluated by generated code */
+   MIXTURE* mixtures[MAXFLUIDS];   /**< mixture handles and phase envelopes per set of components */
+   int  nmixtures;                 /**< number of entries in mixtures */
+   size_t handlemem[MAXFLUIDS];    /**< footprint of handle in bytes */
+   size_t mixturemem[MAXFLUIDS];   /**< footprint of mixture in bytes, including its phase envelopes */
+   double handletime[MAXFLUIDS];   /**< time to create handle in seconds */
+   double mixturetime[MAXFLUIDS];  /**< time to create mixture in seconds */
+   unsigned long handleuse[MAXFLUIDS];  /**< call of last use of handle */
+   unsigned long mixtureuse[MAXFLUIDS]; /**< call of last use of mixture */
+   size_t memlimit;                /**< ceiling for the footprint of the pool in bytes, 0 if unlimited */
+   size_t mempeak;                 /**< highest footprint of the pool */
+   unsigned long calls;            /**< function calls, as clock for the pool */
+   unsigned long created;          /**< handles and mixtures created */
+   unsigned long evictions;        /**< handles and mixtures freed to fit the pool */
+   int  eosgenchecked;             /**< whether the generated code has been checked against CoolProp */
+   char eosgenfailure[ENGINE_MSGSIZE]; /**< deviation that disabled the generated code, empty if none */
+   int  evaluated;                 /**< whether a state has been evaluated */
+   double tlibinit;                /**< time spent in libinit in seconds */
+   double tcache;                  /**< of that, to create or attach the state cache */
+   double tserver;                 /**< of that, to connect to the property server */
+   double teosgen;                 /**< time to check the generated code */
+   double tfirst;                  /**< time of the first state evaluation, including the start of CoolProp */
+   double boundbox[8];             /**< arguments of the last box of PropsSIBound */
+   double bounds[2];               /**< lower and upper bound over that box */
+   int  boundvalid;                /**< whether bounds belong to boundbox */
+   int  hessmode;                  /**< source of Hessians, HESSIAN_EXACT unless set by PROPSSI_HESSIAN */
+   double hessradius;              /**< relative step beyond which an approximation is seeded anew */
+   QNENTRY qn[QN_SLOTS];           /**< Hessian approximations by signature */
+   unsigned long qnseeds;          /**< exact Hessians seeding an approximation */
+   unsigned long qnhessians;       /**< Hessians answered from an approximation */
+   unsigned long qnskipped;        /**< updates skipped for lack of curvature information */
 };
 
 
@@ -63,9 +205,625 @@ struct EXTRFUNC_Data{
  * functions itself.
  */
 EXTRFUNC_DECL_FUNCCALL(PropsSI2);
+EXTRFUNC_DECL_FUNCCALL(CompressorOut);
+EXTRFUNC_DECL_FUNCCALL(TurbineOut);
+EXTRFUNC_DECL_FUNCCALL(HXPinch);
+EXTRFUNC_DECL_FUNCCALL(Tsat);
+EXTRFUNC_DECL_FUNCCALL(Psat);
+EXTRFUNC_DECL_FUNCCALL(SatProp);
+EXTRFUNC_DECL_FUNCCALL(Exergy);
+EXTRFUNC_DECL_FUNCCALL(IsentropicExp);
+EXTRFUNC_DECL_FUNCCALL(HeatCapRatio);
+EXTRFUNC_DECL_FUNCCALL(JouleThomson);
+EXTRFUNC_DECL_FUNCCALL(PropsSIFidelity);
+EXTRFUNC_DECL_FUNCCALL(PropsSIBound);
 
 /* implementations */
 
+/** Stores "func: text" as Delphi string in msg, cutting text to the space left by the function name */
+static void funcerror(
+   char*                 msg,             /**< buffer of length EXTRFUNC_STRSIZE */
+   const char*           func,            /**< name of the calling function */
+   const char*           text             /**< message (as C string!) */
+   )
+{
+   int len = (int)strlen(func);
+   int room = len < EXTRFUNC_STRSIZE-4 ? EXTRFUNC_STRSIZE-4 - len : 0;
+
+   snprintf(msg+1, EXTRFUNC_STRSIZE-1, "%.*s: %.*s", EXTRFUNC_STRSIZE-4 - room, func, room, text);
+   msg[0] = strlen(msg+1);
+}
+
+/** Stores the message of the last failed state evaluation as Delphi string in msg */
+static void stateerror(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   char*                 msg,             /**< buffer of length EXTRFUNC_STRSIZE */
+   const char*           func             /**< name of the calling function */
+   )
+{
+   funcerror(msg, func, data->errstring);
+}
+
+/** Initializes a jet with a constant value */
+static void jetconst(
+   JET*                  r,               /**< jet to initialize */
+   int                   n,               /**< number of function arguments */
+   double                val              /**< value */
+   )
+{
+   r->n = n;
+   r->val = val;
+   memset(r->grad, 0, n * sizeof(double));
+   memset(r->hess, 0, n * n * sizeof(double));
+}
+
+/** Initializes a jet with the function argument i */
+static void jetvar(
+   JET*                  r,               /**< jet to initialize */
+   int                   n,               /**< number of function arguments */
+   int                   i,               /**< argument position */
+   double                val              /**< argument value */
+   )
+{
+   jetconst(r, n, val);
+   r->grad[i] = 1.0;
+}
+
+/** Computes r = alpha * a + beta * b */
+static void jetlin(
+   JET*                  r,               /**< result, may alias a or b */
+   double                alpha,           /**< factor for a */
+   const JET*            a,               /**< first operand */
+   double                beta,            /**< factor for b */
+   const JET*            b                /**< second operand */
+   )
+{
+   int n = a->n;
+   int i;
+
+   r->n = n;
+   r->val = alpha * a->val + beta * b->val;
+   for( i = 0; i < n; ++i )
+      r->grad[i] = alpha * a->grad[i] + beta * b->grad[i];
+   for( i = 0; i < n * n; ++i )
+      r->hess[i] = alpha * a->hess[i] + beta * b->hess[i];
+}
+
+/** Computes r = a * b */
+static void jetmul(
+   JET*                  r,               /**< result, may alias a or b */
+   const JET*            a,               /**< first operand */
+   const JET*            b                /**< second operand */
+   )
+{
+   JET t;
+   int n = a->n;
+   int i, j;
+
+   t.n = n;
+   t.val = a->val * b->val;
+   for( i = 0; i < n; ++i )
+      t.grad[i] = a->grad[i] * b->val + a->val * b->grad[i];
+   for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j )
+         t.hess[i*n+j] = a->hess[i*n+j] * b->val + a->val * b->hess[i*n+j]
+            + a->grad[i] * b->grad[j] + b->grad[i] * a->grad[j];
+   *r = t;
+}
+
+/** Computes r = f(a) from the value and derivatives of f at a */
+static void jetfunc1(
+   JET*                  r,               /**< result, may alias a */
+   const double          f[3],            /**< f, df/da, d2f/da2 */
+   const JET*            a                /**< operand */
+   )
+{
+   JET t;
+   int n = a->n;
+   int i, j;
+
+   t.n = n;
+   t.val = f[0];
+   for( i = 0; i < n; ++i )
+      t.grad[i] = f[1] * a->grad[i];
+   for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j )
+         t.hess[i*n+j] = f[1] * a->hess[i*n+j] + f[2] * a->grad[i] * a->grad[j];
+   *r = t;
+}
+
+/** Computes r = f(a, b) from the value and partial derivatives of f at (a, b) */
+static void jetfunc2(
+   JET*                  r,               /**< result, may alias a or b */
+   const double          f[6],            /**< f, df/da, df/db, d2f/da2, d2f/dadb, d2f/db2 */
+   const JET*            a,               /**< first operand */
+   const JET*            b                /**< second operand */
+   )
+{
+   JET t;
+   int n = a->n;
+   int i, j;
+
+   t.n = n;
+   t.val = f[0];
+   for( i = 0; i < n; ++i )
+      t.grad[i] = f[1] * a->grad[i] + f[2] * b->grad[i];
+   for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j )
+         t.hess[i*n+j] = f[1] * a->hess[i*n+j] + f[2] * b->hess[i*n+j]
+            + f[3] * a->grad[i] * a->grad[j]
+            + f[4] * (a->grad[i] * b->grad[j] + b->grad[i] * a->grad[j])
+            + f[5] * b->grad[i] * b->grad[j];
+   *r = t;
+}
+
+/** Checks whether a fluid is listed in a space-separated list */
+static int fluidlisted(
+   const char*           list,            /**< list of fluid names */
+   const char*           Fluid            /**< fluid name */
+   )
+{
+   size_t len = strlen(Fluid);
+
+   while( *list != '\0' )
+   {
+      size_t n = strcspn(list, " ");
+      if( n == len && strncmp(list, Fluid, len) == 0 )
+         return 1;
+      list += n;
+      list += strspn(list, " ");
+   }
+   return 0;
+}
+
+/** Returns the wall-clock time in seconds */
+static double walltime(
+   void
+   )
+{
+#if defined(_WIN32)
+   return (double)clock() / CLOCKS_PER_SEC;
+#else
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return t.tv_sec + 1e-9 * t.tv_nsec;
+#endif
+}
+
+/** Returns the number of bytes allocated on the heap, 0 if unknown */
+static size_t heapused(
+   void
+   )
+{
+#if defined(HAVE_MALLINFO2)
+   struct mallinfo2 mi = mallinfo2();
+   return mi.uordblks + mi.hblkhd;
+#else
+   return 0;
+#endif
+}
+
+/** Returns the footprint of the pool in bytes */
+static size_t poolmem(
+   EXTRFUNC_DATA*        data             /**< function library data structure */
+   )
+{
+   size_t mem = 0;
+   int i;
+
+   for( i = 0; i < MAXFLUIDS; ++i )
+      if( data->handle[i] >= 0 )
+         mem += data->handlemem[i];
+   for( i = 0; i < data->nmixtures; ++i )
+      mem += data->mixturemem[i];
+   if( mem > data->mempeak )
+      data->mempeak = mem;
+   return mem;
+}
+
+/** Frees the least recently used handles and mixtures until the pool fits into its ceiling
+ *
+ * To be called at the start of each function call, which also advances the clock of the pool.
+ */
+static void poolenforce(
+   EXTRFUNC_DATA*        data             /**< function library data structure */
+   )
+{
+   long errcode;
+   char buf[EXTRFUNC_STRSIZE];
+
+   ++data->calls;
+   if( data->memlimit == 0 )
+      return;
+   while( poolmem(data) > data->memlimit )
+   {
+      unsigned long oldest = data->calls;
+      int handle = -1;
+      int mixture = -1;
+      int i;
+
+      for( i = 0; i < MAXFLUIDS; ++i )
+         if( data->handle[i] >= 0 && data->handleuse[i] < oldest )
+         {
+            oldest = data->handleuse[i];
+            handle = i;
+         }
+      for( i = 0; i < data->nmixtures; ++i )
+         if( data->mixtureuse[i] < oldest )
+         {
+            oldest = data->mixtureuse[i];
+            mixture = i;
+            handle = -1;
+         }
+      if( mixture >= 0 )
+      {
+         mixturefree(data->mixtures[mixture]);
+         --data->nmixtures;
+         data->mixtures[mixture] = data->mixtures[data->nmixtures];
+         data->mixturemem[mixture] = data->mixturemem[data->nmixtures];
+         data->mixturetime[mixture] = data->mixturetime[data->nmixtures];
+         data->mixtureuse[mixture] = data->mixtureuse[data->nmixtures];
+      }
+      else if( handle >= 0 )
+      {
+         AbstractState_free(data->handle[handle], &errcode, buf, sizeof(buf));
+         data->handle[handle] = -1;
+      }
+      else
+         break;
+      ++data->evictions;
+   }
+}
+
+/** Returns the mixture for the components of a mixture name, creating it on first use
+ *
+ * @return mixture, or NULL if it could not be created (data->errstring is set then).
+ */
+static MIXTURE* mixturefor(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           Fluid            /**< mixture name with fractions */
+   )
+{
+   MIXTURE* mix;
+   size_t heap;
+   double t;
+   int i;
+
+   for( i = 0; i < data->nmixtures; ++i )
+      if( mixturematches(data->mixtures[i], Fluid) )
+      {
+         data->mixtureuse[i] = data->calls;
+         return data->mixtures[i];
+      }
+   if( data->nmixtures == MAXFLUIDS )
+   {
+      snprintf(data->errstring, sizeof(data->errstring), "Too many mixtures.");
+      return NULL;
+   }
+   heap = heapused();
+   t = walltime();
+   mix = mixturecreate(Fluid, mixturebackend(Fluid), data->errstring);
+   if( mix != NULL )
+   {
+      size_t mem = POOL_FOOTPRINT;
+      const char* c;
+
+      for( c = Fluid; *c != '\0'; ++c )
+         if( *c == '&' )
+            mem += POOL_FOOTPRINT;
+      /* the allocator may have released more than the mixture took */
+      data->mixturemem[data->nmixtures] = heap > 0 && heapused() > heap ? heapused() - heap : mem;
+      data->mixturetime[data->nmixtures] = walltime() - t;
+      data->mixtureuse[data->nmixtures] = data->calls;
+      data->mixtures[data->nmixtures++] = mix;
+      ++data->created;
+      poolmem(data);
+   }
+   return mix;
+}
+
+/** Index of a mixture in the pool */
+static int mixtureslot(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const MIXTURE*        mix              /**< mixture */
+   )
+{
+   int i;
+
+   for( i = 0; i < data->nmixtures; ++i )
+      if( data->mixtures[i] == mix )
+         return i;
+   return -1;
+}
+
+/** Evaluates a property and its partial derivatives with respect to the two state inputs, with exact Hessians.
+ *
+ * States given by temperature and density of a fluid with generated code
+ * enabled are evaluated by that code, unless they may be two-phase; the
+ * code is checked against CoolProp on the first evaluation. If it
+ * deviates, it is disabled and the deviation reported with the statistics.
+ * Two-phase states covered by the saturation expansions are evaluated
+ * from these (see chebstate()). Mixtures are evaluated on their shared handle (see mixtureeval()).
+ * Otherwise, the state is evaluated on the property server if one is connected,
+ * and in-process by the engine otherwise (see evalprops()). If the
+ * connection to the server breaks, we continue in-process.
+ *
+ * @return 0 if successful, <> 0 if CoolProp could not evaluate the state (data->errstring is set then).
+ */
+static int evaldirect(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name */
+   int                   derivrequest,    /**< highest derivative to compute */
+   double                d[6]             /**< buffer for f, df/d1, df/d2, d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+   )
+{
+   if( !data->evaluated )
+   {
+      double t = walltime();
+      int rc;
+
+      data->evaluated = 1;
+      rc = evaldirect(data, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d);
+      data->tfirst = walltime() - t;
+      return rc;
+   }
+   if( data->eosgen[0] != '\0' && !data->eosgenchecked )
+   {
+      char fluid[ENGINE_MSGSIZE];
+      const char* list;
+      double t = walltime();
+
+      data->eosgenchecked = 1;
+      for( list = data->eosgen + strspn(data->eosgen, " "); *list != '\0'; list += strspn(list, " ") )
+      {
+         size_t n = strcspn(list, " ");
+         snprintf(fluid, sizeof(fluid), "%.*s", (int)n, list);
+         list += n;
+         if( eosgencheck(fluid, data->eosgenfailure) != 0 )
+         {
+            /* the state itself is valid: report the deviation with the statistics, and continue with CoolProp */
+            snprintf(data->errstring, sizeof(data->errstring), "%s", data->eosgenfailure);
+            data->eosgen[0] = '\0';
+            break;
+         }
+      }
+      data->teosgen = walltime() - t;
+   }
+   if( data->eosgen[0] != '\0' && fluidlisted(data->eosgen, Fluid) )
+   {
+      int isD1 = strcmp(Name1, "D") == 0 || strcmp(Name1, "Dmass") == 0;
+      int isD2 = strcmp(Name2, "D") == 0 || strcmp(Name2, "Dmass") == 0;
+
+      if( strcmp(Name1, "T") == 0 && isD2 && eosgenprops(Prop, Val1, Val2, Fluid, d) == 0 )
+         return 0;
+      if( isD1 && strcmp(Name2, "T") == 0 && eosgenprops(Prop, Val2, Val1, Fluid, d) == 0 )
+      {
+         double t;
+         t = d[1]; d[1] = d[2]; d[2] = t;
+         t = d[3]; d[3] = d[5]; d[5] = t;
+         return 0;
+      }
+   }
+   if( chebstate(Prop, Name1, Val1, Name2, Val2, Fluid, d) == 0 )
+      return 0;
+   /* the property server does not know the cubic configuration */
+   if( mixtureis(Fluid) && (data->server < 0 || strcmp(mixturebackend(Fluid), "HEOS") != 0) )
+   {
+      const char* backend = mixturebackend(Fluid);
+      char name[ENGINE_MSGSIZE];
+      uint64_t key;
+      unsigned long envelopes = mixturestats.envelopes;
+      size_t heap;
+      MIXTURE* mix;
+      int rc;
+
+      /* states on different backends, or with different parameters, must not share cache entries */
+      if( strcmp(backend, "HEOS") != 0 && mixtureparameters(Fluid) != 0 )
+         snprintf(name, sizeof(name), "%s::%s#%016llx", backend, Fluid, (unsigned long long)mixtureparameters(Fluid));
+      else
+         snprintf(name, sizeof(name), "%s::%s", backend, Fluid);
+      key = cachekey(Prop, Name1, Name2, strcmp(backend, "HEOS") != 0 ? name : Fluid);
+      if( cachelookup(data->cache, key, Val1, Val2, derivrequest, d) )
+         return 0;
+      if( negativefind(Prop, Name1, Val1, Name2, Val2, name, derivrequest, data->errstring) )
+         return 1;
+      if( (mix = mixturefor(data, Fluid)) == NULL )
+         return 1;
+      heap = heapused();
+      rc = mixtureeval(mix, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, data->errstring);
+      /* a new phase envelope adds to the footprint of the mixture */
+      if( mixturestats.envelopes != envelopes && heap > 0 && heapused() > heap )
+         data->mixturemem[mixtureslot(data, mix)] += heapused() - heap;
+      if( rc == 0 )
+         cacheinsert(data->cache, key, Val1, Val2, derivrequest, d);
+      else if( rc > 0 )
+         negativeadd(Prop, Name1, Val1, Name2, Val2, name, derivrequest, data->errstring);
+      /* derivatives not available from the handle: let PropsSI differentiate */
+      if( rc >= 0 )
+         return rc;
+      if( strcmp(backend, "HEOS") != 0 )
+      {
+         snprintf(data->errstring, sizeof(data->errstring), "%.20s of %.150s not available on backend %s.", Prop, Fluid, backend);
+         return 1;
+      }
+   }
+   if( data->server >= 0 )
+   {
+      int rc = serverevalprops(data->server, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, data->errstring);
+      if( rc >= 0 )
+         return rc;
+      if( rc == -1 )
+         data->server = -1;
+   }
+   return evalprops(data->cache, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, data->errstring);
+}
+
+/** Evaluates a property and its gradient with respect to the two state inputs, and approximates its Hessian
+ *
+ * The approximation B of the signature of the state (output, input names,
+ * and fluid) is seeded with the exact Hessian at the first state, and
+ * whenever an input moved by more than data->hessradius relative to the
+ * last state (absolute for inputs that were 0). Otherwise, only the gradient is evaluated, and B is updated
+ * with the step s and the change of the gradient y:
+ *
+ *   SR1:  B += r r' / (r's) with r = y - Bs, skipped if |r's| < 1e-8 |r| |s|
+ *         (in inputs relative to the last state),
+ *   BFGS: B += q q' / (q's) - Bs s'B / (s'Bs) with Powell's damping
+ *         q = t y + (1-t) Bs, t in (0,1] the largest with q's >= 0.2 s'Bs.
+ *
+ * Properties need not be convex in the inputs, and the damping relies on
+ * B being positive definite; where it is not, BFGS takes the SR1 update.
+ *
+ * @return 0 if successful, <> 0 if CoolProp could not evaluate the state (data->errstring is set then).
+ */
+static int quasistate(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name */
+   double                d[6]             /**< buffer for f, df/d1, df/d2, d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+   )
+{
+   uint64_t key = cachekey(Prop, Name1, Name2, Fluid) | 1;
+   QNENTRY* e = &data->qn[(key >> 1) & (QN_SLOTS - 1)];
+   double s[2], y[2], Bs[2], w[2], sBs, sy, step;
+   int i;
+
+   /* inputs at 0, e.g. Q, are scaled by 1 */
+   step = 0.0;
+   for( i = 0; i < 2; ++i )
+   {
+      s[i] = (i == 0 ? Val1 : Val2) - e->x[i];
+      w[i] = e->x[i] != 0.0 ? fabs(e->x[i]) : 1.0;
+      step = fmax(step, fabs(s[i]) / w[i]);
+   }
+   if( e->key != key || !(step <= data->hessradius) )
+   {
+      if( evaldirect(data, Prop, Name1, Val1, Name2, Val2, Fluid, 2, d) )
+         return 1;
+      e->key = key;
+      e->x[0] = Val1;
+      e->x[1] = Val2;
+      e->g[0] = d[1];
+      e->g[1] = d[2];
+      e->B[0] = d[3];
+      e->B[1] = d[4];
+      e->B[2] = d[5];
+      ++data->qnseeds;
+      return 0;
+   }
+   if( evaldirect(data, Prop, Name1, Val1, Name2, Val2, Fluid, 1, d) )
+      return 1;
+   if( step >= QN_MINSTEP )
+   {
+      double* B = e->B;
+
+      y[0] = d[1] - e->g[0];
+      y[1] = d[2] - e->g[1];
+      Bs[0] = B[0] * s[0] + B[1] * s[1];
+      Bs[1] = B[1] * s[0] + B[2] * s[1];
+      sBs = s[0] * Bs[0] + s[1] * Bs[1];
+      sy = s[0] * y[0] + s[1] * y[1];
+      if( data->hessmode == HESSIAN_BFGS && B[0] > 0.0 && B[0] * B[2] > B[1] * B[1] )
+      {
+         double t = sy >= 0.2 * sBs ? 1.0 : 0.8 * sBs / (sBs - sy);
+         double q[2], qs;
+
+         q[0] = t * y[0] + (1.0 - t) * Bs[0];
+         q[1] = t * y[1] + (1.0 - t) * Bs[1];
+         qs = q[0] * s[0] + q[1] * s[1];
+         B[0] += q[0] * q[0] / qs - Bs[0] * Bs[0] / sBs;
+         B[1] += q[0] * q[1] / qs - Bs[0] * Bs[1] / sBs;
+         B[2] += q[1] * q[1] / qs - Bs[1] * Bs[1] / sBs;
+      }
+      else
+      {
+         double r[2], rs, rnorm, snorm;
+
+         r[0] = y[0] - Bs[0];
+         r[1] = y[1] - Bs[1];
+         rs = r[0] * s[0] + r[1] * s[1];
+         /* r scales like the gradient, s like the inputs */
+         rnorm = hypot(r[0] * w[0], r[1] * w[1]);
+         snorm = hypot(s[0] / w[0], s[1] / w[1]);
+         if( fabs(rs) >= 1e-8 * rnorm * snorm && rs != 0.0 )
+         {
+            B[0] += r[0] * r[0] / rs;
+            B[1] += r[0] * r[1] / rs;
+            B[2] += r[1] * r[1] / rs;
+         }
+         else if( rnorm > 0.0 )
+            ++data->qnskipped;
+      }
+      e->x[0] = Val1;
+      e->x[1] = Val2;
+      e->g[0] = d[1];
+      e->g[1] = d[2];
+   }
+   d[3] = e->B[0];
+   d[4] = e->B[1];
+   d[5] = e->B[2];
+   ++data->qnhessians;
+   return 0;
+}
+
+/** Evaluates a property and its partial derivatives with respect to the two state inputs.
+ *
+ * Hessians are exact (see evaldirect()), or approximated in the
+ * quasi-Newton mode selected by PROPSSI_HESSIAN (see quasistate()).
+ *
+ * @return 0 if successful, <> 0 if CoolProp could not evaluate the state (data->errstring is set then).
+ */
+static int evalstate(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name */
+   int                   derivrequest,    /**< highest derivative to compute */
+   double                d[6]             /**< buffer for f, df/d1, df/d2, d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+   )
+{
+   if( derivrequest > 1 && data->hessmode != HESSIAN_EXACT )
+      return quasistate(data, Prop, Name1, Val1, Name2, Val2, Fluid, d);
+   return evaldirect(data, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d);
+}
+
+/** Evaluates a property at the state given by two jets and stores it as jet in r
+ *
+ * @return 0 if successful, <> 0 if CoolProp could not evaluate the state.
+ */
+static int jetstate(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   JET*                  r,               /**< result, may alias a or b */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   const JET*            a,               /**< first input */
+   const char*           Name2,           /**< second input property */
+   const JET*            b,               /**< second input */
+   const char*           Fluid,           /**< fluid name */
+   int                   derivrequest     /**< highest derivative to compute */
+   )
+{
+   double d[6];
+
+   if( evalstate(data, Prop, Name1, a->val, Name2, b->val, Fluid, derivrequest, d) )
+      return 1;
+   jetfunc2(r, d, a, b);
+   return 0;
+}
+
+
 /** Callback function to create function library data.
  *
  * This function is called by the GAMS execution system after the library
@@ -76,8 +834,100 @@ EXTRFUNC_API void EXTRFUNC_CALLCONV xcreate(
    EXTRFUNC_DATA**       data             /**< buffer to store pointer to function library data structure */
    )
 {
+   int i;
+
    *data = malloc(sizeof(EXTRFUNC_DATA));
    assert(*data != NULL);
+   for( i = 0; i < MAXFLUIDS; ++i )
+      (*data)->handle[i] = -1;
+   (*data)->cache = NULL;
+   (*data)->server = -1;
+   (*data)->errstring[0] = '\0';
+   (*data)->eosgen[0] = '\0';
+   (*data)->nmixtures = 0;
+   (*data)->memlimit = 0;
+   (*data)->mempeak = 0;
+   (*data)->calls = 0;
+   (*data)->created = 0;
+   (*data)->evictions = 0;
+   (*data)->eosgenchecked = 0;
+   (*data)->eosgenfailure[0] = '\0';
+   (*data)->evaluated = 0;
+   (*data)->tlibinit = 0.0;
+   (*data)->tcache = 0.0;
+   (*data)->tserver = 0.0;
+   (*data)->teosgen = 0.0;
+   (*data)->tfirst = 0.0;
+   (*data)->boundvalid = 0;
+   (*data)->hessmode = HESSIAN_EXACT;
+   (*data)->hessradius = QN_RADIUS;
+   for( i = 0; i < QN_SLOTS; ++i )
+      (*data)->qn[i].key = 0;
+   (*data)->qnseeds = 0;
+   (*data)->qnhessians = 0;
+   (*data)->qnskipped = 0;
+}
+
+/** Writes the statistics of the library to the file named by PROPSSI_STATS ("stderr" for standard error) */
+static void printstats(
+   EXTRFUNC_DATA*        data             /**< function library data structure */
+   )
+{
+   const char* name = getenv("PROPSSI_STATS");
+   FILE* f;
+   int i;
+
+   if( name == NULL || name[0] == '\0' )
+      return;
+   f = strcmp(name, "stderr") == 0 ? stderr : fopen(name, "a");
+   if( f == NULL )
+      return;
+
+   fprintf(f, "PropsSI library statistics\n");
+   fprintf(f, "  state lookups          : %lu\n", enginestats.lookups);
+   fprintf(f, "  cache hits             : %lu\n", enginestats.cachehits);
+   fprintf(f, "  within tolerance       : %lu (%.1f%% of lookups)\n", enginestats.nearhits,
+      enginestats.lookups > 0 ? 100.0 * enginestats.nearhits / enginestats.lookups : 0.0);
+   fprintf(f, "  max Taylor correction  : %.3g (relative)\n", enginestats.maxcorrection);
+   fprintf(f, "  CoolProp evaluations   : %lu\n", enginestats.evaluations);
+   fprintf(f, "  failed evaluations     : %lu\n", enginestats.failures);
+   fprintf(f, "  failures avoided       : %lu\n", enginestats.avoided);
+   fprintf(f, "  over time budget       : %lu\n", enginestats.overbudget);
+   fprintf(f, "  answered by fallback   : %lu\n", enginestats.fallbacks);
+   fprintf(f, "  answered approximately : %lu\n", enginestats.approximations);
+   fprintf(f, "  switched to full EOS   : %lu states by step, %lu times by PropsSIFidelity\n",
+      enginestats.fidelityswitches, enginestats.polishes);
+   fprintf(f, "  speculative evaluations: %lu\n", enginestats.speculated);
+   fprintf(f, "  speculative hits       : %lu\n", enginestats.spechits);
+   fprintf(f, "  saturation expansions  : %lu states (%lu left to CoolProp)\n", chebstats.evaluations, chebstats.declined);
+   if( data->hessmode != HESSIAN_EXACT )
+      fprintf(f, "  quasi-Newton Hessians  : %lu (%lu exact seeds, %lu updates skipped)\n", data->qnhessians, data->qnseeds,
+         data->qnskipped);
+   fprintf(f, "  mixture flashes        : %lu\n", mixturestats.flashes);
+   fprintf(f, "  with phase imposed     : %lu\n", mixturestats.imposed);
+   fprintf(f, "  on a cubic backend     : %lu\n", mixturestats.cubicflashes);
+   fprintf(f, "  mixture fraction sets  : %lu\n", mixturestats.fractionsets);
+   fprintf(f, "  phase envelopes built  : %lu\n", mixturestats.envelopes);
+   fprintf(f, "  handles created        : %lu\n", data->created);
+   fprintf(f, "  handles evicted        : %lu\n", data->evictions);
+   poolmem(data);
+   fprintf(f, "  peak handle memory     : %.1f MB\n", data->mempeak / 1048576.0);
+   for( i = 0; i < MAXFLUIDS; ++i )
+      if( data->handle[i] >= 0 )
+         fprintf(f, "  handle %-40s: %.1f kB, created in %.3f ms\n", FLUID2[i], data->handlemem[i] / 1024.0, 1000.0 * data->handletime[i]);
+   for( i = 0; i < data->nmixtures; ++i )
+      fprintf(f, "  mixture %-39s: %.1f kB, created in %.3f ms\n", mixturecomponents(data->mixtures[i]), data->mixturemem[i] / 1024.0,
+         1000.0 * data->mixturetime[i]);
+   fprintf(f, "  startup: libinit       : %.3f ms\n", 1000.0 * data->tlibinit);
+   fprintf(f, "    state cache          : %.3f ms\n", 1000.0 * data->tcache);
+   fprintf(f, "    server connection    : %.3f ms\n", 1000.0 * data->tserver);
+   fprintf(f, "  first evaluation       : %.3f ms\n", 1000.0 * data->tfirst);
+   fprintf(f, "    generated code check : %.3f ms\n", 1000.0 * data->teosgen);
+   if( data->eosgenfailure[0] != '\0' )
+      fprintf(f, "    disabled by          : %s\n", data->eosgenfailure);
+
+   if( f != stderr )
+      fclose(f);
 }
 
 /** Callback function to free function library data.
@@ -89,8 +939,26 @@ EXTRFUNC_API void EXTRFUNC_CALLCONV xfree(
    EXTRFUNC_DATA**       data             /**< pointer to pointer to function library data structure */
    )
 {
+   long errcode;
+   char buf[EXTRFUNC_STRSIZE];
+   int i;
+
    if( data != NULL )
    {
+      if( *data != NULL )
+         for( i = 0; i < MAXFLUIDS; ++i )
+            if( (*data)->handle[i] >= 0 )
+               AbstractState_free((*data)->handle[i], &errcode, buf, sizeof(buf));
+      if( *data != NULL )
+      {
+         printstats(*data);
+         for( i = 0; i < (*data)->nmixtures; ++i )
+            mixturefree((*data)->mixtures[i]);
+         /* background evaluations still hold the cache */
+         engineshutdown();
+         cachefree((*data)->cache);
+         serverclose((*data)->server);
+      }
       free(*data);
       *data = NULL;
    }
@@ -117,12 +985,118 @@ EXTRFUNC_API int EXTRFUNC_CALLCONV libinit(
    char*                 msg              /**< buffer of length 255 to store error message (as Delphi string!) */
    )
 {
+   double start = walltime();
+   double t;
+
    if( version < CMPVER )
    {
       sprintf(msg+1, "Client is too old for this Library.");
       msg[0] = strlen(msg+1);
       return 1;
    }
+   if( data->cache == NULL )
+   {
+      t = walltime();
+      data->cache = cachecreate(msg+1);
+      data->tcache = walltime() - t;
+      if( data->cache == NULL && msg[1] != '\0' )
+      {
+         msg[0] = strlen(msg+1);
+         return 1;
+      }
+   }
+   if( enginebudget(msg+1) != 0 )
+   {
+      msg[0] = strlen(msg+1);
+      return 1;
+   }
+   if( enginenegative(msg+1) != 0 )
+   {
+      msg[0] = strlen(msg+1);
+      return 1;
+   }
+   if( enginefidelity(msg+1) != 0 )
+   {
+      msg[0] = strlen(msg+1);
+      return 1;
+   }
+   if( mixtureconfig(msg+1) != 0 )
+   {
+      msg[0] = strlen(msg+1);
+      return 1;
+   }
+   if( chebload(msg+1) != 0 )
+   {
+      msg[0] = strlen(msg+1);
+      return 1;
+   }
+   if( getenv("PROPSSI_HANDLEMEM") != NULL && getenv("PROPSSI_HANDLEMEM")[0] != '\0' )
+   {
+      char* end;
+      double mb = strtod(getenv("PROPSSI_HANDLEMEM"), &end);
+      if( *end != '\0' || !(mb >= 0.0) )
+      {
+         sprintf(msg+1, "Invalid handle memory ceiling PROPSSI_HANDLEMEM=%.100s.", getenv("PROPSSI_HANDLEMEM"));
+         msg[0] = strlen(msg+1);
+         return 1;
+      }
+      data->memlimit = (size_t)(mb * 1048576.0);
+   }
+   if( getenv("PROPSSI_HESSIAN") != NULL && getenv("PROPSSI_HESSIAN")[0] != '\0' )
+   {
+      const char* mode = getenv("PROPSSI_HESSIAN");
+      size_t n = strcspn(mode, ":");
+      char* end = "";
+
+      data->hessradius = QN_RADIUS;
+      if( mode[n] == ':' )
+         data->hessradius = strtod(mode + n + 1, &end);
+      if( n == 5 && strncmp(mode, "exact", n) == 0 )
+         data->hessmode = HESSIAN_EXACT;
+      else if( n == 4 && strncmp(mode, "bfgs", n) == 0 )
+         data->hessmode = HESSIAN_BFGS;
+      else if( n == 3 && strncmp(mode, "sr1", n) == 0 )
+         data->hessmode = HESSIAN_SR1;
+      else
+         end = "?";
+      if( *end != '\0' || !(data->hessradius > 0.0) )
+      {
+         sprintf(msg+1, "Invalid Hessian mode PROPSSI_HESSIAN=%.100s, expected exact, bfgs, or sr1, optionally followed by :radius.",
+            mode);
+         msg[0] = strlen(msg+1);
+         data->hessmode = HESSIAN_EXACT;
+         return 1;
+      }
+   }
+   if( data->server < 0 && getenv("PROPSSI_SERVER") != NULL )
+   {
+      t = walltime();
+      data->server = serverconnect(getenv("PROPSSI_SERVER"));
+      data->tserver = walltime() - t;
+   }
+   if( getenv("PROPSSI_EOSGEN") != NULL )
+   {
+      char fluid[ENGINE_MSGSIZE];
+      const char* list;
+
+      /* the check against CoolProp is left to the first evaluation, see evaldirect() */
+      snprintf(data->eosgen, sizeof(data->eosgen), "%s", getenv("PROPSSI_EOSGEN"));
+      data->eosgenchecked = 0;
+      data->eosgenfailure[0] = '\0';
+      for( list = data->eosgen + strspn(data->eosgen, " "); *list != '\0'; list += strspn(list, " ") )
+      {
+         size_t n = strcspn(list, " ");
+         snprintf(fluid, sizeof(fluid), "%.*s", (int)n, list);
+         list += n;
+         if( eosgenhas(fluid) )
+            continue;
+         sprintf(msg+1, "No generated equation of state for %.200s.", fluid);
+         msg[0] = strlen(msg+1);
+         data->eosgen[0] = '\0';
+         return 1;
+      }
+   }
+   data->tlibinit = walltime() - start;
    return 0;
 }
 
@@ -140,10 +1114,11 @@ EXTRFUNC_DECL_FUNCCALL(PropsSI2)
    assert(derivrequest <= 1 || hessian  != NULL);
    assert(derivrequest <= 0 || gradient != NULL);
    assert(errorcallback != NULL);
+   poolenforce(data);
 
    if( nargs != 6 )
    {
-      sprintf(msg+1, "EnthalpyPT: one argument expected. Called with %d", nargs);
+      sprintf(msg+1, "PropsSI2: six arguments expected. Called with %d", nargs);
       msg[0] = strlen(msg+1);
       return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
    }
@@ -153,25 +1128,1034 @@ EXTRFUNC_DECL_FUNCCALL(PropsSI2)
    char* Prop2 = PROPERTY[(int)x[3]];
    double Val2 = x[4];
    char* Fluid = FLUID2[(int)x[5]];
-   *funcvalue = PropsSI(Prop, Prop1, Val1, Prop2, Val2, Fluid);
-   // calculate the first derivative with respect to pressure and temperature 
-   char* str[80]; //string template for derivatives
-   if(derivrequest>0) {
-      sprintf(str, "d(%s)/d(%s)|%s", Prop, Prop1, Prop2);
-      gradient[0] = PropsSI(str, Prop1, Val1, Prop2, Val2, Fluid);
-      sprintf(str, "d(%s)/d(%s)|%s", Prop, Prop2, Prop1);
-      gradient[1] = PropsSI("d(H)/d(T)|P", Prop1, Val1, Prop2, Val2, Fluid);
-      // calculate the hessian matrix with respect to pressure and temperature
-      if(derivrequest>1) {
-         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Prop1, Prop2, Prop1, Prop2);
-         hessian[0] = PropsSI(str, Prop1, Val1, Prop2, Val2, Fluid);
-         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Prop1, Prop2, Prop2, Prop1);
-         hessian[1] = PropsSI(str, Prop1, Val1, Prop2, Val2, Fluid);
-         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Prop2, Prop1, Prop1, Prop2);
-         hessian[2] = PropsSI(str, Prop1, Val1, Prop2, Val2, Fluid);
-         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Prop2, Prop1, Prop2, Prop1);
-         hessian[3] = PropsSI(str, Prop1, Val1, Prop2, Val2, Fluid);
+   double d[6];
+   if( evalstate(data, Prop, Prop1, Val1, Prop2, Val2, Fluid, derivrequest, d) )
+   {
+      stateerror(data, msg, "PropsSI2");
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+   *funcvalue = d[0];
+   // the derivatives belong to the endogenous arguments Value1 (x[2]) and Value2 (x[4])
+   if( derivrequest > 0 )
+   {
+      memset(gradient, 0, nargs * sizeof(double));
+      gradient[2] = d[1];
+      gradient[4] = d[2];
+      if( derivrequest > 1 )
+      {
+         memset(hessian, 0, nargs * nargs * sizeof(double));
+         hessian[2*nargs+2] = d[3];
+         hessian[2*nargs+4] = d[4];
+         hessian[4*nargs+2] = d[4];
+         hessian[4*nargs+4] = d[5];
+      }
+   }
+   return EXTRFUNC_RETURN_OK;
+}
+
+/** Returns the AbstractState handle of a fluid, creating it on first use
+ *
+ * @return handle, or -1 if the fluid index is invalid or CoolProp failed (msg is set then).
+ */
+static long fluidhandle(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   int                   fluid,           /**< index into FLUID2 */
+   char*                 msg,             /**< buffer of length EXTRFUNC_STRSIZE for error message (as Delphi string!) */
+   const char*           func             /**< name of the calling function */
+   )
+{
+   long errcode = 0;
+   char buf[EXTRFUNC_STRSIZE];
+
+   if( fluid < 0 || fluid >= MAXFLUIDS || FLUID2[fluid] == NULL || FLUID2[fluid][0] == '\0' )
+   {
+      sprintf(msg+1, "%s: unknown fluid index %d", func, fluid);
+      msg[0] = strlen(msg+1);
+      return -1;
+   }
+   if( mixtureis(FLUID2[fluid]) )
+   {
+      MIXTURE* mix = mixturefor(data, FLUID2[fluid]);
+      long handle = mix != NULL ? mixturehandle(mix, FLUID2[fluid], data->errstring) : -1;
+      if( handle < 0 )
+      {
+         stateerror(data, msg, func);
+         return -1;
+      }
+      return handle;
+   }
+   if( data->handle[fluid] < 0 )
+   {
+      size_t heap = heapused();
+      double t = walltime();
+      data->handle[fluid] = AbstractState_factory("HEOS", FLUID2[fluid], &errcode, buf, sizeof(buf));
+      if( errcode != 0 )
+      {
+         data->handle[fluid] = -1;
+         funcerror(msg, func, buf);
+         return -1;
+      }
+      data->handlemem[fluid] = heap > 0 && heapused() > heap ? heapused() - heap : POOL_FOOTPRINT;
+      data->handletime[fluid] = walltime() - t;
+      ++data->created;
+      poolmem(data);
+   }
+   data->handleuse[fluid] = data->calls;
+   return data->handle[fluid];
+}
+
+/** Returns the name of a property index
+ *
+ * @return name, or NULL if the index is not one of PROPERTY (msg is set then).
+ */
+static const char* propertyname(
+   int                   prop,            /**< index into PROPERTY */
+   char*                 msg,             /**< buffer of length EXTRFUNC_STRSIZE for error message (as Delphi string!) */
+   const char*           func             /**< name of the calling function */
+   )
+{
+   int n;
+
+   for( n = 0; n < (int)(sizeof(PROPERTY) / sizeof(PROPERTY[0])) && PROPERTY[n] != NULL && PROPERTY[n][0] != '\0'; ++n )
+      ;
+   if( prop < 0 || prop >= n )
+   {
+      sprintf(msg+1, "%s: unknown property index %d", func, prop);
+      msg[0] = strlen(msg+1);
+      return NULL;
+   }
+   return PROPERTY[prop];
+}
+
+/** Outlet state of an adiabatic compressor or turbine with given isentropic efficiency.
+ *
+ * Arguments are Prop, Pin, Tin, Pout, Eta, Fluid. The outlet enthalpy is
+ *   h2 = h1 + (h2s - h1) / Eta  for a compressor,
+ *   h2 = h1 + (h2s - h1) * Eta  for a turbine,
+ * where h2s is the enthalpy at Pout and the inlet entropy. The requested
+ * property is returned at (Pout, h2) and derivatives are assembled by the
+ * chain rule through the intermediate states.
+ */
+static EXTRFUNC_RETURN machineout(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           func,            /**< name of the extrinsic function */
+   int                   compressor,      /**< whether the machine is a compressor (or a turbine) */
+   int                   derivrequest,    /**< highest derivative requested */
+   int                   nargs,           /**< number of function arguments */
+   double                x[],             /**< function arguments */
+   double*               funcvalue,       /**< buffer to store function value */
+   double                gradient[],      /**< buffer to store gradient */
+   double                hessian[],       /**< buffer to store Hessian */
+   extrfuncLogError_t    errorcallback,   /**< error callback */
+   void*                 errorcbmem       /**< error callback memory */
+   )
+{
+   char msg[EXTRFUNC_STRSIZE];
+   JET pin, tin, pout, eta;
+   JET h1, s1, h2, dh, g, y;
+   double gf[3];
+   int i;
+
+   if( nargs != 6 )
+   {
+      sprintf(msg+1, "%s: six arguments expected. Called with %d", func, nargs);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   const char* Prop = propertyname((int)x[0], msg, func);
+   if( Prop == NULL )
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   /* fluidhandle() checks the index */
+   if( fluidhandle(data, (int)x[5], msg, func) < 0 )
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   const char* Fluid = FLUID2[(int)x[5]];
+
+   if( x[4] <= 0.0 )
+   {
+      sprintf(msg+1, "%s: isentropic efficiency must be positive. Called with %g", func, x[4]);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+
+   jetvar(&pin,  nargs, 1, x[1]);
+   jetvar(&tin,  nargs, 2, x[2]);
+   jetvar(&pout, nargs, 3, x[3]);
+   jetvar(&eta,  nargs, 4, x[4]);
+
+   // inlet state and isentropic outlet enthalpy
+   if( jetstate(data, &h1, "H", "P", &pin, "T", &tin, Fluid, derivrequest)
+      || jetstate(data, &s1, "S", "P", &pin, "T", &tin, Fluid, derivrequest)
+      || jetstate(data, &dh, "H", "P", &pout, "S", &s1, Fluid, derivrequest) )
+   {
+      stateerror(data, msg, func);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+   jetlin(&dh, 1.0, &dh, -1.0, &h1);
+
+   // actual outlet enthalpy
+   if( compressor )
+   {
+      gf[0] = 1.0 / x[4];
+      gf[1] = -gf[0] * gf[0];
+      gf[2] = -2.0 * gf[1] * gf[0];
+   }
+   else
+   {
+      gf[0] = x[4];
+      gf[1] = 1.0;
+      gf[2] = 0.0;
+   }
+   jetfunc1(&g, gf, &eta);
+   jetmul(&h2, &g, &dh);
+   jetlin(&h2, 1.0, &h1, 1.0, &h2);
+
+   // requested outlet property
+   if( strcmp(Prop, "H") == 0 )
+      y = h2;
+   else if( strcmp(Prop, "P") == 0 )
+      y = pout;
+   else if( jetstate(data, &y, Prop, "P", &pout, "H", &h2, Fluid, derivrequest) )
+   {
+      stateerror(data, msg, func);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+
+   *funcvalue = y.val;
+   if( derivrequest > 0 )
+      for( i = 0; i < nargs; ++i )
+         gradient[i] = y.grad[i];
+   if( derivrequest > 1 )
+      for( i = 0; i < nargs * nargs; ++i )
+         hessian[i] = y.hess[i];
+
+   return EXTRFUNC_RETURN_OK;
+}
+
+/** Extrinsic Function to calculate an outlet property of a compressor
+ * for given inlet pressure and temperature, outlet pressure, and isentropic efficiency
+ */
+EXTRFUNC_DECL_FUNCCALL(CompressorOut)
+{
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   return machineout(data, "CompressorOut", 1, derivrequest, nargs, x, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate an outlet property of a turbine
+ * for given inlet pressure and temperature, outlet pressure, and isentropic efficiency
+ */
+EXTRFUNC_DECL_FUNCCALL(TurbineOut)
+{
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   return machineout(data, "TurbineOut", 0, derivrequest, nargs, x, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate the minimum temperature difference (pinch)
+ * of a counter-flow heat exchanger.
+ *
+ * Arguments are ThIn, PhIn, Mh, TcIn, PcIn, Mc, Q, HotFluid, ColdFluid and
+ * optionally the number of segments N (default 20). Both streams are
+ * discretized into N segments of equal duty along the enthalpy axis. The
+ * temperatures at the N+1 segment boundaries are evaluated in one batched
+ * update per stream on the fluid's AbstractState handle. Derivatives are
+ * those of the temperature difference at the pinch point, chained through
+ * the inlet enthalpies, flows and duty.
+ */
+EXTRFUNC_DECL_FUNCCALL(HXPinch)
+{
+   char msg[EXTRFUNC_STRSIZE];
+   char buf[EXTRFUNC_STRSIZE];
+   double hh[HX_MAXSEG+1], hc[HX_MAXSEG+1];
+   double ph[HX_MAXSEG+1], pc[HX_MAXSEG+1];
+   double th[HX_MAXSEG+1], tc[HX_MAXSEG+1];
+   double rf[3];
+   long hothandle, coldhandle, errcode;
+   JET thin, phin, mh, tcin, pcin, mc, q;
+   JET hhin, hcin, qh, qc, hhk, hck, thk, tck;
+   int nseg, k, kmin, i;
+
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   if( nargs < 9 || nargs > 10 )
+   {
+      sprintf(msg+1, "HXPinch: nine or ten arguments expected. Called with %d", nargs);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   nseg = nargs > 9 ? (int)x[9] : 20;
+   if( nseg < 1 || nseg > HX_MAXSEG )
+   {
+      sprintf(msg+1, "HXPinch: number of segments must be between 1 and %d. Called with %d", HX_MAXSEG, nseg);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   if( x[2] <= 0.0 || x[5] <= 0.0 )
+   {
+      sprintf(msg+1, "HXPinch: mass flows must be positive. Called with %g and %g", x[2], x[5]);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+   /* fluidhandle() checks the indices */
+   if( (hothandle = fluidhandle(data, (int)x[7], msg, "HXPinch")) < 0
+      || (coldhandle = fluidhandle(data, (int)x[8], msg, "HXPinch")) < 0 )
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   const char* HotFluid = FLUID2[(int)x[7]];
+   const char* ColdFluid = FLUID2[(int)x[8]];
+
+   // inlet enthalpies; the hot inlet is at segment boundary 0, the cold inlet at boundary nseg
+   double hhinval, hcinval, d[6];
+   if( evalstate(data, "H", "P", x[1], "T", x[0], HotFluid, 0, d) == 0 )
+      hhinval = d[0];
+   else
+   {
+      stateerror(data, msg, "HXPinch");
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+   if( evalstate(data, "H", "P", x[4], "T", x[3], ColdFluid, 0, d) == 0 )
+      hcinval = d[0];
+   else
+   {
+      stateerror(data, msg, "HXPinch");
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+   for( k = 0; k <= nseg; ++k )
+   {
+      double frac = (double)k / nseg;
+      hh[k] = hhinval - frac * x[6] / x[2];
+      hc[k] = hcinval + (1.0 - frac) * x[6] / x[5];
+      ph[k] = x[1];
+      pc[k] = x[4];
+   }
+
+   // temperature profiles of both streams
+   errcode = 0;
+   AbstractState_update_and_1_out(hothandle, get_input_pair_index("HmassP_INPUTS"), hh, ph, nseg+1,
+      get_param_index("T"), th, &errcode, buf, sizeof(buf));
+   if( errcode == 0 )
+      AbstractState_update_and_1_out(coldhandle, get_input_pair_index("HmassP_INPUTS"), hc, pc, nseg+1,
+         get_param_index("T"), tc, &errcode, buf, sizeof(buf));
+   if( errcode != 0 )
+   {
+      funcerror(msg, "HXPinch", buf);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+
+   kmin = 0;
+   for( k = 1; k <= nseg; ++k )
+      if( th[k] - tc[k] < th[kmin] - tc[kmin] )
+         kmin = k;
+   *funcvalue = th[kmin] - tc[kmin];
+
+   if( derivrequest == 0 )
+      return EXTRFUNC_RETURN_OK;
+
+   // derivatives of the temperature difference at the pinch point
+   double frac = (double)kmin / nseg;
+   jetvar(&thin, nargs, 0, x[0]);
+   jetvar(&phin, nargs, 1, x[1]);
+   jetvar(&mh,   nargs, 2, x[2]);
+   jetvar(&tcin, nargs, 3, x[3]);
+   jetvar(&pcin, nargs, 4, x[4]);
+   jetvar(&mc,   nargs, 5, x[5]);
+   jetvar(&q,    nargs, 6, x[6]);
+
+   rf[0] = 1.0 / x[2];
+   rf[1] = -rf[0] * rf[0];
+   rf[2] = -2.0 * rf[1] * rf[0];
+   jetfunc1(&qh, rf, &mh);
+   jetmul(&qh, &q, &qh);
+   rf[0] = 1.0 / x[5];
+   rf[1] = -rf[0] * rf[0];
+   rf[2] = -2.0 * rf[1] * rf[0];
+   jetfunc1(&qc, rf, &mc);
+   jetmul(&qc, &q, &qc);
+
+   if( jetstate(data, &hhin, "H", "P", &phin, "T", &thin, HotFluid, derivrequest)
+      || jetstate(data, &hcin, "H", "P", &pcin, "T", &tcin, ColdFluid, derivrequest) )
+   {
+      stateerror(data, msg, "HXPinch");
+      return errorcallback(EXTRFUNC_RETURN_GRADIENT, EXTRFUNC_EVALERROR_SINGULAR, msg, errorcbmem);
+   }
+   jetlin(&hhk, 1.0, &hhin, -frac, &qh);
+   jetlin(&hck, 1.0, &hcin, 1.0 - frac, &qc);
+   if( jetstate(data, &thk, "T", "P", &phin, "H", &hhk, HotFluid, derivrequest)
+      || jetstate(data, &tck, "T", "P", &pcin, "H", &hck, ColdFluid, derivrequest) )
+   {
+      stateerror(data, msg, "HXPinch");
+      return errorcallback(EXTRFUNC_RETURN_GRADIENT, EXTRFUNC_EVALERROR_SINGULAR, msg, errorcbmem);
+   }
+   jetlin(&thk, 1.0, &thk, -1.0, &tck);
+
+   for( i = 0; i < nargs; ++i )
+      gradient[i] = thk.grad[i];
+   if( derivrequest > 1 )
+      for( i = 0; i < nargs * nargs; ++i )
+         hessian[i] = thk.hess[i];
+
+   return EXTRFUNC_RETURN_OK;
+}
+
+/** Brings the handle to the saturated state at given pressure and quality
+ *
+ * The saturation ancillary provides the initial temperature, which is
+ * refined by Newton steps along the saturation curve, each costing one
+ * Q-T flash and one saturation derivative.
+ *
+ * @return 0 if successful, <> 0 otherwise (buf holds the CoolProp message then).
+ */
+static int saturatep(
+   long                  handle,          /**< AbstractState handle of the fluid */
+   const char*           Fluid,           /**< fluid name */
+   double                Q,               /**< quality, 0 or 1 */
+   double                P,               /**< pressure */
+   char*                 buf,             /**< buffer of length EXTRFUNC_STRSIZE for error message */
+   long*                 errcode          /**< buffer for CoolProp error code */
+   )
+{
+   long qt = get_input_pair_index("QT_INPUTS");
+   long ip = get_param_index("P");
+   long it = get_param_index("T");
+   double T, p, dpdT;
+   int iter;
+
+   T = saturation_ancillary(Fluid, "T", (int)Q, "P", P);
+   for( iter = 0; iter < SAT_MAXITER && isfinite(T); ++iter )
+   {
+      *errcode = 0;
+      AbstractState_update(handle, qt, Q, T, errcode, buf, EXTRFUNC_STRSIZE);
+      if( *errcode != 0 )
+         break;
+      p = AbstractState_keyed_output(handle, ip, errcode, buf, EXTRFUNC_STRSIZE);
+      if( *errcode != 0 )
+         break;
+      if( fabs(p - P) <= SAT_RELTOL * P )
+         return 0;
+      dpdT = AbstractState_first_saturation_deriv(handle, ip, it, errcode, buf, EXTRFUNC_STRSIZE);
+      if( *errcode != 0 || dpdT <= 0.0 )
+         break;
+      T -= (p - P) / dpdT;
+   }
+
+   *errcode = 0;
+   AbstractState_update(handle, get_input_pair_index("PQ_INPUTS"), P, Q, errcode, buf, EXTRFUNC_STRSIZE);
+   return *errcode != 0;
+}
+
+/** Evaluates a property of the saturated liquid or vapour and its derivatives
+ * along the saturation curve with respect to the input (pressure or temperature).
+ *
+ * Fluids with saturation expansions are evaluated from these, derivatives
+ * included. Otherwise, first derivatives come from
+ * AbstractState_first_saturation_deriv, and second derivatives are
+ * central differences of these in temperature.
+ */
+static EXTRFUNC_RETURN satprop(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           func,            /**< name of the extrinsic function */
+   int                   prop,            /**< output property, index into PROPERTY */
+   double                Q,               /**< quality, 0 or 1 */
+   int                   input,           /**< input property, index into PROPERTY (P or T) */
+   double                value,           /**< input value */
+   int                   fluid,           /**< fluid, index into FLUID2 */
+   int                   pos,             /**< argument position of the input value */
+   int                   derivrequest,    /**< highest derivative requested */
+   int                   nargs,           /**< number of function arguments */
+   double*               funcvalue,       /**< buffer to store function value */
+   double                gradient[],      /**< buffer to store gradient */
+   double                hessian[],       /**< buffer to store Hessian */
+   extrfuncLogError_t    errorcallback,   /**< error callback */
+   void*                 errorcbmem       /**< error callback memory */
+   )
+{
+   char msg[EXTRFUNC_STRSIZE];
+   char buf[EXTRFUNC_STRSIZE];
+   const char* Prop;
+   const char* Input;
+   long handle, errcode = 0;
+   long qt = get_input_pair_index("QT_INPUTS");
+   long ip = get_param_index("P");
+   long it = get_param_index("T");
+   long iof, iwrt;
+   double T = value, dydx = 1.0, dpdT = 1.0;
+   double d[6];
+
+   if( Q != 0.0 && Q != 1.0 )
+   {
+      sprintf(msg+1, "%s: quality must be 0 or 1. Called with %g", func, Q);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   if( (Prop = propertyname(prop, msg, func)) == NULL || (Input = propertyname(input, msg, func)) == NULL )
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   if( strcmp(Input, "P") != 0 && strcmp(Input, "T") != 0 )
+   {
+      sprintf(msg+1, "%s: input must be pressure or temperature. Called with %s", func, Input);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   if( fluid >= 0 && fluid < MAXFLUIDS && FLUID2[fluid] != NULL
+      && chebstate(Prop, Input, value, "Q", Q, FLUID2[fluid], d) == 0 )
+   {
+      *funcvalue = d[0];
+      if( derivrequest > 0 )
+      {
+         memset(gradient, 0, nargs * sizeof(double));
+         gradient[pos] = d[1];
+      }
+      if( derivrequest > 1 )
+      {
+         memset(hessian, 0, nargs * nargs * sizeof(double));
+         hessian[pos*nargs+pos] = d[3];
+      }
+      return EXTRFUNC_RETURN_OK;
+   }
+   if( (handle = fluidhandle(data, fluid, msg, func)) < 0 )
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+
+   if( input == 0 )
+   {
+      if( saturatep(handle, FLUID2[fluid], Q, value, buf, &errcode) == 0 )
+         T = AbstractState_keyed_output(handle, it, &errcode, buf, sizeof(buf));
+   }
+   else
+   {
+      T = value;
+      AbstractState_update(handle, qt, Q, T, &errcode, buf, sizeof(buf));
+   }
+   iof = get_param_index(Prop);
+   iwrt = get_param_index(Input);
+   if( errcode == 0 )
+      *funcvalue = prop == input ? value : AbstractState_keyed_output(handle, iof, &errcode, buf, sizeof(buf));
+   if( errcode == 0 && derivrequest > 0 && prop != input )
+   {
+      dydx = AbstractState_first_saturation_deriv(handle, iof, iwrt, &errcode, buf, sizeof(buf));
+      if( errcode == 0 && input == 0 )
+         dpdT = AbstractState_first_saturation_deriv(handle, ip, it, &errcode, buf, sizeof(buf));
+   }
+   if( errcode != 0 )
+   {
+      funcerror(msg, func, buf);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+
+   if( derivrequest > 0 )
+   {
+      memset(gradient, 0, nargs * sizeof(double));
+      gradient[pos] = dydx;
+   }
+   if( derivrequest > 1 )
+   {
+      double h = 1e-6 * T;
+      double dydxp = 0.0, dydxm = 0.0;
+
+      memset(hessian, 0, nargs * nargs * sizeof(double));
+      if( prop != input )
+      {
+         AbstractState_update(handle, qt, Q, T + h, &errcode, buf, sizeof(buf));
+         if( errcode == 0 )
+            dydxp = AbstractState_first_saturation_deriv(handle, iof, iwrt, &errcode, buf, sizeof(buf));
+         if( errcode == 0 )
+            AbstractState_update(handle, qt, Q, T - h, &errcode, buf, sizeof(buf));
+         if( errcode == 0 )
+            dydxm = AbstractState_first_saturation_deriv(handle, iof, iwrt, &errcode, buf, sizeof(buf));
+         if( errcode != 0 )
+         {
+            funcerror(msg, func, buf);
+            return errorcallback(EXTRFUNC_RETURN_HESSIAN, EXTRFUNC_EVALERROR_SINGULAR, msg, errorcbmem);
+         }
+         // d2y/dP2 = d/dT(dy/dP) / (dP/dT) along the saturation curve
+         hessian[pos*nargs+pos] = (dydxp - dydxm) / (2.0 * h) / dpdT;
+      }
+   }
+
+   return EXTRFUNC_RETURN_OK;
+}
+
+/** Extrinsic Function to calculate the saturation temperature for given pressure */
+EXTRFUNC_DECL_FUNCCALL(Tsat)
+{
+   char msg[EXTRFUNC_STRSIZE];
+
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   if( nargs != 2 )
+   {
+      sprintf(msg+1, "Tsat: two arguments expected. Called with %d", nargs);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   return satprop(data, "Tsat", 1, 0.0, 0, x[0], (int)x[1], 0, derivrequest, nargs, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate the saturation pressure for given temperature */
+EXTRFUNC_DECL_FUNCCALL(Psat)
+{
+   char msg[EXTRFUNC_STRSIZE];
+
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   if( nargs != 2 )
+   {
+      sprintf(msg+1, "Psat: two arguments expected. Called with %d", nargs);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   return satprop(data, "Psat", 0, 0.0, 1, x[0], (int)x[1], 0, derivrequest, nargs, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate a property of the saturated liquid (Q=0)
+ * or vapour (Q=1) for given saturation pressure or temperature
+ */
+EXTRFUNC_DECL_FUNCCALL(SatProp)
+{
+   char msg[EXTRFUNC_STRSIZE];
+
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   if( nargs != 5 )
+   {
+      sprintf(msg+1, "SatProp: five arguments expected. Called with %d", nargs);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   return satprop(data, "SatProp", (int)x[0], x[1], (int)x[2], x[3], (int)x[4], 3, derivrequest, nargs, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+enum { DERIVED_EXERGY, DERIVED_ISENTROPICEXP, DERIVED_HEATCAPRATIO, DERIVED_JOULETHOMSON };
+
+/** Evaluates a derived property and its derivatives with respect to temperature and density
+ *
+ * The handle must be at the state. Everything is assembled from one flash:
+ * second derivatives of the pressure in temperature and density follow from
+ * the derivatives of cv and the speed of sound, using
+ * (dcv/drho)_T = -T/rho^2 (d2p/dT2)_rho and c^2 = cp/cv (dp/drho)_T.
+ *
+ * @return 0 if successful, <> 0 if CoolProp failed (buf is set then).
+ */
+static int derivedstate(
+   long                  handle,          /**< AbstractState handle at the state */
+   int                   which,           /**< derived property (DERIVED_*) */
+   double                T0,              /**< dead state temperature (exergy only) */
+   double                h0,              /**< dead state enthalpy (exergy only) */
+   double                s0,              /**< dead state entropy (exergy only) */
+   double                q[3],            /**< buffer for value, d/dT at constant rho, d/drho at constant T */
+   char*                 buf              /**< buffer of length EXTRFUNC_STRSIZE for error message */
+   )
+{
+   long it = get_param_index("T");
+   long ir = get_param_index("Dmass");
+   long errcode = 0;
+
+#define KEYED(name)        (errcode == 0 ? AbstractState_keyed_output(handle, get_param_index(name), &errcode, buf, EXTRFUNC_STRSIZE) : 0.0)
+#define PARTIAL(name, a, b) (errcode == 0 ? AbstractState_first_partial_deriv(handle, get_param_index(name), a, b, &errcode, buf, EXTRFUNC_STRSIZE) : 0.0)
+   if( which == DERIVED_EXERGY )
+   {
+      double h = KEYED("Hmass");
+      double s = KEYED("Smass");
+
+      q[0] = h - h0 - T0 * (s - s0);
+      q[1] = PARTIAL("Hmass", it, ir) - T0 * PARTIAL("Smass", it, ir);
+      q[2] = PARTIAL("Hmass", ir, it) - T0 * PARTIAL("Smass", ir, it);
+   }
+   else
+   {
+      double T = KEYED("T");
+      double r = KEYED("Dmass");
+      double p = KEYED("P");
+      double cp = KEYED("Cpmass");
+      double cv = KEYED("Cvmass");
+      double c = KEYED("speed_of_sound");
+      double p_T = PARTIAL("P", it, ir);
+      double p_r = PARTIAL("P", ir, it);
+      double cp_T = PARTIAL("Cpmass", it, ir);
+      double cp_r = PARTIAL("Cpmass", ir, it);
+      double cv_T = PARTIAL("Cvmass", it, ir);
+      double cv_r = PARTIAL("Cvmass", ir, it);
+      double c_T = PARTIAL("speed_of_sound", it, ir);
+      double c_r = PARTIAL("speed_of_sound", ir, it);
+      double g, g_T, g_r;
+
+      if( errcode != 0 )
+         return 1;
+      g = cp / cv;
+      g_T = (cp_T * cv - cp * cv_T) / (cv * cv);
+      g_r = (cp_r * cv - cp * cv_r) / (cv * cv);
+
+      if( which == DERIVED_ISENTROPICEXP )
+      {
+         // kappa = rho c^2 / p
+         q[0] = r * c * c / p;
+         q[1] = 2.0 * r * c * c_T / p - q[0] * p_T / p;
+         q[2] = (c * c + 2.0 * r * c * c_r) / p - q[0] * p_r / p;
+      }
+      else if( which == DERIVED_HEATCAPRATIO )
+      {
+         q[0] = g;
+         q[1] = g_T;
+         q[2] = g_r;
+      }
+      else
+      {
+         // mu = -(dh/dp)_T / cp with (dh/dp)_T = 1/rho - T (dp/dT)_rho / (rho^2 (dp/drho)_T)
+         double p_TT = -r * r * cv_r / T;
+         double p_Tr = (2.0 * c * c_T - p_r * g_T) / g;
+         double p_rr = (2.0 * c * c_r - p_r * g_r) / g;
+         double a = 1.0 / r - T * p_T / (r * r * p_r);
+         double a_T = -(p_T + T * p_TT) / (r * r * p_r) + T * p_T * p_Tr / (r * r * p_r * p_r);
+         double a_r = -1.0 / (r * r) - T * (p_Tr / (r * r * p_r) - 2.0 * p_T / (r * r * r * p_r) - p_T * p_rr / (r * r * p_r * p_r));
+
+         q[0] = -a / cp;
+         q[1] = -a_T / cp + a * cp_T / (cp * cp);
+         q[2] = -a_r / cp + a * cp_r / (cp * cp);
+      }
+   }
+#undef KEYED
+#undef PARTIAL
+   return errcode != 0 || !isfinite(q[0]) || !isfinite(q[1]) || !isfinite(q[2]);
+}
+
+/** Evaluates a derived property at a state and its gradient with respect to the two state inputs
+ *
+ * @return 0 if successful, <> 0 if CoolProp failed (buf is set then).
+ */
+static int derivedgrad(
+   long                  handle,          /**< AbstractState handle */
+   long                  pair,            /**< CoolProp input pair */
+   int                   swap,            /**< whether the values are in reverse order of the pair */
+   long                  wrt1,            /**< parameter index of the first input */
+   long                  wrt2,            /**< parameter index of the second input */
+   double                Val1,            /**< first input value */
+   double                Val2,            /**< second input value */
+   int                   which,           /**< derived property (DERIVED_*) */
+   double                T0,              /**< dead state temperature (exergy only) */
+   double                h0,              /**< dead state enthalpy (exergy only) */
+   double                s0,              /**< dead state entropy (exergy only) */
+   int                   derivrequest,    /**< whether to compute the gradient */
+   double                y[3],            /**< buffer for value, d/dValue1, d/dValue2 */
+   char*                 buf              /**< buffer of length EXTRFUNC_STRSIZE for error message */
+   )
+{
+   long it = get_param_index("T");
+   long ir = get_param_index("Dmass");
+   long errcode = 0;
+   double q[3];
+
+   AbstractState_update(handle, pair, swap ? Val2 : Val1, swap ? Val1 : Val2, &errcode, buf, EXTRFUNC_STRSIZE);
+   if( errcode != 0 || derivedstate(handle, which, T0, h0, s0, q, buf) )
+      return 1;
+   y[0] = q[0];
+   y[1] = y[2] = 0.0;
+   if( derivrequest > 0 )
+   {
+      // chain rule through temperature and density
+      double T_1 = AbstractState_first_partial_deriv(handle, it, wrt1, wrt2, &errcode, buf, EXTRFUNC_STRSIZE);
+      double T_2 = errcode == 0 ? AbstractState_first_partial_deriv(handle, it, wrt2, wrt1, &errcode, buf, EXTRFUNC_STRSIZE) : 0.0;
+      double r_1 = errcode == 0 ? AbstractState_first_partial_deriv(handle, ir, wrt1, wrt2, &errcode, buf, EXTRFUNC_STRSIZE) : 0.0;
+      double r_2 = errcode == 0 ? AbstractState_first_partial_deriv(handle, ir, wrt2, wrt1, &errcode, buf, EXTRFUNC_STRSIZE) : 0.0;
+
+      if( errcode != 0 )
+         return 1;
+      y[1] = q[1] * T_1 + q[2] * r_1;
+      y[2] = q[1] * T_2 + q[2] * r_2;
+   }
+   return 0;
+}
+
+/** Common implementation of the derived property functions
+ *
+ * The arguments are Prop1 Value1 Prop2 Value2 as for PropsSI2, followed by
+ * the dead state T0 P0 for the exergy, and the fluid. Value and gradient
+ * come from one flash on the fluid's handle; the Hessian is computed by
+ * central differences of the gradient.
+ */
+static EXTRFUNC_RETURN derivedprop(
+   EXTRFUNC_DATA*        data,            /**< function library data structure */
+   const char*           func,            /**< name of the extrinsic function */
+   int                   which,           /**< derived property (DERIVED_*) */
+   int                   derivrequest,    /**< highest derivative requested */
+   int                   nargs,           /**< number of function arguments */
+   double                x[],             /**< function arguments */
+   double*               funcvalue,       /**< buffer to store function value */
+   double                gradient[],      /**< buffer to store gradient */
+   double                hessian[],       /**< buffer to store Hessian */
+   extrfuncLogError_t    errorcallback,   /**< error callback */
+   void*                 errorcbmem       /**< error callback memory */
+   )
+{
+   char msg[EXTRFUNC_STRSIZE];
+   char buf[EXTRFUNC_STRSIZE];
+   int expected = which == DERIVED_EXERGY ? 7 : 5;
+   double T0 = 0.0, h0 = 0.0, s0 = 0.0;
+   double y[3];
+   long handle, pair, wrt1, wrt2;
+   int swap, fluid;
+
+   if( nargs != expected )
+   {
+      sprintf(msg+1, "%s: %d arguments expected. Called with %d", func, expected, nargs);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   const char* Prop1 = propertyname((int)x[0], msg, func);
+   const char* Prop2 = Prop1 != NULL ? propertyname((int)x[2], msg, func) : NULL;
+   if( Prop2 == NULL )
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   fluid = (int)x[nargs-1];
+   if( (pair = inputpair(Prop1, Prop2, &swap)) < 0 )
+   {
+      sprintf(msg+1, "%s: %s and %s are no CoolProp input pair", func, Prop1, Prop2);
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   wrt1 = get_param_index(Prop1);
+   wrt2 = get_param_index(Prop2);
+
+   // the dead state is exogenous, so its enthalpy and entropy come from the state cache
+   if( which == DERIVED_EXERGY )
+   {
+      double d[6];
+
+      T0 = x[4];
+      // validates the fluid index
+      if( (handle = fluidhandle(data, fluid, msg, func)) < 0 )
+         return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+      if( evalstate(data, "H", "P", x[5], "T", T0, FLUID2[fluid], 0, d) )
+      {
+         stateerror(data, msg, func);
+         return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+      }
+      h0 = d[0];
+      if( evalstate(data, "S", "P", x[5], "T", T0, FLUID2[fluid], 0, d) )
+      {
+         stateerror(data, msg, func);
+         return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+      }
+      s0 = d[0];
+   }
+   // for mixtures, this also sets the fractions again after the dead state
+   if( (handle = fluidhandle(data, fluid, msg, func)) < 0 )
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+
+   if( derivedgrad(handle, pair, swap, wrt1, wrt2, x[1], x[3], which, T0, h0, s0, derivrequest, y, buf) )
+   {
+      funcerror(msg, func, buf);
+      return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+   }
+   *funcvalue = y[0];
+   if( derivrequest > 0 )
+   {
+      memset(gradient, 0, nargs * sizeof(double));
+      gradient[1] = y[1];
+      gradient[3] = y[2];
+   }
+   if( derivrequest > 1 )
+   {
+      double h1 = 1e-6 * fabs(x[1]) + 1e-9;
+      double h3 = 1e-6 * fabs(x[3]) + 1e-9;
+      double yp1[3], ym1[3], yp3[3], ym3[3];
+
+      memset(hessian, 0, nargs * nargs * sizeof(double));
+      if( derivedgrad(handle, pair, swap, wrt1, wrt2, x[1] + h1, x[3], which, T0, h0, s0, 1, yp1, buf)
+         || derivedgrad(handle, pair, swap, wrt1, wrt2, x[1] - h1, x[3], which, T0, h0, s0, 1, ym1, buf)
+         || derivedgrad(handle, pair, swap, wrt1, wrt2, x[1], x[3] + h3, which, T0, h0, s0, 1, yp3, buf)
+         || derivedgrad(handle, pair, swap, wrt1, wrt2, x[1], x[3] - h3, which, T0, h0, s0, 1, ym3, buf) )
+      {
+         funcerror(msg, func, buf);
+         return errorcallback(EXTRFUNC_RETURN_HESSIAN, EXTRFUNC_EVALERROR_SINGULAR, msg, errorcbmem);
+      }
+      hessian[1*nargs+1] = (yp1[1] - ym1[1]) / (2.0 * h1);
+      hessian[3*nargs+3] = (yp3[2] - ym3[2]) / (2.0 * h3);
+      hessian[1*nargs+3] = hessian[3*nargs+1] = 0.5 * ((yp3[1] - ym3[1]) / (2.0 * h3) + (yp1[2] - ym1[2]) / (2.0 * h1));
+   }
+   return EXTRFUNC_RETURN_OK;
+}
+
+/** Extrinsic Function to calculate the specific flow exergy h - h0 - T0 (s - s0)
+ * for given state and dead state temperature and pressure
+ */
+EXTRFUNC_DECL_FUNCCALL(Exergy)
+{
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   return derivedprop(data, "Exergy", DERIVED_EXERGY, derivrequest, nargs, x, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate the isentropic exponent rho c^2 / p for given state */
+EXTRFUNC_DECL_FUNCCALL(IsentropicExp)
+{
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   return derivedprop(data, "IsentropicExp", DERIVED_ISENTROPICEXP, derivrequest, nargs, x, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate the heat capacity ratio cp/cv for given state */
+EXTRFUNC_DECL_FUNCCALL(HeatCapRatio)
+{
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   return derivedprop(data, "HeatCapRatio", DERIVED_HEATCAPRATIO, derivrequest, nargs, x, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Extrinsic Function to calculate the Joule-Thomson coefficient (dT/dp)_h for given state */
+EXTRFUNC_DECL_FUNCCALL(JouleThomson)
+{
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   return derivedprop(data, "JouleThomson", DERIVED_JOULETHOMSON, derivrequest, nargs, x, funcvalue, gradient, hessian, errorcallback, errorcbmem);
+}
+
+/** Control function of multi-fidelity evaluation (see enginefidelity())
+ *
+ * Mode 1 evaluates all states by the full equation of state from now on,
+ * e.g. in a final polishing solve; Mode 0 returns to multi-fidelity
+ * evaluation. Returns the previous mode.
+ */
+EXTRFUNC_DECL_FUNCCALL(PropsSIFidelity)
+{
+   char msg[EXTRFUNC_STRSIZE];
+
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   if( nargs != 1 || (x[0] != 0.0 && x[0] != 1.0) )
+   {
+      sprintf(msg+1, "PropsSIFidelity: one argument (0 or 1) expected.");
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   *funcvalue = enginepolish((int)x[0]);
+   return EXTRFUNC_RETURN_OK;
+}
+
+/** Lower (Side 0) or upper (Side 1) bound of a property over a box of the two state inputs (see evalbounds())
+ *
+ * Meant to derive variable bounds before a solve; lower and upper bound
+ * of the same box are computed together.
+ */
+EXTRFUNC_DECL_FUNCCALL(PropsSIBound)
+{
+   char msg[EXTRFUNC_STRSIZE];
+   int nthreads = 1;
+   int failed;
+
+   assert(data != NULL);
+   assert(x != NULL);
+   assert(funcvalue != NULL);
+   assert(derivrequest <= 2);
+   assert(derivrequest <= 1 || hessian  != NULL);
+   assert(derivrequest <= 0 || gradient != NULL);
+   assert(errorcallback != NULL);
+   poolenforce(data);
+
+   if( nargs != 9 || (x[8] != 0.0 && x[8] != 1.0) )
+   {
+      sprintf(msg+1, "PropsSIBound: nine arguments expected, the last one 0 (lower) or 1 (upper).");
+      msg[0] = strlen(msg+1);
+      return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+   }
+   if( !data->boundvalid || memcmp(data->boundbox, x, sizeof(data->boundbox)) != 0 )
+   {
+      const char* Prop = propertyname((int)x[0], msg, "PropsSIBound");
+      const char* Prop1 = Prop != NULL ? propertyname((int)x[1], msg, "PropsSIBound") : NULL;
+      const char* Prop2 = Prop1 != NULL ? propertyname((int)x[4], msg, "PropsSIBound") : NULL;
+      const char* Fluid;
+
+      if( Prop2 == NULL )
+         return errorcallback(EXTRFUNC_RETURN_SYSTEM, EXTRFUNC_EVALERROR_NONE, msg, errorcbmem);
+      /* fluidhandle() checks the index */
+      if( fluidhandle(data, (int)x[7], msg, "PropsSIBound") < 0 )
+         return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
+      Fluid = FLUID2[(int)x[7]];
+
+#if !defined(_WIN32)
+      nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      data->boundvalid = 0;
+      if( evalbounds(Prop, Prop1, x[2], x[3], Prop2, x[5], x[6], Fluid, nthreads, data->bounds, &failed, data->errstring) != 0 )
+      {
+         stateerror(data, msg, "PropsSIBound");
+         return errorcallback(EXTRFUNC_RETURN_FUNCTION, EXTRFUNC_EVALERROR_DOMAIN, msg, errorcbmem);
       }
+      memcpy(data->boundbox, x, sizeof(data->boundbox));
+      data->boundvalid = 1;
    }
+   *funcvalue = data->bounds[(int)x[8]];
    return EXTRFUNC_RETURN_OK;
 }
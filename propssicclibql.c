@@ -32,7 +32,7 @@ EXTRFUNC_API int EXTRFUNC_CALLCONV querylibrary(
             break;
 
          case EXTRFUNC_LIBQUERY_NFUNCTIONS :
-            *iv = 1;
+            *iv = 13;
             *pv = "Test cases for the extrinsic CoolProp library functions";
             break;
 
@@ -89,7 +89,7 @@ EXTRFUNC_API int EXTRFUNC_CALLCONV querylibrary(
                break;
 
             case EXTRFUNC_FUNCQUERY_MAXDERIV :
-               *iv = 0;
+               *iv = 2;
                *pv = NULL;
                break;
 
@@ -121,6 +121,822 @@ EXTRFUNC_API int EXTRFUNC_CALLCONV querylibrary(
                return EXTRFUNC_QUERYRETURN_ERROR;
          }
          break;
+      case 2:  /* CompressorOut */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "CompressorOut";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Outlet property of a compressor with isentropic efficiency";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 6;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 6;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "Pin";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 1;
+               *pv = "Tin";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Pout";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 1;
+               *pv = "Eta";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG06 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 3:  /* TurbineOut */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "TurbineOut";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Outlet property of a turbine with isentropic efficiency";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 6;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 6;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "Pin";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 1;
+               *pv = "Tin";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Pout";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 1;
+               *pv = "Eta";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG06 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 4:  /* HXPinch */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "HXPinch";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Minimum temperature difference of a counter-flow heat exchanger";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 9;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 10;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 1;
+               *pv = "ThIn";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "PhIn";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 1;
+               *pv = "Mh";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "TcIn";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 1;
+               *pv = "PcIn";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG06 :
+               *iv = 1;
+               *pv = "Mc";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG07 :
+               *iv = 1;
+               *pv = "Q";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG08 :
+               *iv = 0;
+               *pv = "HotFluid";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG09 :
+               *iv = 0;
+               *pv = "ColdFluid";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG10 :
+               *iv = 0;
+               *pv = "N";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 5:  /* Tsat */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "Tsat";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Saturation temperature for given pressure";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 1;
+               *pv = "P";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 6:  /* Psat */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "Psat";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Saturation pressure for given temperature";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 1;
+               *pv = "T";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 7:  /* SatProp */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "SatProp";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Property of saturated liquid (Q=0) or vapour (Q=1)";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 0;
+               *pv = "Q";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 0;
+               *pv = "Input";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Value";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 8:  /* Exergy */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "Exergy";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Specific flow exergy h - h0 - T0 (s - s0) for given state and dead state";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 7;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 7;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "Value1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 0;
+               *pv = "Prop2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Value2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 0;
+               *pv = "T0";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG06 :
+               *iv = 0;
+               *pv = "P0";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG07 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 9:  /* IsentropicExp */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "IsentropicExp";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Isentropic exponent rho c^2 / p";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "Value1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 0;
+               *pv = "Prop2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Value2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 10:  /* HeatCapRatio */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "HeatCapRatio";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Ratio of isobaric and isochoric heat capacities cp/cv";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "Value1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 0;
+               *pv = "Prop2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Value2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 11:  /* JouleThomson */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "JouleThomson";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Joule-Thomson coefficient (dT/dp) at constant enthalpy";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 5;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 2;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 1;
+               *pv = "Value1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 0;
+               *pv = "Prop2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 1;
+               *pv = "Value2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 12:  /* PropsSIFidelity */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "PropsSIFidelity";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Full equation of state for all states (Mode 1, e.g. before a final solve) or multi-fidelity anew (Mode 0)";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Mode";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
+      case 13:  /* PropsSIBound */
+         switch( (EXTRFUNC_FUNCQUERY)query )
+         {
+            case EXTRFUNC_FUNCQUERY_FUNCNAME :
+               *iv = 0;
+               *pv = "PropsSIBound";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_FUNCDESCR :
+               *iv = 0;
+               *pv = "Sampled lower (Side 0) or upper (Side 1) bound of a property over a box of the two inputs";
+               break;
+
+            case EXTRFUNC_FUNCQUERY_NOTINEQU :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_CONTINDERIV :
+               *iv = 1;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ZERORIPPLE :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMIN :
+               *iv = 9;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARGMAX :
+               *iv = 9;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_MAXDERIV :
+               *iv = 0;
+               *pv = NULL;
+               break;
+
+            case EXTRFUNC_FUNCQUERY_ARG01 :
+               *iv = 0;
+               *pv = "Prop";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG02 :
+               *iv = 0;
+               *pv = "Prop1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG03 :
+               *iv = 0;
+               *pv = "Lo1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG04 :
+               *iv = 0;
+               *pv = "Hi1";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG05 :
+               *iv = 0;
+               *pv = "Prop2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG06 :
+               *iv = 0;
+               *pv = "Lo2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG07 :
+               *iv = 0;
+               *pv = "Hi2";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG08 :
+               *iv = 0;
+               *pv = "Fluid";
+               break;
+            case EXTRFUNC_FUNCQUERY_ARG09 :
+               *iv = 0;
+               *pv = "Side";
+               break;
+            default :
+               return EXTRFUNC_QUERYRETURN_ERROR;
+         }
+         break;
       default:
          return EXTRFUNC_QUERYRETURN_ERROR;
    }
@@ -0,0 +1,583 @@
+/** Chebyshev expansions of the saturation curves of pure fluids
+ *
+ * See propssicheb.h.
+ *
+ * States are evaluated on jets in the two state inputs: everything along
+ * the saturation curve is a function of the saturation input (T or P)
+ * only, and the quality couples it with the other input by the lever
+ * rule. All functions of the curve share the Chebyshev basis of the
+ * temperature, which is computed once per state.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "propssiengine.h"
+#include "propssicheb.h"
+
+#define CHEB_MAGIC         "PSCHEB01"
+#define CHEB_ORDER         0x01020304
+#define CHEB_MAXINTERVALS  65536
+#define CHEB_PI            3.14159265358979323846
+
+/* distance of the quality to 0 and 1 below which a state is left to CoolProp */
+#define CHEB_QMARGIN       1e-9
+
+CHEBSTATS chebstats;
+
+static CHEBCURVE* curves = NULL;
+static int ncurves = 0;
+
+double chebnode(
+   int                   j,
+   int                   degree
+   )
+{
+   return cos(CHEB_PI * j / degree);
+}
+
+void chebinterp(
+   const double*         values,
+   int                   degree,
+   double*               coef
+   )
+{
+   int j, k;
+
+   for( k = 0; k <= degree; ++k )
+   {
+      double s = 0.5 * (values[0] + (k % 2 == 0 ? values[degree] : -values[degree]));
+      for( j = 1; j < degree; ++j )
+         s += values[j] * cos(CHEB_PI * j * k / degree);
+      coef[k] = 2.0 * s / degree;
+   }
+   coef[0] *= 0.5;
+   coef[degree] *= 0.5;
+}
+
+/** Chebyshev polynomials T_k and their first and second derivatives at t, k = 0..degree */
+static void basis(
+   int                   degree,
+   double                t,
+   double*               b0,
+   double*               b1,
+   double*               b2
+   )
+{
+   int k;
+
+   b0[0] = 1.0; b1[0] = 0.0; b2[0] = 0.0;
+   b0[1] = t;   b1[1] = 1.0; b2[1] = 0.0;
+   for( k = 1; k < degree; ++k )
+   {
+      b0[k+1] = 2.0 * t * b0[k] - b0[k-1];
+      b1[k+1] = 2.0 * b0[k] + 2.0 * t * b1[k] - b1[k-1];
+      b2[k+1] = 4.0 * b1[k] + 2.0 * t * b2[k] - b2[k-1];
+   }
+}
+
+/** Applies the basis of basis() to the coefficients of an expansion */
+static void series(
+   const double*         coef,
+   int                   degree,
+   const double*         b0,
+   const double*         b1,
+   const double*         b2,
+   double                f[3]
+   )
+{
+   int k;
+
+   f[0] = f[1] = f[2] = 0.0;
+   for( k = 0; k <= degree; ++k )
+   {
+      f[0] += coef[k] * b0[k];
+      f[1] += coef[k] * b1[k];
+      f[2] += coef[k] * b2[k];
+   }
+}
+
+void chebeval(
+   const double*         coef,
+   int                   degree,
+   double                t,
+   double                f[3]
+   )
+{
+   double b0[CHEB_MAXDEGREE+1], b1[CHEB_MAXDEGREE+1], b2[CHEB_MAXDEGREE+1];
+
+   basis(degree, t, b0, b1, b2);
+   series(coef, degree, b0, b1, b2, f);
+}
+
+/** Frees the expansions read before */
+static void chebclear(void)
+{
+   int i;
+
+   for( i = 0; i < ncurves; ++i )
+      free(curves[i].Tbreak);
+   free(curves);
+   curves = NULL;
+   ncurves = 0;
+}
+
+/** Number of doubles of the arrays of an expansion */
+static size_t curvesize(
+   const CHEBCURVE*      c
+   )
+{
+   return (size_t)(c->nint + 1) + (size_t)c->nint * CHEB_NSERIES * (c->degree + 1)
+      + (size_t)(c->nintp + 1) + (size_t)c->nintp * (c->degree + 1);
+}
+
+/** Checks that interval bounds increase */
+static int increasing(
+   const double*         brk,
+   int                   n
+   )
+{
+   int i;
+
+   for( i = 0; i < n; ++i )
+      if( !(brk[i] < brk[i+1]) )
+         return 0;
+   return 1;
+}
+
+/** Reads the expansions of one fluid
+ *
+ * @return 0 if successful, <> 0 if the file is truncated or invalid.
+ */
+static int readcurve(
+   FILE*                 f,
+   CHEBCURVE*            c
+   )
+{
+   int32_t head[4];
+   double lim[2];
+   size_t n;
+
+   if( fread(c->fluid, 1, sizeof(c->fluid), f) != sizeof(c->fluid) || fread(head, sizeof(int32_t), 4, f) != 4
+      || fread(lim, sizeof(double), 2, f) != 2 )
+      return 1;
+   c->fluid[sizeof(c->fluid)-1] = '\0';
+   c->degree = head[0];
+   c->nint = head[1];
+   c->nintp = head[2];
+   c->Tmin = lim[0];
+   c->Tmax = lim[1];
+   if( c->degree < 1 || c->degree > CHEB_MAXDEGREE || c->nint < 1 || c->nint > CHEB_MAXINTERVALS
+      || c->nintp < 1 || c->nintp > CHEB_MAXINTERVALS )
+      return 1;
+   n = curvesize(c);
+   if( (c->Tbreak = malloc(n * sizeof(double))) == NULL )
+      return 1;
+   c->coef = c->Tbreak + c->nint + 1;
+   c->lnpbreak = c->coef + (size_t)c->nint * CHEB_NSERIES * (c->degree + 1);
+   c->coefp = c->lnpbreak + c->nintp + 1;
+   if( fread(c->Tbreak, sizeof(double), n, f) != n || !increasing(c->Tbreak, c->nint) || !increasing(c->lnpbreak, c->nintp)
+      || c->Tbreak[0] != c->Tmin || c->Tbreak[c->nint] != c->Tmax )
+   {
+      free(c->Tbreak);
+      return 1;
+   }
+   return 0;
+}
+
+int chebsave(
+   const char*           path,
+   const CHEBCURVE*      curves,
+   int                   ncurves,
+   char*                 errmsg
+   )
+{
+   int32_t head[2] = { CHEB_ORDER, 0 };
+   FILE* f;
+   int i;
+
+   head[1] = ncurves;
+   f = fopen(path, "wb");
+   if( f == NULL )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Cannot write saturation file %.150s.", path);
+      return 1;
+   }
+   fwrite(CHEB_MAGIC, 1, 8, f);
+   fwrite(head, sizeof(int32_t), 2, f);
+   for( i = 0; i < ncurves; ++i )
+   {
+      const CHEBCURVE* c = &curves[i];
+      char fluid[sizeof(c->fluid)];
+      int32_t sizes[4];
+      double lim[2];
+
+      memset(fluid, 0, sizeof(fluid));
+      strncpy(fluid, c->fluid, sizeof(fluid) - 1);
+      sizes[0] = c->degree;
+      sizes[1] = c->nint;
+      sizes[2] = c->nintp;
+      sizes[3] = 0;
+      lim[0] = c->Tmin;
+      lim[1] = c->Tmax;
+      fwrite(fluid, 1, sizeof(fluid), f);
+      fwrite(sizes, sizeof(int32_t), 4, f);
+      fwrite(lim, sizeof(double), 2, f);
+      fwrite(c->Tbreak, sizeof(double), c->nint + 1, f);
+      fwrite(c->coef, sizeof(double), (size_t)c->nint * CHEB_NSERIES * (c->degree + 1), f);
+      fwrite(c->lnpbreak, sizeof(double), c->nintp + 1, f);
+      fwrite(c->coefp, sizeof(double), (size_t)c->nintp * (c->degree + 1), f);
+   }
+   if( ferror(f) | fclose(f) )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Cannot write saturation file %.150s.", path);
+      return 1;
+   }
+   return 0;
+}
+
+int chebload(
+   char*                 errmsg
+   )
+{
+   const char* path = getenv("PROPSSI_CHEBYSHEV");
+   char magic[8];
+   int32_t head[2];
+   FILE* f;
+
+   chebclear();
+   if( path == NULL || path[0] == '\0' )
+      return 0;
+   f = fopen(path, "rb");
+   if( f == NULL )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Cannot open saturation file PROPSSI_CHEBYSHEV=%.150s.", path);
+      return 1;
+   }
+   if( fread(magic, 1, 8, f) != 8 || memcmp(magic, CHEB_MAGIC, 8) != 0 || fread(head, sizeof(int32_t), 2, f) != 2
+      || head[0] != CHEB_ORDER || head[1] < 0 || head[1] > 1000 )
+   {
+      fclose(f);
+      snprintf(errmsg, ENGINE_MSGSIZE, "%.150s is not a saturation file of this architecture.", path);
+      return 1;
+   }
+   curves = calloc(head[1] > 0 ? head[1] : 1, sizeof(CHEBCURVE));
+   for( ncurves = 0; ncurves < head[1]; ++ncurves )
+      if( readcurve(f, &curves[ncurves]) != 0 )
+      {
+         fclose(f);
+         chebclear();
+         snprintf(errmsg, ENGINE_MSGSIZE, "Invalid saturation file %.150s.", path);
+         return 1;
+      }
+   fclose(f);
+   return 0;
+}
+
+/** Returns the single-letter name of a state property (P, T, Q, D, H, S, U), or 0 if not covered */
+static char propletter(
+   const char*           Name
+   )
+{
+   if( Name[0] == '\0' || strchr("PTQDHSU", Name[0]) == NULL )
+      return 0;
+   if( Name[1] == '\0' || (strchr("DHSU", Name[0]) != NULL && strcmp(Name+1, "mass") == 0) )
+      return Name[0];
+   return 0;
+}
+
+/** Index of the interval of x, which must lie within the bounds */
+static int interval(
+   const double*         brk,
+   int                   n,
+   double                x
+   )
+{
+   int lo = 0, hi = n;
+
+   while( hi - lo > 1 )
+   {
+      int mid = (lo + hi) / 2;
+      if( x < brk[mid] )
+         hi = mid;
+      else
+         lo = mid;
+   }
+   return lo;
+}
+
+/* jets in the two state inputs: value, d/d1, d/d2, d2/d1d1, d2/d1d2, d2/d2d2 */
+
+/** Lifts a function of input ix (1 or 2) with its derivatives to a jet */
+static void jetlift(
+   double                r[6],
+   const double          f[3],
+   int                   ix
+   )
+{
+   memset(r, 0, 6 * sizeof(double));
+   r[0] = f[0];
+   r[ix] = f[1];
+   r[ix == 1 ? 3 : 5] = f[2];
+}
+
+/** r = a + s * b, r may alias a or b */
+static void jetaxpy(
+   double                r[6],
+   const double          a[6],
+   double                s,
+   const double          b[6]
+   )
+{
+   int i;
+
+   for( i = 0; i < 6; ++i )
+      r[i] = a[i] + s * b[i];
+}
+
+/** r = a * b, r may alias a or b */
+static void jetprod(
+   double                r[6],
+   const double          a[6],
+   const double          b[6]
+   )
+{
+   double t[6];
+
+   t[0] = a[0] * b[0];
+   t[1] = a[1] * b[0] + a[0] * b[1];
+   t[2] = a[2] * b[0] + a[0] * b[2];
+   t[3] = a[3] * b[0] + 2.0 * a[1] * b[1] + a[0] * b[3];
+   t[4] = a[4] * b[0] + a[1] * b[2] + a[2] * b[1] + a[0] * b[4];
+   t[5] = a[5] * b[0] + 2.0 * a[2] * b[2] + a[0] * b[5];
+   memcpy(r, t, sizeof(t));
+}
+
+/** r = 1 / a, r may alias a */
+static void jetrecip(
+   double                r[6],
+   const double          a[6]
+   )
+{
+   double u = 1.0 / a[0];
+   double u2 = u * u;
+   double u3 = u2 * u;
+   double t[6];
+
+   t[0] = u;
+   t[1] = -a[1] * u2;
+   t[2] = -a[2] * u2;
+   t[3] = 2.0 * a[1] * a[1] * u3 - a[3] * u2;
+   t[4] = 2.0 * a[1] * a[2] * u3 - a[4] * u2;
+   t[5] = 2.0 * a[2] * a[2] * u3 - a[5] * u2;
+   memcpy(r, t, sizeof(t));
+}
+
+/** Evaluates a property of the saturated liquid and vapour as jets in the state inputs
+ *
+ * For D, the jets are those of the specific volume, in which the lever rule holds.
+ */
+static void saturated(
+   const CHEBCURVE*      c,
+   const double*         coef,            /**< coefficients of the temperature interval */
+   const double*         b0,              /**< basis of the temperature in the interval */
+   const double*         b1,
+   const double*         b2,
+   double                h,               /**< width of the interval */
+   double                dTdx,            /**< derivative of the temperature along the saturation input */
+   double                d2Tdx2,          /**< its second derivative */
+   int                   ix,              /**< position of the saturation input, 1 or 2 */
+   char                  y,               /**< property, D, H, S, or U */
+   double                yl[6],           /**< buffer for jet of the liquid */
+   double                yv[6]            /**< buffer for jet of the vapour */
+   )
+{
+   int s = y == 'D' ? CHEB_DL : y == 'H' ? CHEB_HL : y == 'S' ? CHEB_SL : CHEB_UL;
+   double* r[2];
+   double f[3];
+   int k;
+
+   r[0] = yl;
+   r[1] = yv;
+   for( k = 0; k < 2; ++k )
+   {
+      series(coef + (s + k) * (c->degree + 1), c->degree, b0, b1, b2, f);
+      f[1] *= 2.0 / h;
+      f[2] *= 4.0 / (h * h);
+      f[2] = f[2] * dTdx * dTdx + f[1] * d2Tdx2;
+      f[1] *= dTdx;
+      jetlift(r[k], f, ix);
+      if( y == 'D' )
+         jetrecip(r[k], r[k]);
+   }
+}
+
+/** Evaluates a two-phase state of a fluid
+ *
+ * @return 0 if successful, 1 if the state is not covered.
+ */
+static int twophase(
+   const CHEBCURVE*      c,
+   char                  prop,            /**< output property letter */
+   char                  xname,           /**< saturation input, T or P */
+   double                x,               /**< its value */
+   int                   ix,              /**< its position, 1 or 2 */
+   char                  zname,           /**< other input, Q, D, H, S, or U */
+   double                z,               /**< its value */
+   double                d[6]
+   )
+{
+   double b0[CHEB_MAXDEGREE+1], b1[CHEB_MAXDEGREE+1], b2[CHEB_MAXDEGREE+1];
+   double fx[3], fT[3], fP[3], L[3];
+   double xj[6], zj[6], q[6], yl[6], yv[6];
+   double T, h, dTdx = 1.0, d2Tdx2 = 0.0;
+   const double* coef;
+   int i;
+
+   if( xname == 'T' )
+   {
+      if( !(x >= c->Tmin && x <= c->Tmax) )
+         return 1;
+      T = x;
+   }
+   else
+   {
+      double lnp;
+
+      if( !(x > 0.0) )
+         return 1;
+      lnp = log(x);
+      if( !(lnp >= c->lnpbreak[0] && lnp <= c->lnpbreak[c->nintp]) )
+         return 1;
+      i = interval(c->lnpbreak, c->nintp, lnp);
+      h = c->lnpbreak[i+1] - c->lnpbreak[i];
+      basis(c->degree, (2.0 * lnp - c->lnpbreak[i] - c->lnpbreak[i+1]) / h, b0, b1, b2);
+      series(c->coefp + (size_t)i * (c->degree + 1), c->degree, b0, b1, b2, fT);
+      T = fmin(fmax(fT[0], c->Tmin), c->Tmax);
+   }
+
+   /* everything along the curve is a function of T */
+   i = interval(c->Tbreak, c->nint, T);
+   h = c->Tbreak[i+1] - c->Tbreak[i];
+   basis(c->degree, (2.0 * T - c->Tbreak[i] - c->Tbreak[i+1]) / h, b0, b1, b2);
+   coef = c->coef + (size_t)i * CHEB_NSERIES * (c->degree + 1);
+   series(coef + CHEB_LNP * (c->degree + 1), c->degree, b0, b1, b2, L);
+   L[1] *= 2.0 / h;
+   L[2] *= 4.0 / (h * h);
+
+   /* dp/dT = p L', d2p/dT2 = p (L'^2 + L''); for P input, these are inverted */
+   fT[0] = T;
+   fP[0] = exp(L[0]);
+   if( xname == 'T' )
+   {
+      fT[1] = 1.0; fT[2] = 0.0;
+      fP[1] = fP[0] * L[1];
+      fP[2] = fP[0] * (L[1] * L[1] + L[2]);
+   }
+   else
+   {
+      if( !(L[1] > 0.0) )
+         return 1;
+      dTdx = 1.0 / (x * L[1]);
+      d2Tdx2 = -(L[1] * L[1] + L[2]) * dTdx * dTdx * dTdx * x;
+      fT[1] = dTdx; fT[2] = d2Tdx2;
+      fP[0] = x; fP[1] = 1.0; fP[2] = 0.0;
+   }
+
+   fx[0] = x; fx[1] = 1.0; fx[2] = 0.0;
+   jetlift(xj, fx, ix);
+   memset(zj, 0, sizeof(zj));
+   zj[0] = z;
+   zj[3 - ix] = 1.0;
+
+   /* quality by the lever rule */
+   if( zname == 'Q' )
+   {
+      if( !(z >= 0.0 && z <= 1.0) )
+         return 1;
+      memcpy(q, zj, sizeof(q));
+   }
+   else
+   {
+      double w[6];
+
+      if( zname == 'D' && !(z > 0.0) )
+         return 1;
+      saturated(c, coef, b0, b1, b2, h, dTdx, d2Tdx2, ix, zname, yl, yv);
+      if( zname == 'D' )
+         jetrecip(w, zj);
+      else
+         memcpy(w, zj, sizeof(w));
+      jetaxpy(w, w, -1.0, yl);
+      jetaxpy(yv, yv, -1.0, yl);
+      if( yv[0] == 0.0 )
+         return 1;
+      jetrecip(yv, yv);
+      jetprod(q, w, yv);
+      if( !(q[0] >= CHEB_QMARGIN && q[0] <= 1.0 - CHEB_QMARGIN) )
+         return 1;
+   }
+
+   if( prop == xname )
+      memcpy(d, xj, sizeof(xj));
+   else if( prop == zname )
+      memcpy(d, zj, sizeof(zj));
+   else if( prop == 'T' )
+      jetlift(d, fT, ix);
+   else if( prop == 'P' )
+      jetlift(d, fP, ix);
+   else if( prop == 'Q' )
+      memcpy(d, q, sizeof(q));
+   else
+   {
+      /* y = yl + q (yv - yl) */
+      saturated(c, coef, b0, b1, b2, h, dTdx, d2Tdx2, ix, prop, yl, yv);
+      jetaxpy(yv, yv, -1.0, yl);
+      jetprod(yv, q, yv);
+      jetaxpy(d, yl, 1.0, yv);
+      if( prop == 'D' )
+         jetrecip(d, d);
+   }
+   return 0;
+}
+
+int chebstate(
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   double                d[6]
+   )
+{
+   char prop = propletter(Prop);
+   char n1 = propletter(Name1);
+   char n2 = propletter(Name2);
+   const CHEBCURVE* c = NULL;
+   int i;
+
+   for( i = 0; i < ncurves && c == NULL; ++i )
+      if( strcmp(curves[i].fluid, Fluid) == 0 )
+         c = &curves[i];
+   if( c == NULL )
+      return 1;
+
+   if( prop != 0 && (n1 == 'T' || n1 == 'P') && n2 != 0 && n2 != 'T' && n2 != 'P'
+      && twophase(c, prop, n1, Val1, 1, n2, Val2, d) == 0 )
+   {
+      ++chebstats.evaluations;
+      return 0;
+   }
+   if( prop != 0 && (n2 == 'T' || n2 == 'P') && n1 != 0 && n1 != 'T' && n1 != 'P'
+      && twophase(c, prop, n2, Val2, 2, n1, Val1, d) == 0 )
+   {
+      ++chebstats.evaluations;
+      return 0;
+   }
+   ++chebstats.declined;
+   return 1;
+}
@@ -0,0 +1,142 @@
+/** Chebyshev expansions of the saturation curves of pure fluids
+ *
+ * Each saturation state of CoolProp is a phase equilibrium solved by
+ * iteration. For fluids with a saturation file, the library evaluates
+ * the saturation curve from Chebyshev expansions instead, without any
+ * iteration: per fluid, ln p and the density, enthalpy, entropy, and
+ * internal energy of the saturated liquid and vapour are expanded in
+ * temperature on adjacent intervals between the triple point (or the
+ * lower limit of the equation of state) and just below the critical
+ * temperature. The saturation temperature is expanded in ln p on
+ * intervals of its own. Derivatives follow analytically from the
+ * expansions.
+ *
+ * The file is written by propssichebfit, which fits the expansions to
+ * HEOS, and is named by the environment variable PROPSSI_CHEBYSHEV. It
+ * is read by libinit. Its layout, in native byte order, is
+ *
+ *   char magic[8]        "PSCHEB01"
+ *   int32 order          0x01020304, to detect a foreign byte order
+ *   int32 ncurves
+ * followed per fluid by
+ *   char fluid[64]
+ *   int32 degree, nint, nintp, unused
+ *   double Tmin, Tmax
+ *   double Tbreak[nint+1]
+ *   double coef[nint][CHEB_NSERIES][degree+1]
+ *   double lnpbreak[nintp+1]
+ *   double coefp[nintp][degree+1]
+ *
+ * The expansions answer the saturation functions Tsat, Psat, and SatProp
+ * and the states of PropsSI2 given by temperature or pressure together
+ * with Q, D, H, S, or U that are clearly two-phase; everything else,
+ * including states closer to the critical point than Tmax, is left to
+ * CoolProp.
+ */
+
+#ifndef PROPSSICHEB_H_
+#define PROPSSICHEB_H_
+
+/** highest degree of an expansion */
+#define CHEB_MAXDEGREE 64
+
+/** series of a temperature interval */
+enum
+{
+   CHEB_LNP = 0,                          /**< ln p */
+   CHEB_DL,                               /**< density of the saturated liquid */
+   CHEB_DV,                               /**< density of the saturated vapour */
+   CHEB_HL,                               /**< enthalpy of the saturated liquid */
+   CHEB_HV,                               /**< enthalpy of the saturated vapour */
+   CHEB_SL,                               /**< entropy of the saturated liquid */
+   CHEB_SV,                               /**< entropy of the saturated vapour */
+   CHEB_UL,                               /**< internal energy of the saturated liquid */
+   CHEB_UV,                               /**< internal energy of the saturated vapour */
+   CHEB_NSERIES
+};
+
+/** expansions of the saturation curve of a fluid */
+typedef struct
+{
+   char                  fluid[64];       /**< fluid name */
+   int                   degree;          /**< degree of the expansions */
+   int                   nint;            /**< number of temperature intervals */
+   int                   nintp;           /**< number of ln p intervals */
+   double                Tmin;            /**< lowest temperature */
+   double                Tmax;            /**< highest temperature */
+   double*               Tbreak;          /**< interval bounds in temperature, nint+1 */
+   double*               coef;            /**< coefficients per temperature interval and series */
+   double*               lnpbreak;        /**< interval bounds in ln p, nintp+1 */
+   double*               coefp;           /**< coefficients of the temperature per ln p interval */
+} CHEBCURVE;
+
+/** counters of the saturation expansions */
+typedef struct
+{
+   unsigned long         evaluations;     /**< states answered by the expansions */
+   unsigned long         declined;        /**< states of fluids with expansions left to CoolProp */
+} CHEBSTATS;
+
+/** statistics of this process */
+extern CHEBSTATS chebstats;
+
+/** Node j of the Chebyshev-Lobatto points of a degree, in [-1, 1] */
+double chebnode(
+   int                   j,               /**< index of the node, 0 to degree */
+   int                   degree           /**< degree of the expansion */
+   );
+
+/** Computes the coefficients of the expansion interpolating values at the Chebyshev-Lobatto points */
+void chebinterp(
+   const double*         values,          /**< values at chebnode(j, degree), j = 0..degree */
+   int                   degree,          /**< degree of the expansion */
+   double*               coef             /**< buffer for degree+1 coefficients */
+   );
+
+/** Evaluates an expansion and its first and second derivatives at t in [-1, 1] */
+void chebeval(
+   const double*         coef,            /**< degree+1 coefficients */
+   int                   degree,          /**< degree of the expansion */
+   double                t,               /**< point */
+   double                f[3]             /**< buffer for value, first, and second derivative */
+   );
+
+/** Writes the expansions of some fluids to a saturation file
+ *
+ * @return 0 if successful, <> 0 otherwise (errmsg is set then).
+ */
+int chebsave(
+   const char*           path,            /**< file name */
+   const CHEBCURVE*      curves,          /**< expansions */
+   int                   ncurves,         /**< number of expansions */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Reads the saturation file named by PROPSSI_CHEBYSHEV, replacing the expansions read before
+ *
+ * @return 0 if successful or not configured, <> 0 if the file cannot be read (errmsg is set then).
+ */
+int chebload(
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Evaluates a property of a two-phase state and its partial derivatives with respect to the two state inputs
+ *
+ * One input must be T or P, the other Q, D, H, S, or U (or Dmass, Hmass,
+ * Smass, Umass). Prop is one of P, T, Q, D, H, S, U. The quality follows
+ * from the lever rule, in the specific volume for D; states with a
+ * quality within 1e-9 of 0 or 1 are not answered unless Q is an input.
+ *
+ * @return 0 if successful, 1 if the fluid, the inputs, or the state are not covered.
+ */
+int chebstate(
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name */
+   double                d[6]             /**< buffer for f, df/d1, df/d2, d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+   );
+
+#endif /* PROPSSICHEB_H_ */
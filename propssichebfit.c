@@ -0,0 +1,375 @@
+/** Fits the Chebyshev expansions of saturation curves for the library
+ *
+ * Writes the saturation file read by the library from PROPSSI_CHEBYSHEV
+ * (see propssicheb.h) for the given pure fluids. The expansions of ln p
+ * and the properties of both saturated phases in temperature are fitted
+ * to Q-T flashes of HEOS between the triple point (or the lower limit of
+ * the equation of state) and a relative distance of 1e-6 below the
+ * critical temperature. Each interval is interpolated at the
+ * Chebyshev-Lobatto points and checked at the points in between; where
+ * any of the series deviates by more than the tolerance, relative to its
+ * largest magnitude on the interval, the interval is halved. Deviations
+ * below 1e-8 that halving does not reduce by a tenth are taken as the
+ * rounding noise of the flashes and accepted. Close to the critical point, where
+ * the densities behave like (Tc - T)^0.325, the intervals thus shrink
+ * geometrically. The saturation temperature is then
+ * fitted in ln p the same way, to the inverse of the expansion of ln p,
+ * so that both directions agree. Pseudo-pure fluids, whose bubble and dew
+ * pressures differ, are rejected.
+ *
+ * The deviations reached are reported per fluid. Below about 1e-13, the
+ * tolerance is limited by the convergence of CoolProp's own saturation
+ * solver rather than by the expansions.
+ *
+ * Usage:
+ *
+ *   propssichebfit [-n degree] [-e tol] [-o outfile] fluid ...
+ *
+ * e.g. "propssichebfit -o propssisat.bin Water R134a". The degree defaults
+ * to 16, the tolerance to 1e-12, and the file to propssisat.bin.
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o propssichebfit propssichebfit.c propssicheb.c
+ *       libCoolProp.[so|dylib] -lm
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "CoolPropLib.h"
+#include "propssiengine.h"
+#include "propssicheb.h"
+
+#define CHEBFIT_TCMARGIN      1e-6
+#define CHEBFIT_MAXINTERVALS  4096
+
+/* smallest interval relative to the whole range */
+#define CHEBFIT_MINWIDTH      1e-10
+
+/* deviation below which halving an interval must reduce it by a tenth */
+#define CHEBFIT_NOISE         1e-8
+#define CHEBFIT_PROGRESS      0.9
+
+/** expansions fitted so far along one variable */
+typedef struct
+{
+   int      nseries;
+   int      n;               /**< number of intervals */
+   int      cap;
+   double*  brk;             /**< interval bounds, n+1 */
+   double*  coef;            /**< coefficients, nseries * (degree+1) per interval */
+   double   maxerr;          /**< largest deviation of an accepted interval */
+} FIT;
+
+/** function fitted along an interval: values of all series at x */
+typedef int (*FITFUNC)(void* ctx, double x, double* v, char* errmsg);
+
+static int degree = 16;
+static double tol = 1e-12;
+
+/** Q-T flashes of the saturated liquid and vapour */
+typedef struct
+{
+   long     handle;
+   long     qt;
+   long     param[5];        /**< P, Dmass, Hmass, Smass, Umass */
+} FLASH;
+
+static int saturation(
+   void*                 ctx,
+   double                T,
+   double*               v,
+   char*                 errmsg
+   )
+{
+   FLASH* fl = (FLASH*)ctx;
+   double p[2];
+   long errcode = 0;
+   int q, k;
+
+   for( q = 0; q < 2; ++q )
+   {
+      AbstractState_update(fl->handle, fl->qt, (double)q, T, &errcode, errmsg, ENGINE_MSGSIZE);
+      if( errcode != 0 )
+         return 1;
+      p[q] = AbstractState_keyed_output(fl->handle, fl->param[0], &errcode, errmsg, ENGINE_MSGSIZE);
+      for( k = 1; k < 5 && errcode == 0; ++k )
+         v[CHEB_DL + 2 * (k-1) + q] = AbstractState_keyed_output(fl->handle, fl->param[k], &errcode, errmsg, ENGINE_MSGSIZE);
+      if( errcode != 0 )
+         return 1;
+   }
+   if( !(p[0] > 0.0) || fabs(p[1] - p[0]) > 1e-8 * p[0] )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "bubble and dew pressure differ at T = %g K.", T);
+      return 1;
+   }
+   v[CHEB_LNP] = log(p[0]);
+   return 0;
+}
+
+/** Evaluates series s of a fit at x */
+static void fiteval(
+   const FIT*            fit,
+   int                   s,
+   double                x,
+   double                f[3]
+   )
+{
+   int i = 0;
+   double h;
+
+   while( i < fit->n - 1 && x > fit->brk[i+1] )
+      ++i;
+   h = fit->brk[i+1] - fit->brk[i];
+   chebeval(fit->coef + ((size_t)i * fit->nseries + s) * (degree + 1), degree, (2.0 * x - fit->brk[i] - fit->brk[i+1]) / h, f);
+   f[1] *= 2.0 / h;
+}
+
+/** inverse of the expansion of ln p */
+static int inverse(
+   void*                 ctx,
+   double                lnp,
+   double*               v,
+   char*                 errmsg
+   )
+{
+   const FIT* fwd = (const FIT*)ctx;
+   double lo = fwd->brk[0];
+   double hi = fwd->brk[fwd->n];
+   double T = 0.5 * (lo + hi);
+   int iter;
+
+   for( iter = 0; iter < 200; ++iter )
+   {
+      double f[3], step;
+
+      fiteval(fwd, CHEB_LNP, T, f);
+      step = f[1] > 0.0 ? (f[0] - lnp) / f[1] : HUGE_VAL;
+      if( fabs(step) <= 1e-15 * T )
+      {
+         v[0] = T;
+         return 0;
+      }
+      if( f[0] < lnp )
+         lo = T;
+      else
+         hi = T;
+      /* Newton, safeguarded by bisection */
+      if( T - step > lo && T - step < hi )
+         T -= step;
+      else
+         T = 0.5 * (lo + hi);
+      if( hi - lo <= 1e-15 * T )
+      {
+         v[0] = T;
+         return 0;
+      }
+   }
+   snprintf(errmsg, ENGINE_MSGSIZE, "no saturation temperature for ln p = %g.", lnp);
+   return 1;
+}
+
+/** Fits all series on [a, b], halving the interval until the tolerance is met or halving does not help
+ *
+ * @return 0 if successful, <> 0 if the function failed (errmsg is set then).
+ */
+static int fitrange(
+   FIT*                  fit,
+   FITFUNC               func,
+   void*                 ctx,
+   double                a,
+   double                b,
+   double                minwidth,
+   double                parenterr,       /**< deviation on the interval before halving */
+   char*                 errmsg
+   )
+{
+   double v[CHEB_MAXDEGREE+1][CHEB_NSERIES];
+   double col[CHEB_MAXDEGREE+1];
+   double scale[CHEB_NSERIES];
+   double coef[CHEB_NSERIES * (CHEB_MAXDEGREE+1)];
+   double err = 0.0;
+   int j, s;
+
+   for( j = 0; j <= degree; ++j )
+      if( func(ctx, 0.5 * (a + b) + 0.5 * (b - a) * chebnode(j, degree), v[j], errmsg) != 0 )
+         return 1;
+   for( s = 0; s < fit->nseries; ++s )
+   {
+      scale[s] = 0.0;
+      for( j = 0; j <= degree; ++j )
+      {
+         col[j] = v[j][s];
+         scale[s] = fmax(scale[s], fabs(col[j]));
+      }
+      chebinterp(col, degree, coef + s * (degree + 1));
+   }
+
+   /* deviation between the nodes */
+   for( j = 0; j < degree; ++j )
+   {
+      double t = cos(3.14159265358979323846 * (j + 0.5) / degree);
+      double w[CHEB_NSERIES];
+
+      if( func(ctx, 0.5 * (a + b) + 0.5 * (b - a) * t, w, errmsg) != 0 )
+         return 1;
+      for( s = 0; s < fit->nseries; ++s )
+      {
+         double f[3];
+
+         chebeval(coef + s * (degree + 1), degree, t, f);
+         if( scale[s] > 0.0 )
+            err = fmax(err, fabs(f[0] - w[s]) / scale[s]);
+      }
+   }
+
+   if( err > tol && (err > CHEBFIT_NOISE || err < CHEBFIT_PROGRESS * parenterr) && b - a > minwidth && fit->n + 2 <= CHEBFIT_MAXINTERVALS )
+   {
+      double m = 0.5 * (a + b);
+      return fitrange(fit, func, ctx, a, m, minwidth, err, errmsg) || fitrange(fit, func, ctx, m, b, minwidth, err, errmsg);
+   }
+
+   if( fit->n == fit->cap )
+   {
+      fit->cap = 2 * fit->cap + 8;
+      fit->brk = realloc(fit->brk, (fit->cap + 1) * sizeof(double));
+      fit->coef = realloc(fit->coef, (size_t)fit->cap * fit->nseries * (degree + 1) * sizeof(double));
+   }
+   if( fit->n == 0 )
+      fit->brk[0] = a;
+   fit->brk[fit->n + 1] = b;
+   memcpy(fit->coef + (size_t)fit->n * fit->nseries * (degree + 1), coef, fit->nseries * (degree + 1) * sizeof(double));
+   ++fit->n;
+   fit->maxerr = fmax(fit->maxerr, err);
+   return 0;
+}
+
+/** Fits the expansions of a fluid
+ *
+ * @return 0 if successful, <> 0 otherwise (errmsg is set then).
+ */
+static int fitfluid(
+   const char*           Fluid,
+   CHEBCURVE*            c,
+   char*                 errmsg
+   )
+{
+   static const char* names[5] = { "P", "Dmass", "Hmass", "Smass", "Umass" };
+   FIT fwd, inv;
+   FLASH fl;
+   double Tc, Tmin;
+   long errcode = 0;
+   int k, rc;
+
+   Tc = Props1SI(Fluid, "Tcrit");
+   Tmin = fmax(Props1SI(Fluid, "Ttriple"), Props1SI(Fluid, "Tmin"));
+   if( !isfinite(Tc) || !isfinite(Tmin) || !(Tmin < Tc) )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "no saturation curve.");
+      return 1;
+   }
+   fl.handle = AbstractState_factory("HEOS", Fluid, &errcode, errmsg, ENGINE_MSGSIZE);
+   if( errcode != 0 )
+      return 1;
+   fl.qt = get_input_pair_index("QT_INPUTS");
+   for( k = 0; k < 5; ++k )
+      fl.param[k] = get_param_index(names[k]);
+
+   memset(&fwd, 0, sizeof(fwd));
+   memset(&inv, 0, sizeof(inv));
+   fwd.nseries = CHEB_NSERIES;
+   inv.nseries = 1;
+   c->Tmin = Tmin;
+   c->Tmax = Tc * (1.0 - CHEBFIT_TCMARGIN);
+   rc = fitrange(&fwd, saturation, &fl, c->Tmin, c->Tmax, CHEBFIT_MINWIDTH * (c->Tmax - c->Tmin), HUGE_VAL, errmsg);
+   AbstractState_free(fl.handle, &errcode, errmsg, ENGINE_MSGSIZE);
+   if( rc == 0 )
+   {
+      double lo[3], hi[3];
+
+      fiteval(&fwd, CHEB_LNP, c->Tmin, lo);
+      fiteval(&fwd, CHEB_LNP, c->Tmax, hi);
+      rc = fitrange(&inv, inverse, &fwd, lo[0], hi[0], CHEBFIT_MINWIDTH * (hi[0] - lo[0]), HUGE_VAL, errmsg);
+   }
+   if( rc != 0 )
+   {
+      free(fwd.brk);
+      free(fwd.coef);
+      free(inv.brk);
+      free(inv.coef);
+      return 1;
+   }
+
+   memset(c->fluid, 0, sizeof(c->fluid));
+   strncpy(c->fluid, Fluid, sizeof(c->fluid) - 1);
+   c->degree = degree;
+   c->nint = fwd.n;
+   c->nintp = inv.n;
+   c->Tbreak = fwd.brk;
+   c->coef = fwd.coef;
+   c->lnpbreak = inv.brk;
+   c->coefp = inv.coef;
+   fprintf(stderr, "propssichebfit: %s: %d intervals in T, %d in ln p, max deviation %.2e and %.2e\n",
+      Fluid, fwd.n, inv.n, fwd.maxerr, inv.maxerr);
+   return 0;
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   const char* outfile = "propssisat.bin";
+   char msg[ENGINE_MSGSIZE];
+   CHEBCURVE* curves;
+   int ncurves = 0;
+   int opt;
+   int i, rc;
+
+   while( (opt = getopt(argc, argv, "n:e:o:")) != -1 )
+   {
+      if( (opt == 'n' && (degree = atoi(optarg)) >= 2 && degree <= CHEB_MAXDEGREE)
+         || (opt == 'e' && (tol = atof(optarg)) > 0.0)
+         || (opt == 'o' && (outfile = optarg) != NULL) )
+         continue;
+      fprintf(stderr, "usage: propssichebfit [-n degree] [-e tol] [-o outfile] fluid ...\n");
+      return 1;
+   }
+   if( optind == argc )
+   {
+      fprintf(stderr, "usage: propssichebfit [-n degree] [-e tol] [-o outfile] fluid ...\n");
+      return 1;
+   }
+
+   curves = calloc(argc - optind, sizeof(CHEBCURVE));
+   for( i = optind; i < argc; ++i )
+   {
+      if( fitfluid(argv[i], &curves[ncurves], msg) != 0 )
+      {
+         fprintf(stderr, "propssichebfit: %s: %s\n", argv[i], msg);
+         continue;
+      }
+      ++ncurves;
+   }
+
+   rc = ncurves > 0 && chebsave(outfile, curves, ncurves, msg) == 0 ? 0 : 1;
+   if( ncurves > 0 && rc != 0 )
+      fprintf(stderr, "propssichebfit: %s\n", msg);
+   for( i = 0; i < ncurves; ++i )
+   {
+      free(curves[i].Tbreak);
+      free(curves[i].coef);
+      free(curves[i].lnpbreak);
+      free(curves[i].coefp);
+   }
+   free(curves);
+   return rc;
+}
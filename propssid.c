@@ -0,0 +1,374 @@
+/** Local property server for the extrinsic CoolProp library
+ *
+ * Serves state evaluations of the function library to many GAMS processes
+ * on the same node over a Unix domain socket (see propssiserver.h).
+ * The server keeps one warm AbstractState handle per fluid and a state
+ * cache (shared with other processes if PROPSSI_SHMCACHE is set). Value
+ * requests that arrive together for the same fluid, output, and input
+ * pair are evaluated in one AbstractState_update_and_1_out call. Groups
+ * given in density and temperature are evaluated by the batch Helmholtz
+ * kernel (see propssihelmholtz.h) if it supports the fluid.
+ *
+ * Usage:
+ *
+ *   propssid [socketpath]
+ *
+ * The socket path defaults to $PROPSSI_SERVER or /tmp/propssi.sock. The
+ * server refuses to start if another server listens on the path. A client
+ * that does not read its responses is disconnected.
+ *
+ * Compilation:
+ *
+ *   gcc -O3 -fopenmp-simd -fno-math-errno -o propssid propssid.c propssiengine.c propssicache.c
+ *       propssiserver.c propssihelmholtz.c libCoolProp.[so|dylib] -lm -lpthread [-lrt on Linux]
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "CoolPropLib.h"
+#include "propssiserver.h"
+#include "propssihelmholtz.h"
+
+#define MAXCLIENTS 256
+#define MAXFLUIDS  64
+
+/** connected client */
+typedef struct
+{
+   int            fd;          /**< socket descriptor, -1 if slot is free */
+   SERVERREQUEST  request;     /**< request being received */
+   size_t         filled;      /**< bytes of request received so far */
+   int            pending;     /**< whether a complete request waits for evaluation */
+   SERVERRESPONSE response;    /**< response to pending request */
+   int            done;        /**< whether the response is ready */
+} CLIENT;
+
+static CLIENT clients[MAXCLIENTS];
+static char* fluidnames[MAXFLUIDS];
+static long fluidhandles[MAXFLUIDS];
+static HELMHOLTZ* fluideos[MAXFLUIDS];
+static int fluideostried[MAXFLUIDS];
+static int nfluids = 0;
+static PROPSSICACHE* cache = NULL;
+
+/** Returns the slot of a fluid, creating its warm AbstractState handle on first use */
+static int fluidindex(
+   const char*           Fluid            /**< fluid name */
+   )
+{
+   char buf[ENGINE_MSGSIZE];
+   long errcode = 0;
+   long handle;
+   int i;
+
+   for( i = 0; i < nfluids; ++i )
+      if( strcmp(fluidnames[i], Fluid) == 0 )
+         return i;
+   if( nfluids == MAXFLUIDS )
+      return -1;
+
+   handle = AbstractState_factory("HEOS", Fluid, &errcode, buf, sizeof(buf));
+   if( errcode != 0 )
+      return -1;
+   fluidnames[nfluids] = strdup(Fluid);
+   fluidhandles[nfluids] = handle;
+
+   return nfluids++;
+}
+
+/** Returns the batch Helmholtz kernel of a fluid, or NULL if the fluid is not supported */
+static HELMHOLTZ* fluidkernel(
+   int                   idx              /**< slot of fluid */
+   )
+{
+   char buf[ENGINE_MSGSIZE];
+
+   if( !fluideostried[idx] )
+   {
+      fluideostried[idx] = 1;
+      fluideos[idx] = helmholtzcreate(fluidnames[idx], buf);
+      if( fluideos[idx] == NULL )
+         fprintf(stderr, "propssid: %s\n", buf);
+   }
+   return fluideos[idx];
+}
+
+/** Evaluates a single request through the engine */
+static void evalsingle(
+   CLIENT*               c                /**< client with pending request */
+   )
+{
+   SERVERREQUEST* r = &c->request;
+
+   memset(&c->response, 0, sizeof(c->response));
+   c->response.status = evalprops(cache, r->prop, r->name1, r->val1, r->name2, r->val2, r->fluid,
+      r->derivrequest, c->response.d, c->response.msg);
+   c->done = 1;
+}
+
+/** Evaluates all pending requests
+ *
+ * Requests that need derivatives are evaluated one by one. Value requests
+ * missing the cache are grouped by fluid, output, and input names, and each
+ * group is evaluated in one batched update on the fluid's handle.
+ */
+static void evalpending(void)
+{
+   static double v1[MAXCLIENTS], v2[MAXCLIENTS], out[MAXCLIENTS];
+   static int member[MAXCLIENTS];
+   char buf[ENGINE_MSGSIZE];
+   int i, j;
+
+   for( i = 0; i < MAXCLIENTS; ++i )
+   {
+      CLIENT* c = &clients[i];
+      c->done = 0;
+      if( !c->pending )
+         continue;
+      memset(&c->response, 0, sizeof(c->response));
+      if( c->request.derivrequest > 0 )
+         evalsingle(c);
+      else if( cachelookup(cache, cachekey(c->request.prop, c->request.name1, c->request.name2, c->request.fluid),
+            c->request.val1, c->request.val2, 0, c->response.d) )
+         c->done = 1;
+   }
+
+   for( i = 0; i < MAXCLIENTS; ++i )
+   {
+      SERVERREQUEST* r = &clients[i].request;
+      long pair, param, errcode = 0;
+      int swap, idx, nleft, n = 0;
+
+      if( !clients[i].pending || clients[i].done )
+         continue;
+
+      pair = inputpair(r->name1, r->name2, &swap);
+      param = get_param_index(r->prop);
+      idx = fluidindex(r->fluid);
+      if( pair < 0 || param < 0 || idx < 0 )
+      {
+         evalsingle(&clients[i]);
+         continue;
+      }
+
+      for( j = i; j < MAXCLIENTS; ++j )
+      {
+         SERVERREQUEST* o = &clients[j].request;
+         if( !clients[j].pending || clients[j].done || o->derivrequest > 0
+            || strcmp(o->prop, r->prop) != 0 || strcmp(o->name1, r->name1) != 0
+            || strcmp(o->name2, r->name2) != 0 || strcmp(o->fluid, r->fluid) != 0 )
+            continue;
+         v1[n] = swap ? o->val2 : o->val1;
+         v2[n] = swap ? o->val1 : o->val2;
+         member[n++] = j;
+      }
+
+      nleft = -1;
+      if( pair == get_input_pair_index("DmassT_INPUTS") && fluidkernel(idx) != NULL )
+         nleft = helmholtzbatch(fluidkernel(idx), r->prop, n, v2, v1, out);
+      if( nleft < 0 )
+         AbstractState_update_and_1_out(fluidhandles[idx], pair, v1, v2, n, param, out, &errcode, buf, sizeof(buf));
+      for( j = 0; j < n; ++j )
+      {
+         CLIENT* c = &clients[member[j]];
+         if( errcode != 0 || (nleft > 0 && isnan(out[j])) )
+         {
+            /* one of the states failed or may be two-phase; evaluate them singly */
+            evalsingle(c);
+            continue;
+         }
+         c->response.status = 0;
+         c->response.d[0] = out[j];
+         c->done = 1;
+         cacheinsert(cache, cachekey(c->request.prop, c->request.name1, c->request.name2, c->request.fluid),
+            c->request.val1, c->request.val2, 0, c->response.d);
+      }
+   }
+}
+
+static void closeclient(
+   CLIENT*               c
+   )
+{
+   close(c->fd);
+   c->fd = -1;
+   c->pending = 0;
+   c->filled = 0;
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   struct sockaddr_un addr;
+   struct pollfd fds[MAXCLIENTS+1];
+   int map[MAXCLIENTS+1];
+   char msg[256];
+   const char* path;
+   int listenfd;
+   int i;
+
+   path = argc > 1 ? argv[1] : getenv("PROPSSI_SERVER");
+   if( path == NULL || path[0] == '\0' )
+      path = SERVER_DEFPATH;
+   if( strlen(path) >= sizeof(addr.sun_path) )
+   {
+      fprintf(stderr, "propssid: socket path too long: %s\n", path);
+      return 1;
+   }
+
+   cache = cachecreate(msg);
+   if( cache == NULL && msg[0] != '\0' )
+   {
+      fprintf(stderr, "propssid: %s\n", msg);
+      return 1;
+   }
+   if( enginebudget(msg) != 0 || enginenegative(msg) != 0 )
+   {
+      fprintf(stderr, "propssid: %s\n", msg);
+      return 1;
+   }
+
+   signal(SIGPIPE, SIG_IGN);
+
+   listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if( listenfd < 0 )
+   {
+      perror("propssid: socket");
+      return 1;
+   }
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+   /* a socket file that accepts connections belongs to a running server, which must keep it */
+   if( connect(listenfd, (struct sockaddr*)&addr, sizeof(addr)) == 0 )
+   {
+      fprintf(stderr, "propssid: another server is listening on %s\n", path);
+      return 1;
+   }
+   close(listenfd);
+   listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if( listenfd < 0 )
+   {
+      perror("propssid: socket");
+      return 1;
+   }
+   unlink(path);
+   if( bind(listenfd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenfd, 64) != 0 )
+   {
+      perror("propssid: bind");
+      return 1;
+   }
+   fprintf(stderr, "propssid: listening on %s\n", path);
+
+   for( i = 0; i < MAXCLIENTS; ++i )
+      clients[i].fd = -1;
+
+   for( ;; )
+   {
+      int nfds = 0;
+
+      fds[nfds].fd = listenfd;
+      fds[nfds].events = POLLIN;
+      map[nfds++] = -1;
+      for( i = 0; i < MAXCLIENTS; ++i )
+         if( clients[i].fd >= 0 && !clients[i].pending )
+         {
+            fds[nfds].fd = clients[i].fd;
+            fds[nfds].events = POLLIN;
+            map[nfds++] = i;
+         }
+
+      if( poll(fds, nfds, -1) < 0 )
+      {
+         if( errno == EINTR )
+            continue;
+         perror("propssid: poll");
+         break;
+      }
+
+      /* receive what has arrived from all clients before evaluating, so that concurrent requests form one batch */
+      for( i = 1; i < nfds; ++i )
+      {
+         CLIENT* c = &clients[map[i]];
+         ssize_t n;
+
+         if( !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)) )
+            continue;
+         n = recv(c->fd, (char*)&c->request + c->filled, sizeof(SERVERREQUEST) - c->filled, 0);
+         if( n <= 0 )
+         {
+            if( n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) )
+               continue;
+            closeclient(c);
+            continue;
+         }
+         c->filled += (size_t)n;
+         if( c->filled == sizeof(SERVERREQUEST) )
+         {
+            c->request.prop[sizeof(c->request.prop)-1] = '\0';
+            c->request.name1[sizeof(c->request.name1)-1] = '\0';
+            c->request.name2[sizeof(c->request.name2)-1] = '\0';
+            c->request.fluid[sizeof(c->request.fluid)-1] = '\0';
+            c->pending = 1;
+            c->filled = 0;
+         }
+      }
+
+      if( fds[0].revents & POLLIN )
+      {
+         int fd = accept(listenfd, NULL, NULL);
+         if( fd >= 0 )
+         {
+            for( i = 0; i < MAXCLIENTS && clients[i].fd >= 0; ++i )
+               ;
+            if( i == MAXCLIENTS )
+               close(fd);
+            else
+            {
+               fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+               clients[i].fd = fd;
+               clients[i].filled = 0;
+               clients[i].pending = 0;
+            }
+         }
+      }
+
+      evalpending();
+
+      for( i = 0; i < MAXCLIENTS; ++i )
+      {
+         CLIENT* c = &clients[i];
+         if( !c->pending )
+            continue;
+         c->pending = 0;
+         /* responses are small and fit the socket buffer of a client that reads them; one that does not is dropped
+          * instead of stalling all others
+          */
+         if( send(c->fd, &c->response, sizeof(c->response), 0) != (ssize_t)sizeof(c->response) )
+            closeclient(c);
+      }
+   }
+
+   close(listenfd);
+   unlink(path);
+   engineshutdown();
+   cachefree(cache);
+
+   return 0;
+}
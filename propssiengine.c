@@ -0,0 +1,1393 @@
+/** Evaluation engine of the extrinsic CoolProp library
+ *
+ * See propssiengine.h.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#endif
+
+#include "CoolPropLib.h"
+#include "propssiengine.h"
+
+/** number of worker threads for evaluations under a time budget
+ *
+ * Workers stuck in abandoned evaluations are not available, so this
+ * bounds the number of slow evaluations running in the background.
+ */
+#define ENGINE_MAXWORKERS 4
+
+/** number of states remembered for the "last" fallback and for speculation */
+#define ENGINE_NLAST 256
+
+/** number of neighbourhoods whose steps are tracked for the fidelity, and their relative width per input */
+#define ENGINE_NFID     4096
+#define ENGINE_FIDCELL  0.05
+
+/** number of speculative states waiting for evaluation; older ones are dropped */
+#define ENGINE_NSPEC 8
+
+/** sets and ways of the negative cache; boxes of the same inputs and fluid share a set */
+#define ENGINE_NEGSETS 128
+#define ENGINE_NEGWAYS 8
+
+enum { FALLBACK_ERROR, FALLBACK_LAST, FALLBACK_TABULAR };
+
+ENGINESTATS enginestats;
+
+/** last evaluated state per output, input names, and fluid */
+typedef struct
+{
+   uint64_t key;
+   double   val1;
+   double   val2;
+   int      level;
+   double   d[6];
+} LASTSTATE;
+
+/** previous state per output, input names, and fluid, to predict the next one */
+typedef struct
+{
+   uint64_t key;
+   double   val1;
+   double   val2;
+   int      maxlevel;                  /**< highest derivative asked for */
+} PREVSTATE;
+
+/** last step per output, input names, fluid, and neighbourhood of the inputs, to choose the fidelity */
+typedef struct
+{
+   uint64_t key;                       /**< key of the neighbourhood, see fidkey() */
+   double   val1;
+   double   val2;
+   int      exact;                     /**< whether the state switched to the full equation of state */
+} FIDSTATE;
+
+/** box of inputs around a state CoolProp could not evaluate */
+typedef struct
+{
+   uint64_t key;                       /**< key from cachekey(), 0 if empty */
+   int      level;                     /**< derivatives asked for when the evaluation failed */
+   double   lo1, hi1;
+   double   lo2, hi2;
+   char     msg[120];                  /**< error message of the failed evaluation */
+} NEGENTRY;
+
+static LASTSTATE laststates[ENGINE_NLAST];
+static NEGENTRY negentries[ENGINE_NEGSETS][ENGINE_NEGWAYS];
+static int negnext[ENGINE_NEGSETS];    /* way to replace next per set */
+static double negbox = 0.0;            /* relative half-width of the boxes, < 0 if disabled */
+static FIDSTATE fidstates[ENGINE_NFID];
+static char fidbackend[16] = "";       /* backend of the approximation, empty if disabled */
+static double fidstep = 1e-3;          /* relative step below which a state switches to the full equation of state */
+static int fidpolish = 0;              /* whether all states are evaluated by the full equation of state */
+static PREVSTATE prevstates[ENGINE_NLAST];
+static double budget = 0.0;            /* time budget in seconds, 0 if unlimited */
+static int fallback = FALLBACK_ERROR;
+static double specbudget = 0.0;        /* CPU time for speculation per served call in seconds, 0 if disabled */
+
+/** CoolProp input pairs in terms of PropsSI input names, in CoolProp's value order */
+static const char* INPUTPAIRS[][3] =
+{
+   { "P", "T", "PT_INPUTS" },
+   { "P", "Q", "PQ_INPUTS" },
+   { "Q", "T", "QT_INPUTS" },
+   { "D", "T", "DmassT_INPUTS" },
+   { "D", "P", "DmassP_INPUTS" },
+   { "H", "P", "HmassP_INPUTS" },
+   { "P", "S", "PSmass_INPUTS" },
+   { "P", "U", "PUmass_INPUTS" },
+   { "H", "T", "HmassT_INPUTS" },
+   { "S", "T", "SmassT_INPUTS" },
+   { "T", "U", "TUmass_INPUTS" },
+   { "H", "S", "HmassSmass_INPUTS" },
+   { "S", "U", "SmassUmass_INPUTS" },
+   { "D", "H", "DmassHmass_INPUTS" },
+   { "D", "S", "DmassSmass_INPUTS" },
+   { "D", "U", "DmassUmass_INPUTS" },
+   { "D", "Q", "DmassQ_INPUTS" },
+   { "H", "Q", "HmassQ_INPUTS" },
+   { "Q", "S", "QSmass_INPUTS" },
+   { NULL, NULL, NULL }
+};
+
+long inputpair(
+   const char*           Name1,
+   const char*           Name2,
+   int*                  swap
+   )
+{
+   int i;
+
+   for( i = 0; INPUTPAIRS[i][0] != NULL; ++i )
+   {
+      if( strcmp(Name1, INPUTPAIRS[i][0]) == 0 && strcmp(Name2, INPUTPAIRS[i][1]) == 0 )
+      {
+         *swap = 0;
+         return get_input_pair_index(INPUTPAIRS[i][2]);
+      }
+      if( strcmp(Name1, INPUTPAIRS[i][1]) == 0 && strcmp(Name2, INPUTPAIRS[i][0]) == 0 )
+      {
+         *swap = 1;
+         return get_input_pair_index(INPUTPAIRS[i][2]);
+      }
+   }
+   return -1;
+}
+
+#if !defined(_WIN32)
+/* CoolProp keeps the message of the last error in one string for the
+ * whole process. Evaluations run concurrently on the workers, the
+ * speculative thread, and the threads of evalbounds(), so the message is
+ * only taken if no other evaluation overlapped the failed one. */
+static pthread_mutex_t errlock = PTHREAD_MUTEX_INITIALIZER;
+static int nactive = 0;                /* evaluations in progress by evalraw() */
+static unsigned long noverlaps = 0;    /* evaluations started while another was in progress */
+#endif
+
+/** Evaluates a state by PropsSI calls */
+static int evalraw(
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   char str[80];
+   int overlapped = 0;
+   int rc = 0;
+   int i;
+#if !defined(_WIN32)
+   unsigned long overlaps;
+
+   pthread_mutex_lock(&errlock);
+   if( nactive++ > 0 )
+   {
+      overlapped = 1;
+      ++noverlaps;
+   }
+   overlaps = noverlaps;
+   pthread_mutex_unlock(&errlock);
+#endif
+   memset(d, 0, 6 * sizeof(double));
+   d[0] = PropsSI(Prop, Name1, Val1, Name2, Val2, Fluid);
+   if( derivrequest > 0 && isfinite(d[0]) )
+   {
+      sprintf(str, "d(%s)/d(%s)|%s", Prop, Name1, Name2);
+      d[1] = PropsSI(str, Name1, Val1, Name2, Val2, Fluid);
+      sprintf(str, "d(%s)/d(%s)|%s", Prop, Name2, Name1);
+      d[2] = PropsSI(str, Name1, Val1, Name2, Val2, Fluid);
+      if( derivrequest > 1 )
+      {
+         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Name1, Name2, Name1, Name2);
+         d[3] = PropsSI(str, Name1, Val1, Name2, Val2, Fluid);
+         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Name1, Name2, Name2, Name1);
+         d[4] = PropsSI(str, Name1, Val1, Name2, Val2, Fluid);
+         sprintf(str, "d(d(%s)/d(%s)|%s)/d(%s)|%s", Prop, Name2, Name1, Name2, Name1);
+         d[5] = PropsSI(str, Name1, Val1, Name2, Val2, Fluid);
+      }
+   }
+   for( i = 0; i < 6; ++i )
+      if( !isfinite(d[i]) )
+         rc = 1;
+#if !defined(_WIN32)
+   pthread_mutex_lock(&errlock);
+   overlapped = overlapped || noverlaps != overlaps;
+#endif
+   if( rc != 0 && overlapped )
+      snprintf(errmsg, ENGINE_MSGSIZE, "CoolProp could not evaluate %.20s(%.20s=%g, %.20s=%g) for %.100s.",
+         Prop, Name1, Val1, Name2, Val2, Fluid);
+   else if( rc != 0 )
+   {
+      errmsg[0] = '\0';
+      get_global_param_string("errstring", errmsg, ENGINE_MSGSIZE);
+   }
+#if !defined(_WIN32)
+   --nactive;
+   pthread_mutex_unlock(&errlock);
+#endif
+   return rc;
+}
+
+/** Moves a state by a first-order Taylor step of the value and, if second derivatives are known, the gradient */
+static void taylor(
+   double                d[6],
+   int                   level,
+   double                dv1,
+   double                dv2
+   )
+{
+   if( level > 0 )
+   {
+      d[0] += d[1] * dv1 + d[2] * dv2;
+      if( level > 1 )
+      {
+         d[1] += d[3] * dv1 + d[4] * dv2;
+         d[2] += d[4] * dv1 + d[5] * dv2;
+      }
+   }
+}
+
+/** Answers an evaluation that exceeded the time budget by the configured fallback
+ *
+ * @return 0 if successful, <> 0 otherwise (errmsg is set then).
+ */
+static int evalfallback(
+   uint64_t              key,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   if( fallback == FALLBACK_LAST )
+   {
+      const LASTSTATE* last = &laststates[key % ENGINE_NLAST];
+      if( last->key == key && last->level >= derivrequest )
+      {
+         memcpy(d, last->d, 6 * sizeof(double));
+         taylor(d, last->level, Val1 - last->val1, Val2 - last->val2);
+         ++enginestats.fallbacks;
+         return 0;
+      }
+   }
+   else if( fallback == FALLBACK_TABULAR )
+   {
+      char tabular[ENGINE_MSGSIZE];
+      snprintf(tabular, sizeof(tabular), "BICUBIC&HEOS::%s", Fluid);
+      if( evalraw(Prop, Name1, Val1, Name2, Val2, tabular, derivrequest, d, errmsg) == 0 )
+      {
+         ++enginestats.fallbacks;
+         return 0;
+      }
+   }
+   snprintf(errmsg, ENGINE_MSGSIZE, "Evaluation of %s(%s=%g, %s=%g) for %s exceeded time budget of %g ms.",
+      Prop, Name1, Val1, Name2, Val2, Fluid, 1000.0 * budget);
+   return 1;
+}
+
+#if !defined(_WIN32)
+
+enum { WORKER_IDLE, WORKER_BUSY, WORKER_DONE, WORKER_ABANDONED };
+
+/** worker thread evaluating states under a time budget */
+typedef struct
+{
+   pthread_t        thread;
+   pthread_cond_t   wake;                  /**< signaled when a job is assigned */
+   int              state;
+   int              orphaned;              /**< left to finish its evaluation by engineshutdown(): frees itself then */
+   PROPSSICACHE*    cache;                 /**< cache for the result of an abandoned evaluation, NULL to drop it */
+   uint64_t         key;
+   char             prop[64];
+   char             name1[16];
+   char             name2[16];
+   char             fluid[ENGINE_MSGSIZE];
+   double           val1;
+   double           val2;
+   int              derivrequest;
+   int              rc;
+   double           d[6];
+   char             errmsg[ENGINE_MSGSIZE];
+} WORKER;
+
+static WORKER* workers[ENGINE_MAXWORKERS]; /* NULL if not started */
+static pthread_mutex_t workerlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workerdone = PTHREAD_COND_INITIALIZER;
+static int workerstop = 0;             /* asks idle workers to exit, see engineshutdown() */
+
+static void* workermain(
+   void*                 arg
+   )
+{
+   WORKER* w = (WORKER*)arg;
+
+   pthread_mutex_lock(&workerlock);
+   for( ;; )
+   {
+      while( w->state != WORKER_BUSY && !workerstop )
+         pthread_cond_wait(&w->wake, &workerlock);
+      if( w->state != WORKER_BUSY )
+         break;
+      pthread_mutex_unlock(&workerlock);
+
+      w->rc = evalraw(w->prop, w->name1, w->val1, w->name2, w->val2, w->fluid, w->derivrequest, w->d, w->errmsg);
+
+      pthread_mutex_lock(&workerlock);
+      if( w->orphaned )
+      {
+         /* the engine was shut down meanwhile and no longer knows this worker */
+         pthread_mutex_unlock(&workerlock);
+         pthread_cond_destroy(&w->wake);
+         free(w);
+         return NULL;
+      }
+      if( w->state == WORKER_ABANDONED )
+      {
+         /* nobody waits for the result anymore, but the next call for this state will find it */
+         if( w->rc == 0 && w->cache != NULL )
+            cacheinsert(w->cache, w->key, w->val1, w->val2, w->derivrequest, w->d);
+         w->state = WORKER_IDLE;
+         /* engineshutdown() may wait for it */
+         pthread_cond_broadcast(&workerdone);
+      }
+      else
+      {
+         w->state = WORKER_DONE;
+         pthread_cond_broadcast(&workerdone);
+      }
+   }
+   pthread_mutex_unlock(&workerlock);
+   return NULL;
+}
+
+/** Evaluates a state on a worker thread, waiting at most for the time budget
+ *
+ * @return 0 if successful, 1 if CoolProp failed, -1 if the budget was exceeded.
+ */
+static int evalbudget(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   struct timespec deadline;
+   WORKER* w = NULL;
+   int rc;
+   int i;
+
+   if( strlen(Prop) >= sizeof(w->prop) || strlen(Name1) >= sizeof(w->name1)
+      || strlen(Name2) >= sizeof(w->name2) || strlen(Fluid) >= sizeof(w->fluid) )
+      return evalraw(Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, errmsg);
+
+   clock_gettime(CLOCK_REALTIME, &deadline);
+   deadline.tv_sec += (time_t)budget;
+   deadline.tv_nsec += (long)((budget - floor(budget)) * 1e9);
+   if( deadline.tv_nsec >= 1000000000L )
+   {
+      ++deadline.tv_sec;
+      deadline.tv_nsec -= 1000000000L;
+   }
+
+   pthread_mutex_lock(&workerlock);
+   for( i = 0; i < ENGINE_MAXWORKERS && w == NULL; ++i )
+   {
+      if( workers[i] == NULL )
+      {
+         WORKER* nw = calloc(1, sizeof(WORKER));
+         if( nw == NULL )
+            break;
+         pthread_cond_init(&nw->wake, NULL);
+         nw->state = WORKER_IDLE;
+         if( pthread_create(&nw->thread, NULL, workermain, nw) != 0 )
+         {
+            pthread_cond_destroy(&nw->wake);
+            free(nw);
+            break;
+         }
+         workers[i] = nw;
+      }
+      if( workers[i]->state == WORKER_IDLE )
+         w = workers[i];
+   }
+   if( w == NULL )
+   {
+      /* all workers are stuck in slow evaluations */
+      pthread_mutex_unlock(&workerlock);
+      return -1;
+   }
+
+   w->cache = cache;
+   w->key = key;
+   strcpy(w->prop, Prop);
+   strcpy(w->name1, Name1);
+   strcpy(w->name2, Name2);
+   strcpy(w->fluid, Fluid);
+   w->val1 = Val1;
+   w->val2 = Val2;
+   w->derivrequest = derivrequest;
+   w->state = WORKER_BUSY;
+   pthread_cond_signal(&w->wake);
+
+   while( w->state == WORKER_BUSY )
+      if( pthread_cond_timedwait(&workerdone, &workerlock, &deadline) == ETIMEDOUT )
+         break;
+
+   if( w->state == WORKER_DONE )
+   {
+      rc = w->rc;
+      memcpy(d, w->d, 6 * sizeof(double));
+      memcpy(errmsg, w->errmsg, ENGINE_MSGSIZE);
+      w->state = WORKER_IDLE;
+   }
+   else
+   {
+      w->state = WORKER_ABANDONED;
+      rc = -1;
+   }
+   pthread_mutex_unlock(&workerlock);
+
+   return rc;
+}
+
+/** state to be evaluated speculatively */
+typedef struct
+{
+   PROPSSICACHE*    cache;
+   uint64_t         key;
+   char             prop[64];
+   char             name1[16];
+   char             name2[16];
+   char             fluid[ENGINE_MSGSIZE];
+   double           val1;
+   double           val2;
+   int              derivrequest;
+} SPECJOB;
+
+/** recently speculated state, to count hits */
+typedef struct
+{
+   uint64_t         key;
+   double           val1;
+   double           val2;
+} SPECDONE;
+
+static SPECJOB specjobs[ENGINE_NSPEC];  /* stack, the latest prediction is evaluated first */
+static int nspecjobs = 0;
+static SPECDONE specdone[ENGINE_NLAST];
+static double speccredit = 0.0;         /* CPU time the speculative thread may still spend */
+static double speccost = 0.0;           /* average CPU time of a speculative evaluation */
+static int specstarted = 0;
+static int specstop = 0;                /* asks the speculative thread to exit, see engineshutdown() */
+static pthread_t specthread;
+static pthread_mutex_t speclock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t specwake = PTHREAD_COND_INITIALIZER;
+
+/** Returns the slot of a state in specdone */
+static SPECDONE* specslot(
+   uint64_t              key,
+   double                Val1,
+   double                Val2
+   )
+{
+   uint64_t h1, h2;
+
+   memcpy(&h1, &Val1, sizeof(h1));
+   memcpy(&h2, &Val2, sizeof(h2));
+   h1 = (key ^ h1 ^ (h2 * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+   return &specdone[(h1 >> 32) % ENGINE_NLAST];
+}
+
+static double cputime(
+   void
+   )
+{
+   struct timespec t;
+
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+   return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void* specmain(
+   void*                 arg
+   )
+{
+   SPECJOB job;
+   double d[6];
+   char errmsg[ENGINE_MSGSIZE];
+
+   (void)arg;
+   pthread_mutex_lock(&speclock);
+   for( ;; )
+   {
+      double cost = -1.0;
+
+      /* strict budget: only start an evaluation that the remaining time is likely to cover */
+      while( !specstop && (nspecjobs == 0 || speccredit <= 0.0 || speccredit < speccost) )
+         pthread_cond_wait(&specwake, &speclock);
+      if( specstop )
+         break;
+      job = specjobs[--nspecjobs];
+      pthread_mutex_unlock(&speclock);
+
+      if( !cachelookup(job.cache, job.key, job.val1, job.val2, job.derivrequest, d) )
+      {
+         cost = cputime();
+         if( evalraw(job.prop, job.name1, job.val1, job.name2, job.val2, job.fluid, job.derivrequest, d, errmsg) == 0 )
+            cacheinsert(job.cache, job.key, job.val1, job.val2, job.derivrequest, d);
+         cost = cputime() - cost;
+      }
+
+      pthread_mutex_lock(&speclock);
+      if( cost >= 0.0 )
+      {
+         SPECDONE* done = specslot(job.key, job.val1, job.val2);
+         speccredit -= cost;
+         speccost = speccost > 0.0 ? 0.8 * speccost + 0.2 * cost : cost;
+         done->key = job.key;
+         done->val1 = job.val1;
+         done->val2 = job.val2;
+         ++enginestats.speculated;
+      }
+   }
+   pthread_mutex_unlock(&speclock);
+   return NULL;
+}
+
+/** Queues a state for speculative evaluation */
+static void specpush(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest
+   )
+{
+   SPECJOB* job;
+
+   if( !isfinite(Val1) || !isfinite(Val2) )
+      return;
+   if( nspecjobs == ENGINE_NSPEC )
+   {
+      memmove(&specjobs[0], &specjobs[1], (ENGINE_NSPEC - 1) * sizeof(SPECJOB));
+      --nspecjobs;
+   }
+   job = &specjobs[nspecjobs++];
+   job->cache = cache;
+   job->key = key;
+   strcpy(job->prop, Prop);
+   strcpy(job->name1, Name1);
+   strcpy(job->name2, Name2);
+   strcpy(job->fluid, Fluid);
+   job->val1 = Val1;
+   job->val2 = Val2;
+   job->derivrequest = derivrequest;
+}
+
+/** Queues the states likely to be asked for after the given one and grants CPU time for them
+ *
+ * Only takes locks that the speculative thread holds for bookkeeping,
+ * never during an evaluation.
+ */
+static void speculate(
+   PROPSSICACHE*         cache,
+   uint64_t              key,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest
+   )
+{
+   PREVSTATE* prev = &prevstates[key % ENGINE_NLAST];
+   SPECJOB* job = NULL;
+
+   if( strlen(Prop) >= sizeof(job->prop) || strlen(Name1) >= sizeof(job->name1)
+      || strlen(Name2) >= sizeof(job->name2) || strlen(Fluid) >= sizeof(job->fluid) )
+      return;
+
+   pthread_mutex_lock(&speclock);
+   if( !specstarted )
+   {
+      if( pthread_create(&specthread, NULL, specmain, NULL) != 0 )
+      {
+         /* run without speculation */
+         specbudget = 0.0;
+         pthread_mutex_unlock(&speclock);
+         return;
+      }
+      specstarted = 1;
+   }
+
+   if( prev->key == key )
+   {
+      double s1 = Val1 - prev->val1;
+      double s2 = Val2 - prev->val2;
+      int level = prev->maxlevel > derivrequest ? prev->maxlevel : derivrequest;
+
+      if( s1 != 0.0 || s2 != 0.0 )
+      {
+         specpush(cache, key, Prop, Name1, Val1 + 0.5 * s1, Name2, Val2 + 0.5 * s2, Fluid, level);
+         specpush(cache, key, Prop, Name1, Val1 + s1, Name2, Val2 + s2, Fluid, level);
+      }
+      /* line searches ask for values first and for derivatives at the accepted point */
+      if( derivrequest < prev->maxlevel )
+         specpush(cache, key, Prop, Name1, Val1, Name2, Val2, Fluid, prev->maxlevel);
+      if( derivrequest > prev->maxlevel )
+         prev->maxlevel = derivrequest;
+   }
+   else
+   {
+      prev->key = key;
+      prev->maxlevel = derivrequest;
+   }
+   prev->val1 = Val1;
+   prev->val2 = Val2;
+
+   speccredit = speccredit + specbudget < specbudget ? speccredit + specbudget : specbudget;
+   pthread_cond_signal(&specwake);
+   pthread_mutex_unlock(&speclock);
+}
+
+/** Counts a cache hit on a speculatively evaluated state */
+static void spechit(
+   uint64_t              key,
+   double                Val1,
+   double                Val2
+   )
+{
+   SPECDONE* done;
+
+   pthread_mutex_lock(&speclock);
+   done = specslot(key, Val1, Val2);
+   if( done->key == key && done->val1 == Val1 && done->val2 == Val2 )
+   {
+      ++enginestats.spechits;
+      done->key = 0;
+   }
+   pthread_mutex_unlock(&speclock);
+}
+
+#endif
+
+void engineshutdown(
+   void
+   )
+{
+#if !defined(_WIN32)
+   struct timespec deadline;
+   int abandoned;
+   int i;
+
+   /* abandoned evaluations complete, but their results are dropped; they are waited for at most for the time budget */
+   clock_gettime(CLOCK_REALTIME, &deadline);
+   deadline.tv_sec += (time_t)budget;
+   deadline.tv_nsec += (long)((budget - floor(budget)) * 1e9);
+   if( deadline.tv_nsec >= 1000000000L )
+   {
+      ++deadline.tv_sec;
+      deadline.tv_nsec -= 1000000000L;
+   }
+   pthread_mutex_lock(&workerlock);
+   workerstop = 1;
+   for( i = 0; i < ENGINE_MAXWORKERS; ++i )
+      if( workers[i] != NULL )
+      {
+         workers[i]->cache = NULL;
+         pthread_cond_signal(&workers[i]->wake);
+      }
+   for( ;; )
+   {
+      abandoned = 0;
+      for( i = 0; i < ENGINE_MAXWORKERS; ++i )
+         if( workers[i] != NULL && workers[i]->state == WORKER_ABANDONED )
+            ++abandoned;
+      if( abandoned == 0 || (budget > 0.0 && pthread_cond_timedwait(&workerdone, &workerlock, &deadline) == ETIMEDOUT) )
+         break;
+      if( budget <= 0.0 )
+         pthread_cond_wait(&workerdone, &workerlock);
+   }
+   /* workers still in a slow evaluation finish it on their own */
+   for( i = 0; i < ENGINE_MAXWORKERS; ++i )
+      if( workers[i] != NULL && workers[i]->state == WORKER_ABANDONED )
+      {
+         workers[i]->orphaned = 1;
+         pthread_detach(workers[i]->thread);
+         workers[i] = NULL;
+      }
+   pthread_mutex_unlock(&workerlock);
+   for( i = 0; i < ENGINE_MAXWORKERS; ++i )
+      if( workers[i] != NULL )
+      {
+         pthread_join(workers[i]->thread, NULL);
+         pthread_cond_destroy(&workers[i]->wake);
+         free(workers[i]);
+         workers[i] = NULL;
+      }
+   workerstop = 0;
+
+   pthread_mutex_lock(&speclock);
+   nspecjobs = 0;
+   speccredit = 0.0;
+   if( specstarted )
+   {
+      specstop = 1;
+      pthread_cond_signal(&specwake);
+      pthread_mutex_unlock(&speclock);
+      /* an evaluation in progress completes while its cache still exists */
+      pthread_join(specthread, NULL);
+      pthread_mutex_lock(&speclock);
+      specstarted = 0;
+      specstop = 0;
+   }
+   pthread_mutex_unlock(&speclock);
+#endif
+}
+
+int enginebudget(
+   char*                 errmsg
+   )
+{
+   const char* env = getenv("PROPSSI_BUDGET");
+   char* end;
+
+   errmsg[0] = '\0';
+   budget = 0.0;
+   fallback = FALLBACK_ERROR;
+   specbudget = 0.0;
+
+   if( getenv("PROPSSI_SPECULATE") != NULL && getenv("PROPSSI_SPECULATE")[0] != '\0' )
+   {
+      const char* spec = getenv("PROPSSI_SPECULATE");
+      specbudget = strtod(spec, &end) / 1000.0;
+      if( *end != '\0' || !(specbudget >= 0.0) )
+      {
+         snprintf(errmsg, ENGINE_MSGSIZE, "Invalid speculation budget PROPSSI_SPECULATE=%.100s.", spec);
+         specbudget = 0.0;
+         return 1;
+      }
+#if defined(_WIN32)
+      specbudget = 0.0;
+#endif
+   }
+
+   if( env == NULL || env[0] == '\0' )
+      return 0;
+
+   budget = strtod(env, &end) / 1000.0;
+   if( *end != '\0' || !(budget >= 0.0) )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Invalid time budget PROPSSI_BUDGET=%.100s.", env);
+      budget = 0.0;
+      return 1;
+   }
+#if defined(_WIN32)
+   budget = 0.0;
+#endif
+
+   env = getenv("PROPSSI_FALLBACK");
+   if( env == NULL || env[0] == '\0' || strcmp(env, "error") == 0 )
+      fallback = FALLBACK_ERROR;
+   else if( strcmp(env, "last") == 0 )
+      fallback = FALLBACK_LAST;
+   else if( strcmp(env, "tabular") == 0 )
+      fallback = FALLBACK_TABULAR;
+   else
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Invalid fallback PROPSSI_FALLBACK=%.100s, expected error, last, or tabular.", env);
+      return 1;
+   }
+   return 0;
+}
+
+int enginenegative(
+   char*                 errmsg
+   )
+{
+   const char* env = getenv("PROPSSI_NEGCACHE");
+   char* end;
+
+   errmsg[0] = '\0';
+   /* results of another configuration or backend may differ */
+   memset(negentries, 0, sizeof(negentries));
+   memset(negnext, 0, sizeof(negnext));
+   negbox = 0.0;
+   if( env == NULL || env[0] == '\0' )
+      return 0;
+   if( strcmp(env, "off") == 0 )
+   {
+      negbox = -1.0;
+      return 0;
+   }
+   negbox = strtod(env, &end);
+   if( *end != '\0' || !(negbox >= 0.0 && negbox < 1.0) )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Invalid box PROPSSI_NEGCACHE=%.100s, expected a relative half-width or off.", env);
+      negbox = 0.0;
+      return 1;
+   }
+   return 0;
+}
+
+int negativefind(
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   char*                 errmsg
+   )
+{
+   uint64_t key;
+   int i;
+
+   if( negbox < 0.0 )
+      return 0;
+   key = cachekey(Prop, Name1, Name2, Fluid);
+   for( i = 0; i < ENGINE_NEGWAYS; ++i )
+   {
+      const NEGENTRY* e = &negentries[key % ENGINE_NEGSETS][i];
+      if( e->key == key && derivrequest >= e->level && Val1 >= e->lo1 && Val1 <= e->hi1 && Val2 >= e->lo2 && Val2 <= e->hi2 )
+      {
+         snprintf(errmsg, ENGINE_MSGSIZE, "%.*s", (int)sizeof(e->msg) - 1, e->msg);
+         ++enginestats.avoided;
+         return 1;
+      }
+   }
+   return 0;
+}
+
+void negativeadd(
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   const char*           errmsg
+   )
+{
+   uint64_t key;
+   NEGENTRY* e;
+   int set;
+
+   if( negbox < 0.0 || !isfinite(Val1) || !isfinite(Val2) )
+      return;
+   key = cachekey(Prop, Name1, Name2, Fluid);
+   set = (int)(key % ENGINE_NEGSETS);
+   e = &negentries[set][negnext[set]];
+   negnext[set] = (negnext[set] + 1) % ENGINE_NEGWAYS;
+   e->key = key;
+   e->level = derivrequest;
+   e->lo1 = Val1 - negbox * fabs(Val1);
+   e->hi1 = Val1 + negbox * fabs(Val1);
+   e->lo2 = Val2 - negbox * fabs(Val2);
+   e->hi2 = Val2 + negbox * fabs(Val2);
+   snprintf(e->msg, sizeof(e->msg), "%s", errmsg);
+}
+
+int enginefidelity(
+   char*                 errmsg
+   )
+{
+   const char* env = getenv("PROPSSI_FIDELITY");
+   size_t n;
+
+   errmsg[0] = '\0';
+   fidbackend[0] = '\0';
+   fidstep = 1e-3;
+   fidpolish = 0;
+   memset(fidstates, 0, sizeof(fidstates));
+   if( env == NULL || env[0] == '\0' )
+      return 0;
+
+   n = strcspn(env, ":");
+   if( env[n] == ':' )
+   {
+      char* end;
+      fidstep = strtod(env + n + 1, &end);
+      if( *end != '\0' || !(fidstep > 0.0) )
+      {
+         snprintf(errmsg, ENGINE_MSGSIZE, "Invalid step in PROPSSI_FIDELITY=%.100s.", env);
+         fidstep = 1e-3;
+         return 1;
+      }
+   }
+   if( n == 7 && strncmp(env, "tabular", n) == 0 )
+      strcpy(fidbackend, "BICUBIC&HEOS");
+   else if( n == 5 && strncmp(env, "cubic", n) == 0 )
+      strcpy(fidbackend, "PR");
+   else
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Invalid fidelity PROPSSI_FIDELITY=%.100s, expected tabular or cubic with optional :step.", env);
+      return 1;
+   }
+   return 0;
+}
+
+int enginepolish(
+   int                   polish
+   )
+{
+   int old = fidpolish;
+
+   if( polish && !old && fidbackend[0] != '\0' )
+      ++enginestats.polishes;
+   /* a new round of solves starts with approximations again */
+   if( !polish )
+      memset(fidstates, 0, sizeof(fidstates));
+   fidpolish = polish;
+   return old;
+}
+
+/** Returns the cell of an input value, ENGINE_FIDCELL wide relative to the value */
+static uint64_t fidcell(
+   double                v
+   )
+{
+   if( !isfinite(v) || !(fabs(v) > 1e-300) )
+      return 0;
+   return 2 * (uint64_t)(int64_t)floor(log(fabs(v)) / log1p(ENGINE_FIDCELL)) + (v < 0.0) + 1;
+}
+
+/** Computes the key of the neighbourhood of a state for the fidelity */
+static uint64_t fidkey(
+   uint64_t              key,
+   double                Val1,
+   double                Val2
+   )
+{
+   uint64_t h = key;
+
+   h = (h ^ fidcell(Val1)) * 0xff51afd7ed558ccdULL;
+   h ^= h >> 33;
+   h = (h ^ fidcell(Val2)) * 0xc4ceb9fe1a85ec53ULL;
+   h ^= h >> 33;
+   return h != 0 ? h : 1;
+}
+
+/** Checks whether a state may be served by the approximation, i.e., whether its neighbourhood still sees far steps between calls */
+static int approximate(
+   uint64_t              key,
+   double                Val1,
+   double                Val2
+   )
+{
+   FIDSTATE* s;
+   double step;
+
+   key = fidkey(key, Val1, Val2);
+   s = &fidstates[key % ENGINE_NFID];
+   if( s->key != key )
+   {
+      s->key = key;
+      s->val1 = Val1;
+      s->val2 = Val2;
+      s->exact = 0;
+      return 1;
+   }
+   if( s->exact )
+      return 0;
+   step = fmax(fabs(Val1 - s->val1) / fmax(fabs(Val1), 1e-300), fabs(Val2 - s->val2) / fmax(fabs(Val2), 1e-300));
+   /* the solver asking for derivatives at the same point again is no step */
+   if( step == 0.0 )
+      return 1;
+   s->val1 = Val1;
+   s->val2 = Val2;
+   if( step >= fidstep )
+      return 1;
+   s->exact = 1;
+   ++enginestats.fidelityswitches;
+   return 0;
+}
+
+int evalprops(
+   PROPSSICACHE*         cache,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   LASTSTATE* last;
+   uint64_t key;
+   double tol1, tol2;
+   int rc;
+
+   ++enginestats.lookups;
+   key = cachekey(Prop, Name1, Name2, Fluid);
+   if( cachelookup(cache, key, Val1, Val2, derivrequest, d) )
+   {
+      ++enginestats.cachehits;
+#if !defined(_WIN32)
+      if( specbudget > 0.0 && cache != NULL )
+      {
+         spechit(key, Val1, Val2);
+         speculate(cache, key, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest);
+      }
+#endif
+      return 0;
+   }
+
+   /* a state with the same inputs within the tolerances and at least a gradient, to correct the value */
+   tol1 = cachetolerance(cache, Name1);
+   tol2 = cachetolerance(cache, Name2);
+   if( tol1 > 0.0 || tol2 > 0.0 )
+   {
+      double x1, x2, d0;
+      int level;
+
+      if( cachelookupnear(cache, key, Val1, Val2, tol1, tol2, derivrequest > 0 ? derivrequest : 1, d, &x1, &x2, &level) )
+      {
+         d0 = d[0];
+         taylor(d, level, Val1 - x1, Val2 - x2);
+         if( d[0] != d0 )
+         {
+            double correction = fabs(d[0] - d0) / (d0 != 0.0 ? fabs(d0) : 1.0);
+            if( correction > enginestats.maxcorrection )
+               enginestats.maxcorrection = correction;
+         }
+         ++enginestats.cachehits;
+         ++enginestats.nearhits;
+         return 0;
+      }
+   }
+
+   if( negativefind(Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, errmsg) )
+      return 1;
+
+   if( fidbackend[0] != '\0' && !fidpolish && strstr(Fluid, "::") == NULL && approximate(key, Val1, Val2) )
+   {
+      char approx[ENGINE_MSGSIZE];
+
+      /* approximations are not cached, so the cache holds full equation of state results only */
+      snprintf(approx, sizeof(approx), "%s::%s", fidbackend, Fluid);
+      if( evalraw(Prop, Name1, Val1, Name2, Val2, approx, derivrequest, d, errmsg) == 0 )
+      {
+         ++enginestats.approximations;
+         return 0;
+      }
+      /* e.g. second derivatives of tables are not available: evaluate by the full equation of state */
+   }
+
+   ++enginestats.evaluations;
+#if !defined(_WIN32)
+   if( budget > 0.0 )
+   {
+      rc = evalbudget(cache, key, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, errmsg);
+      if( rc < 0 )
+      {
+         ++enginestats.overbudget;
+         rc = evalfallback(key, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, errmsg);
+         if( rc != 0 )
+            ++enginestats.failures;
+         /* fallback values are approximations, so they are not cached */
+         return rc;
+      }
+   }
+   else
+#endif
+      rc = evalraw(Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, d, errmsg);
+
+   if( rc != 0 )
+   {
+      ++enginestats.failures;
+      negativeadd(Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest, errmsg);
+      return rc;
+   }
+
+   cacheinsert(cache, key, Val1, Val2, derivrequest, d);
+   if( (tol1 > 0.0 || tol2 > 0.0) && derivrequest > 0 )
+      cacheinsertnear(cache, key, Val1, Val2, tol1, tol2, derivrequest, d);
+#if !defined(_WIN32)
+   if( specbudget > 0.0 && cache != NULL )
+      speculate(cache, key, Prop, Name1, Val1, Name2, Val2, Fluid, derivrequest);
+#endif
+   if( fallback == FALLBACK_LAST )
+   {
+      last = &laststates[key % ENGINE_NLAST];
+      last->key = key;
+      last->val1 = Val1;
+      last->val2 = Val2;
+      last->level = derivrequest;
+      memcpy(last->d, d, 6 * sizeof(double));
+   }
+   return 0;
+}
+
+/** grid of samples of evalbounds() per input */
+#define ENGINE_BOUNDGRID 17
+
+/** number of threads evalbounds() samples on at most */
+#define ENGINE_BOUNDTHREADS 64
+
+/** samples of evalbounds() on one thread */
+typedef struct
+{
+   const char*      prop;
+   const char*      name1;
+   const char*      name2;
+   const char*      fluid;
+   const double*    v1;
+   const double*    v2;
+   double*          d;                 /**< three words per sample: value and first derivatives, NaN if failed */
+   int              first;
+   int              last;
+   int              untilok;           /**< whether to stop after the first sample that could be evaluated */
+   char             errmsg[ENGINE_MSGSIZE]; /**< message of the last sample that failed */
+} BOUNDWORK;
+
+static void* boundsample(
+   void*                 arg
+   )
+{
+   BOUNDWORK* w = (BOUNDWORK*)arg;
+   double d[6];
+   int i;
+
+   for( i = w->first; i < w->last; ++i )
+   {
+      int rc = evalraw(w->prop, w->name1, w->v1[i], w->name2, w->v2[i], w->fluid, 1, d, w->errmsg);
+
+      if( rc != 0 )
+         d[0] = d[1] = d[2] = NAN;
+      memcpy(&w->d[3*i], d, 3 * sizeof(double));
+      if( rc == 0 && w->untilok )
+      {
+         w->last = i + 1;
+         break;
+      }
+   }
+   return NULL;
+}
+
+/** Tightens the sampled extremum by projected steepest descent (sign 1) or ascent (sign -1) from a sample */
+static void boundsearch(
+   const char*           Prop,
+   const char*           Name1,
+   const char*           Name2,
+   const char*           Fluid,
+   const double          lo[2],
+   const double          hi[2],
+   const double          start[2],
+   const double          d0[3],
+   double                sign,
+   double*               best
+   )
+{
+   char errmsg[ENGINE_MSGSIZE];
+   double x[2] = { start[0], start[1] };
+   double g[2], d[6];
+   double fx = d0[0];
+   double step = 1.0 / (ENGINE_BOUNDGRID - 1);
+   int k;
+
+   /* steps in coordinates scaled to the box, along the scaled gradient */
+   g[0] = d0[1] * (hi[0] - lo[0]);
+   g[1] = d0[2] * (hi[1] - lo[1]);
+   while( step > 1e-4 )
+   {
+      double norm = sqrt(g[0] * g[0] + g[1] * g[1]);
+      double y[2];
+
+      if( !(norm > 0.0) )
+         break;
+      for( k = 0; k < 2; ++k )
+      {
+         y[k] = x[k] - sign * step * g[k] / norm * (hi[k] - lo[k]);
+         y[k] = y[k] < lo[k] ? lo[k] : y[k] > hi[k] ? hi[k] : y[k];
+      }
+      if( (y[0] == x[0] && y[1] == x[1])
+         || evalraw(Prop, Name1, y[0], Name2, y[1], Fluid, 1, d, errmsg) != 0
+         || !(sign * d[0] < sign * fx) )
+      {
+         step *= 0.5;
+         continue;
+      }
+      x[0] = y[0];
+      x[1] = y[1];
+      fx = d[0];
+      g[0] = d[1] * (hi[0] - lo[0]);
+      g[1] = d[2] * (hi[1] - lo[1]);
+   }
+   if( sign * fx < sign * *best )
+      *best = fx;
+}
+
+int evalbounds(
+   const char*           Prop,
+   const char*           Name1,
+   double                Lo1,
+   double                Hi1,
+   const char*           Name2,
+   double                Lo2,
+   double                Hi2,
+   const char*           Fluid,
+   int                   nthreads,
+   double                bounds[2],
+   int*                  failed,
+   char*                 errmsg
+   )
+{
+   const int n = ENGINE_BOUNDGRID;
+   double v1[ENGINE_BOUNDGRID * ENGINE_BOUNDGRID];
+   double v2[ENGINE_BOUNDGRID * ENGINE_BOUNDGRID];
+   double d[3 * ENGINE_BOUNDGRID * ENGINE_BOUNDGRID];
+   double lo[2] = { Lo1, Lo2 };
+   double hi[2] = { Hi1, Hi2 };
+   double h[2];
+   BOUNDWORK warmup;
+   int argbest[2] = { -1, -1 };
+   int i, j, k, m;
+
+   *failed = 0;
+   if( !(Lo1 <= Hi1) || !(Lo2 <= Hi2) )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Empty box.");
+      return 1;
+   }
+   h[0] = (Hi1 - Lo1) / (n - 1);
+   h[1] = (Hi2 - Lo2) / (n - 1);
+   for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j )
+      {
+         v1[i*n + j] = Lo1 + i * h[0];
+         v2[i*n + j] = Lo2 + j * h[1];
+      }
+
+   /* CoolProp loads its fluid data on first use, which must not happen on several threads at once:
+    * the samples up to the first that could be evaluated are taken here, and their message is CoolProp's
+    */
+   warmup.prop = Prop;
+   warmup.name1 = Name1;
+   warmup.name2 = Name2;
+   warmup.fluid = Fluid;
+   warmup.v1 = v1;
+   warmup.v2 = v2;
+   warmup.d = d;
+   warmup.first = 0;
+   warmup.last = n*n;
+   warmup.untilok = 1;
+   warmup.errmsg[0] = '\0';
+   boundsample(&warmup);
+   m = warmup.last;
+#if !defined(_WIN32)
+   if( nthreads > 1 && m < n*n )
+   {
+      BOUNDWORK work[ENGINE_BOUNDTHREADS];
+      pthread_t threads[ENGINE_BOUNDTHREADS];
+      int started[ENGINE_BOUNDTHREADS];
+      int t;
+
+      if( nthreads > ENGINE_BOUNDTHREADS )
+         nthreads = ENGINE_BOUNDTHREADS;
+      for( t = 0; t < nthreads; ++t )
+      {
+         work[t] = warmup;
+         work[t].first = m + (n*n - m) * t / nthreads;
+         work[t].last = m + (n*n - m) * (t+1) / nthreads;
+         work[t].untilok = 0;
+         started[t] = t > 0 && pthread_create(&threads[t], NULL, boundsample, &work[t]) == 0;
+      }
+      boundsample(&work[0]);
+      for( t = 1; t < nthreads; ++t )
+         if( started[t] )
+            pthread_join(threads[t], NULL);
+         else
+            boundsample(&work[t]);
+   }
+   else
+#endif
+   if( m < n*n )
+   {
+      BOUNDWORK w = warmup;
+      w.first = m;
+      w.last = n*n;
+      w.untilok = 0;
+      boundsample(&w);
+   }
+
+   bounds[0] = HUGE_VAL;
+   bounds[1] = -HUGE_VAL;
+   for( k = 0; k < n*n; ++k )
+   {
+      if( !isfinite(d[3*k]) )
+      {
+         ++*failed;
+         continue;
+      }
+      if( d[3*k] < bounds[0] )
+      {
+         bounds[0] = d[3*k];
+         argbest[0] = k;
+      }
+      if( d[3*k] > bounds[1] )
+      {
+         bounds[1] = d[3*k];
+         argbest[1] = k;
+      }
+   }
+   if( argbest[0] < 0 )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "No state in the box could be evaluated: %s", warmup.errmsg);
+      return 1;
+   }
+
+   /* an extremum between two samples with slopes of opposite sign is bounded by the intersection of their tangents */
+   for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j )
+         for( k = 0; k < 2; ++k )
+         {
+            int a = i*n + j;
+            int b = k == 0 ? a + n : a + 1;
+            double ga, gb, s, v;
+
+            if( (k == 0 ? i : j) == n-1 || !isfinite(d[3*a]) || !isfinite(d[3*b]) || !isfinite(d[3*a+1+k]) || !isfinite(d[3*b+1+k]) )
+               continue;
+            ga = d[3*a+1+k];
+            gb = d[3*b+1+k];
+            if( !((ga < 0.0 && gb > 0.0) || (ga > 0.0 && gb < 0.0)) )
+               continue;
+            s = (d[3*b] - d[3*a] - gb * h[k]) / (ga - gb);
+            if( !(s >= 0.0 && s <= h[k]) )
+               continue;
+            v = d[3*a] + ga * s;
+            if( ga < 0.0 && v < bounds[0] )
+               bounds[0] = v;
+            if( ga > 0.0 && v > bounds[1] )
+               bounds[1] = v;
+         }
+
+   /* extrema inside cells */
+   for( k = 0; k < 2; ++k )
+   {
+      int b = argbest[k];
+      double start[2] = { v1[b], v2[b] };
+      if( isfinite(d[3*b+1]) && isfinite(d[3*b+2]) )
+         boundsearch(Prop, Name1, Name2, Fluid, lo, hi, start, &d[3*b], k == 0 ? 1.0 : -1.0, &bounds[k]);
+   }
+   return 0;
+}
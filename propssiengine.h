@@ -0,0 +1,227 @@
+/** Evaluation engine of the extrinsic CoolProp library
+ *
+ * These functions evaluate CoolProp states independently of the GAMS
+ * extrinsic function API, so that they can be shared by the function
+ * library (propssicclib.c) and the property server (propssid.c).
+ */
+
+#ifndef PROPSSIENGINE_H_
+#define PROPSSIENGINE_H_
+
+#include "propssicache.h"
+
+/** size of error message buffers of the engine */
+#define ENGINE_MSGSIZE 256
+
+/** counters of the engine, reported by the function library if PROPSSI_STATS is set */
+typedef struct
+{
+   unsigned long         lookups;         /**< calls of evalprops() */
+   unsigned long         cachehits;       /**< calls answered by the state cache */
+   unsigned long         nearhits;        /**< of those, answered by a state within the tolerances of PROPSSI_CACHETOL */
+   unsigned long         evaluations;     /**< states evaluated by CoolProp */
+   unsigned long         failures;        /**< states CoolProp could not evaluate */
+   unsigned long         avoided;         /**< calls failed by the negative cache without calling CoolProp */
+   unsigned long         overbudget;      /**< evaluations that exceeded the time budget */
+   unsigned long         fallbacks;       /**< of those, answered by the fallback */
+   unsigned long         speculated;      /**< states evaluated speculatively in the background */
+   unsigned long         spechits;        /**< cache hits on speculatively evaluated states */
+   unsigned long         approximations;  /**< calls answered by the approximation of PROPSSI_FIDELITY */
+   unsigned long         fidelityswitches; /**< states switched to the full equation of state by a small step */
+   unsigned long         polishes;        /**< switches of all states to the full equation of state by enginepolish() */
+   double                maxcorrection;   /**< largest relative change of a value by the Taylor step of a near hit */
+} ENGINESTATS;
+
+/** statistics of this process */
+extern ENGINESTATS enginestats;
+
+/** Looks up the CoolProp input pair index for two PropsSI input names
+ *
+ * @return input pair index, or -1 if the combination is not a CoolProp input pair.
+ */
+long inputpair(
+   const char*           Name1,           /**< first input property (P, T, D, U, H, S, or Q) */
+   const char*           Name2,           /**< second input property */
+   int*                  swap             /**< buffer to store whether the values need to be swapped for the pair */
+   );
+
+/** Configures the time budget of evaluations from the environment
+ *
+ * Near the critical point or in metastable regions, a single flash may
+ * take milliseconds. If PROPSSI_BUDGET is set to a positive number of
+ * milliseconds, evalprops() runs CoolProp on worker threads and gives up
+ * waiting when the budget is exceeded. The evaluation then fails, or, as
+ * selected by PROPSSI_FALLBACK, is answered by
+ *   - last:    the last state evaluated for the same output, input names,
+ *              and fluid, extrapolated to first order by its derivatives,
+ *   - tabular: CoolProp's bicubic tables (BICUBIC&HEOS backend).
+ * The abandoned evaluation still completes in the background and stores
+ * its result in the state cache.
+ *
+ * If PROPSSI_SPECULATE is set to a positive number of milliseconds, a
+ * background thread evaluates the states the solver is likely to ask for
+ * next and stores them in the state cache: the same state with the
+ * highest derivatives asked for before, and the states one and half a
+ * step further along the last step for the same output, input names, and
+ * fluid. Each served call grants the thread that much CPU time; unused
+ * time does not accumulate, and an evaluation is only started if the time
+ * left covers the average cost of an evaluation. Speculation requires the
+ * state cache.
+ *
+ * Neither is available on Windows.
+ *
+ * @return 0 if successful, <> 0 if the configuration is invalid (errmsg is set then).
+ */
+int enginebudget(
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Stops the background evaluations of the engine
+ *
+ * Drops the states queued for speculation and the results of evaluations
+ * abandoned for the time budget, and waits for the speculative thread to
+ * finish its current evaluation and exit. Workers of the time budget
+ * still in an abandoned evaluation are waited for at most for the budget;
+ * those that do not finish by then are detached and free themselves when
+ * CoolProp returns, so that the budget also bounds the shutdown. Since
+ * background evaluations store their results in the state cache they were
+ * started for, this must be called before that cache is freed. A later
+ * call of evalprops() starts the threads anew.
+ */
+void engineshutdown(
+   void
+   );
+
+/** Configures and clears the negative cache
+ *
+ * Solvers often retry states that CoolProp could not evaluate, or states
+ * close to them, and each retry pays the full cost of the failure. The
+ * inputs of failed states are therefore kept in a small negative cache
+ * per output, input names, and fluid; a state asking for at least the
+ * same derivatives within the box of relative
+ * half-width PROPSSI_NEGCACHE (default 0, i.e., the same state) around a
+ * failed state fails at once with the stored message. Failures due to
+ * the time budget are not kept. PROPSSI_NEGCACHE=off disables the cache.
+ * Since another configuration may evaluate the states, the cache is
+ * cleared by every call, i.e., by libinit.
+ *
+ * @return 0 if successful, <> 0 if the configuration is invalid (errmsg is set then).
+ */
+int enginenegative(
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Looks up a state in the negative cache
+ *
+ * @return 1 if the state lies in the box of a failed state (errmsg is set then), 0 otherwise.
+ */
+int negativefind(
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name, including a backend */
+   int                   derivrequest,    /**< highest derivative to compute */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Records a failed state in the negative cache */
+void negativeadd(
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name, including a backend */
+   int                   derivrequest,    /**< highest derivative asked for */
+   const char*           errmsg           /**< error message of the evaluation */
+   );
+
+/** Configures multi-fidelity evaluation from the environment
+ *
+ * Early iterations of a solver do not need accurate properties. If
+ * PROPSSI_FIDELITY is set to tabular (CoolProp's bicubic tables) or cubic
+ * (Peng-Robinson), optionally followed by :step (default 1e-3), evalprops()
+ * answers a state from that approximation as long as the inputs change by
+ * a relative step of at least step between consecutive calls in the same
+ * neighbourhood. Once a smaller step is seen there, the states of the
+ * neighbourhood are evaluated by the full equation of state from then on.
+ * Calls at the same point, e.g. for derivatives, do not count as steps.
+ * If the approximation cannot evaluate a state, the full equation of state
+ * is used. See also enginepolish().
+ *
+ * A neighbourhood has the same output, input names, and fluid, and inputs
+ * in the same cell of 5% relative width, so that the states of the many
+ * streams of a model sharing, e.g., H(P,T) of Water are followed each by
+ * its own record as long as they are apart. A state stepping into another
+ * cell is approximated until small steps are seen in that cell, too.
+ *
+ * @return 0 if successful, <> 0 if the configuration is invalid (errmsg is set then).
+ */
+int enginefidelity(
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Switches all states to the full equation of state, e.g. before a final solve, or back to multi-fidelity evaluation
+ *
+ * @return previous setting
+ */
+int enginepolish(
+   int                   polish           /**< 1 for the full equation of state, 0 for multi-fidelity evaluation anew */
+   );
+
+/** Evaluates a property and its partial derivatives with respect to the two state inputs.
+ *
+ * The derivatives are taken along the state inputs, i.e., d[1] is the
+ * derivative with respect to Name1 at constant Name2, d[4] is the mixed
+ * second derivative, and so on. Results are looked up in and stored to
+ * the state cache. If PROPSSI_CACHETOL sets tolerances for the inputs, a
+ * state missing the cache is answered from a state within the tolerances
+ * that was stored with at least the gradient: the value, and with second
+ * derivatives also the gradient, are moved to the inputs by a Taylor step.
+ * See enginebudget() for limits on the evaluation time.
+ *
+ * @return 0 if successful, <> 0 if CoolProp could not evaluate the state.
+ */
+int evalprops(
+   PROPSSICACHE*         cache,           /**< state cache, may be NULL */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name */
+   int                   derivrequest,    /**< highest derivative to compute */
+   double                d[6],            /**< buffer for f, df/d1, df/d2, d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Computes lower and upper bounds of a property over a box of the two state inputs
+ *
+ * The property and its gradient are sampled on a regular grid over the
+ * box, on up to nthreads threads. Between two neighbouring samples whose
+ * slopes have opposite signs, the intersection of their tangents bounds
+ * the extremum if the property is convex (or concave) there. Finally,
+ * the best samples are improved by projected steepest descent (ascent).
+ * The bounds are thus sampled, not guaranteed; a model should widen them
+ * by a margin. States that cannot be evaluated are skipped.
+ *
+ * @return 0 if successful, <> 0 if no state in the box could be evaluated (errmsg is set then).
+ */
+int evalbounds(
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Lo1,             /**< lower bound of first input */
+   double                Hi1,             /**< upper bound of first input */
+   const char*           Name2,           /**< second input property */
+   double                Lo2,             /**< lower bound of second input */
+   double                Hi2,             /**< upper bound of second input */
+   const char*           Fluid,           /**< fluid name */
+   int                   nthreads,        /**< number of threads to sample on */
+   double                bounds[2],       /**< buffer to store lower and upper bound */
+   int*                  failed,          /**< buffer to store number of samples that could not be evaluated */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+#endif /* PROPSSIENGINE_H_ */
@@ -0,0 +1,608 @@
+/* Generated equations of state, see propssieosgen.h
+ * This file is created by eosgen.py.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "CoolPropLib.h"
+#include "propssieosgen.h"
+
+/** forward-mode dual number in (T, D)
+ *
+ * Holds the Taylor coefficients of a quantity up to order 3 in T and D,
+ * so that outputs involving first derivatives of the Helmholtz energy,
+ * like pressure or enthalpy, still have exact second derivatives.
+ * The coefficients are stored in the order
+ *   T^0 D^0
+ *   T^1 D^0
+ *   T^0 D^1
+ *   T^2 D^0
+ *   T^1 D^1
+ *   T^0 D^2
+ *   T^3 D^0
+ *   T^2 D^1
+ *   T^1 D^2
+ *   T^0 D^3
+ */
+typedef struct
+{
+   double c[10];
+} DUAL;
+
+static DUAL dualshift(
+   DUAL                  a,
+   double                s
+   )
+{
+   a.c[0] += s;
+   return a;
+}
+
+static DUAL dualscale(
+   DUAL                  a,
+   double                s
+   )
+{
+   a.c[0] *= s;
+   a.c[1] *= s;
+   a.c[2] *= s;
+   a.c[3] *= s;
+   a.c[4] *= s;
+   a.c[5] *= s;
+   a.c[6] *= s;
+   a.c[7] *= s;
+   a.c[8] *= s;
+   a.c[9] *= s;
+   return a;
+}
+
+/** a + s b */
+static DUAL dualaxpy(
+   DUAL                  a,
+   double                s,
+   DUAL                  b
+   )
+{
+   a.c[0] += s * b.c[0];
+   a.c[1] += s * b.c[1];
+   a.c[2] += s * b.c[2];
+   a.c[3] += s * b.c[3];
+   a.c[4] += s * b.c[4];
+   a.c[5] += s * b.c[5];
+   a.c[6] += s * b.c[6];
+   a.c[7] += s * b.c[7];
+   a.c[8] += s * b.c[8];
+   a.c[9] += s * b.c[9];
+   return a;
+}
+
+/** s a + t b */
+static DUAL duallin(
+   double                s,
+   DUAL                  a,
+   double                t,
+   DUAL                  b
+   )
+{
+   a.c[0] = s * a.c[0] + t * b.c[0];
+   a.c[1] = s * a.c[1] + t * b.c[1];
+   a.c[2] = s * a.c[2] + t * b.c[2];
+   a.c[3] = s * a.c[3] + t * b.c[3];
+   a.c[4] = s * a.c[4] + t * b.c[4];
+   a.c[5] = s * a.c[5] + t * b.c[5];
+   a.c[6] = s * a.c[6] + t * b.c[6];
+   a.c[7] = s * a.c[7] + t * b.c[7];
+   a.c[8] = s * a.c[8] + t * b.c[8];
+   a.c[9] = s * a.c[9] + t * b.c[9];
+   return a;
+}
+
+static DUAL dualmul(
+   DUAL                  a,
+   DUAL                  b
+   )
+{
+   DUAL r;
+   r.c[0] = a.c[0] * b.c[0];
+   r.c[1] = a.c[0] * b.c[1] + a.c[1] * b.c[0];
+   r.c[2] = a.c[0] * b.c[2] + a.c[2] * b.c[0];
+   r.c[3] = a.c[0] * b.c[3] + a.c[1] * b.c[1] + a.c[3] * b.c[0];
+   r.c[4] = a.c[0] * b.c[4] + a.c[1] * b.c[2] + a.c[2] * b.c[1] + a.c[4] * b.c[0];
+   r.c[5] = a.c[0] * b.c[5] + a.c[2] * b.c[2] + a.c[5] * b.c[0];
+   r.c[6] = a.c[0] * b.c[6] + a.c[1] * b.c[3] + a.c[3] * b.c[1] + a.c[6] * b.c[0];
+   r.c[7] = a.c[0] * b.c[7] + a.c[1] * b.c[4] + a.c[2] * b.c[3] + a.c[3] * b.c[2] + a.c[4] * b.c[1] + a.c[7] * b.c[0];
+   r.c[8] = a.c[0] * b.c[8] + a.c[1] * b.c[5] + a.c[2] * b.c[4] + a.c[4] * b.c[2] + a.c[5] * b.c[1] + a.c[8] * b.c[0];
+   r.c[9] = a.c[0] * b.c[9] + a.c[2] * b.c[5] + a.c[5] * b.c[2] + a.c[9] * b.c[0];
+   return r;
+}
+
+/** f(a) for a scalar function with Taylor coefficients f[] at the value of a */
+static DUAL dualseries(
+   DUAL                  a,
+   const double          f[4]
+   )
+{
+   DUAL h = a;
+   DUAL r;
+   DUAL hk;
+   int k;
+
+   h.c[0] = 0.0;
+   hk = h;
+   r = dualscale(h, f[1]);
+   r.c[0] = f[0];
+   for( k = 2; k <= 3; ++k )
+   {
+      hk = dualmul(hk, h);
+      r = dualaxpy(r, f[k], hk);
+   }
+   return r;
+}
+
+static DUAL dualexp(
+   DUAL                  a
+   )
+{
+   double e = exp(a.c[0]);
+   double f[4] = { e, e, e / 2.0, e / 6.0 };
+   return dualseries(a, f);
+}
+
+static DUAL duallog(
+   DUAL                  a
+   )
+{
+   double x = 1.0 / a.c[0];
+   double f[4] = { log(a.c[0]), x, -x * x / 2.0, x * x * x / 3.0 };
+   return dualseries(a, f);
+}
+
+/** a^p for a > 0 */
+static DUAL dualpow(
+   DUAL                  a,
+   double                p
+   )
+{
+   double x = pow(a.c[0], p - 3.0);
+   double f[4];
+
+   f[3] = p * (p - 1.0) * (p - 2.0) / 6.0 * x;
+   x *= a.c[0];
+   f[2] = p * (p - 1.0) / 2.0 * x;
+   x *= a.c[0];
+   f[1] = p * x;
+   f[0] = x * a.c[0];
+   return dualseries(a, f);
+}
+
+/** |a|, kept away from 0 where the non-analytic terms are singular */
+static DUAL dualabsnz(
+   DUAL                  a
+   )
+{
+   if( a.c[0] < 0.0 )
+      a = dualscale(a, -1.0);
+   if( a.c[0] < 1e-12 )
+      a.c[0] = 1e-12;
+   return a;
+}
+
+/** partial derivative with respect to T (var = 0) or D (var = 1); the result is exact up to order 2 */
+static DUAL dualdiff(
+   DUAL                  a,
+   int                   var
+   )
+{
+   DUAL r;
+
+   memset(&r, 0, sizeof(r));
+   if( var == 0 )
+   {
+      r.c[0] = 1 * a.c[1];
+      r.c[1] = 2 * a.c[3];
+      r.c[2] = 1 * a.c[4];
+      r.c[3] = 3 * a.c[6];
+      r.c[4] = 2 * a.c[7];
+      r.c[5] = 1 * a.c[8];
+   }
+   else
+   {
+      r.c[0] = 1 * a.c[2];
+      r.c[1] = 1 * a.c[4];
+      r.c[2] = 2 * a.c[5];
+      r.c[3] = 1 * a.c[7];
+      r.c[4] = 2 * a.c[8];
+      r.c[5] = 3 * a.c[9];
+   }
+   return r;
+}
+
+/*
+ * Water (Wagner-JPCRD-2002)
+ */
+
+/** specific Helmholtz energy of Water in J/kg */
+static DUAL helmholtz_Water(
+   DUAL                  T,
+   DUAL                  D
+   )
+{
+   DUAL tau, delta, lnt, lnd, a0, ar, x, u, v, w;
+
+   tau = dualscale(dualpow(T, -1.0), 647.096);
+   delta = dualscale(D, 1.0 / (0.018015268 * 17873.72799560906));
+   lnt = duallog(tau);
+   lnd = duallog(delta);
+   memset(&ar, 0, sizeof(ar));
+   (void)x; (void)u; (void)v; (void)w;
+
+   ar = dualaxpy(ar, 0.012533547935523, dualexp(duallin(1.0, lnd, -0.5, lnt)));
+   ar = dualaxpy(ar, 7.8957634722828, dualexp(duallin(1.0, lnd, 0.875, lnt)));
+   ar = dualaxpy(ar, -8.7803203303561, dualexp(duallin(1.0, lnd, 1.0, lnt)));
+   ar = dualaxpy(ar, 0.31802509345418, dualexp(duallin(2.0, lnd, 0.5, lnt)));
+   ar = dualaxpy(ar, -0.26145533859358, dualexp(duallin(2.0, lnd, 0.75, lnt)));
+   ar = dualaxpy(ar, -0.0078199751687981, dualexp(duallin(3.0, lnd, 0.375, lnt)));
+   ar = dualaxpy(ar, 0.0088089493102134, dualexp(duallin(4.0, lnd, 1.0, lnt)));
+   ar = dualaxpy(ar, -0.66856572307965, dualexp(dualaxpy(duallin(1.0, lnd, 4.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 0.20433810950965, dualexp(dualaxpy(duallin(1.0, lnd, 6.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -6.6212605039687e-05, dualexp(dualaxpy(duallin(1.0, lnd, 12.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.19232721156002, dualexp(dualaxpy(duallin(2.0, lnd, 1.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.25709043003438, dualexp(dualaxpy(duallin(2.0, lnd, 5.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 0.16074868486251, dualexp(dualaxpy(duallin(3.0, lnd, 4.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.040092828925807, dualexp(dualaxpy(duallin(4.0, lnd, 2.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 3.9343422603254e-07, dualexp(dualaxpy(duallin(4.0, lnd, 13.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -7.5941377088144e-06, dualexp(dualaxpy(duallin(5.0, lnd, 9.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 0.00056250979351888, dualexp(dualaxpy(duallin(7.0, lnd, 3.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -1.5608652257135e-05, dualexp(dualaxpy(duallin(9.0, lnd, 4.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 1.1537996422951e-09, dualexp(dualaxpy(duallin(10.0, lnd, 11.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 3.6582165144204e-07, dualexp(dualaxpy(duallin(11.0, lnd, 4.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -1.3251180074668e-12, dualexp(dualaxpy(duallin(13.0, lnd, 13.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -6.2639586912454e-10, dualexp(dualaxpy(duallin(15.0, lnd, 1.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.10793600908932, dualexp(dualaxpy(duallin(1.0, lnd, 7.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.017611491008752, dualexp(dualaxpy(duallin(2.0, lnd, 1.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.22132295167546, dualexp(dualaxpy(duallin(2.0, lnd, 9.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.40247669763528, dualexp(dualaxpy(duallin(2.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.58083399985759, dualexp(dualaxpy(duallin(3.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.0049969146990806, dualexp(dualaxpy(duallin(4.0, lnd, 3.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.031358700712549, dualexp(dualaxpy(duallin(4.0, lnd, 7.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.74315929710341, dualexp(dualaxpy(duallin(4.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.4780732991548, dualexp(dualaxpy(duallin(5.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.020527940895948, dualexp(dualaxpy(duallin(6.0, lnd, 6.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.13636435110343, dualexp(dualaxpy(duallin(6.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.014180634400617, dualexp(dualaxpy(duallin(7.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.0083326504880713, dualexp(dualaxpy(duallin(9.0, lnd, 1.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.029052336009585, dualexp(dualaxpy(duallin(9.0, lnd, 2.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.038615085574206, dualexp(dualaxpy(duallin(9.0, lnd, 3.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.020393486513704, dualexp(dualaxpy(duallin(9.0, lnd, 4.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.0016554050063734, dualexp(dualaxpy(duallin(9.0, lnd, 8.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.0019955571979541, dualexp(dualaxpy(duallin(10.0, lnd, 6.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.00015870308324157, dualexp(dualaxpy(duallin(10.0, lnd, 9.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -1.638856834253e-05, dualexp(dualaxpy(duallin(12.0, lnd, 8.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.043613615723811, dualexp(dualaxpy(duallin(3.0, lnd, 16.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, 0.034994005463765, dualexp(dualaxpy(duallin(4.0, lnd, 22.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, -0.076788197844621, dualexp(dualaxpy(duallin(4.0, lnd, 23.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, 0.022446277332006, dualexp(dualaxpy(duallin(5.0, lnd, 23.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, -6.2689710414685e-05, dualexp(dualaxpy(duallin(14.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 4.0)))));
+   ar = dualaxpy(ar, -5.5711118565645e-10, dualexp(dualaxpy(duallin(3.0, lnd, 50.0, lnt), -1.0, dualexp(dualscale(lnd, 6.0)))));
+   ar = dualaxpy(ar, -0.19905718354408, dualexp(dualaxpy(duallin(6.0, lnd, 44.0, lnt), -1.0, dualexp(dualscale(lnd, 6.0)))));
+   ar = dualaxpy(ar, 0.31777497330738, dualexp(dualaxpy(duallin(6.0, lnd, 46.0, lnt), -1.0, dualexp(dualscale(lnd, 6.0)))));
+   ar = dualaxpy(ar, -0.11841182425981, dualexp(dualaxpy(duallin(6.0, lnd, 50.0, lnt), -1.0, dualexp(dualscale(lnd, 6.0)))));
+   x = duallin(3.0, lnd, 0.0, lnt);
+   u = dualshift(delta, -1.0);
+   x = dualaxpy(x, -20.0, dualmul(u, u));
+   u = dualshift(tau, -1.21);
+   x = dualaxpy(x, -150.0, dualmul(u, u));
+   ar = dualaxpy(ar, -31.306260323435, dualexp(x));
+   x = duallin(3.0, lnd, 1.0, lnt);
+   u = dualshift(delta, -1.0);
+   x = dualaxpy(x, -20.0, dualmul(u, u));
+   u = dualshift(tau, -1.21);
+   x = dualaxpy(x, -150.0, dualmul(u, u));
+   ar = dualaxpy(ar, 31.546140237781, dualexp(x));
+   x = duallin(3.0, lnd, 4.0, lnt);
+   u = dualshift(delta, -1.0);
+   x = dualaxpy(x, -20.0, dualmul(u, u));
+   u = dualshift(tau, -1.25);
+   x = dualaxpy(x, -250.0, dualmul(u, u));
+   ar = dualaxpy(ar, -2521.3154341695, dualexp(x));
+   v = dualabsnz(dualshift(delta, -1.0));
+   w = dualshift(tau, -1.0);
+   x = dualaxpy(dualshift(dualscale(tau, -1.0), 1.0), 0.32, dualpow(v, 3.3333333333333335));
+   x = dualaxpy(dualmul(x, x), 0.2, dualpow(v, 7.0));
+   u = dualexp(dualaxpy(dualscale(dualmul(v, v), -28.0), -700.0, dualmul(w, w)));
+   ar = dualaxpy(ar, -0.14874640856724, dualmul(dualmul(dualpow(x, 0.85), delta), u));
+   x = dualaxpy(dualshift(dualscale(tau, -1.0), 1.0), 0.32, dualpow(v, 3.3333333333333335));
+   x = dualaxpy(dualmul(x, x), 0.2, dualpow(v, 7.0));
+   u = dualexp(dualaxpy(dualscale(dualmul(v, v), -32.0), -800.0, dualmul(w, w)));
+   ar = dualaxpy(ar, 0.31806110878444, dualmul(dualmul(dualpow(x, 0.95), delta), u));
+   a0 = dualaxpy(dualaxpy(dualshift(dualscale(tau, 6.6832105275932), -8.3204464837497), 3.00632, lnt), 1.0, lnd);
+   a0 = dualaxpy(a0, 0.012436, duallog(dualshift(dualscale(dualexp(dualscale(tau, -1.28728967)), -1.0), 1.0)));
+   a0 = dualaxpy(a0, 0.97315, duallog(dualshift(dualscale(dualexp(dualscale(tau, -3.53734222)), -1.0), 1.0)));
+   a0 = dualaxpy(a0, 1.2795, duallog(dualshift(dualscale(dualexp(dualscale(tau, -7.74073708)), -1.0), 1.0)));
+   a0 = dualaxpy(a0, 0.96956, duallog(dualshift(dualscale(dualexp(dualscale(tau, -9.24437796)), -1.0), 1.0)));
+   a0 = dualaxpy(a0, 0.24873, duallog(dualshift(dualscale(dualexp(dualscale(tau, -27.5075105)), -1.0), 1.0)));
+   return dualscale(dualmul(T, dualaxpy(a0, 1.0, ar)), 8.314371357587 / 0.018015268);
+}
+
+/** whether a state of Water may be two-phase */
+static int twophase_Water(
+   double                t,
+   double                D
+   )
+{
+   double rho = D / 0.018015268;
+   double tl = t < 647.0959999999985 ? t : 647.0959999999985;
+   double tv = t < 647.0959999999985 ? t : 647.0959999999985;
+
+   if( t >= 647.0959999999985 )
+      return 0;
+   if( t < 273.16 )
+      return 1;
+   t = tv;
+   if( rho <= (17873.72799560906 * exp(647.096 / t * (0.9791749335365787 * pow((1.0 - t / 647.096), 0.21) + -2.6190679042770215 * pow((1.0 - t / 647.096), 0.262) + -3.9166443712365235 * pow((1.0 - t / 647.096), 0.701) + -20.313306821636637 * pow((1.0 - t / 647.096), 3.909) + 16.497589490043744 * pow((1.0 - t / 647.096), 4.076) + -125.36580458432083 * pow((1.0 - t / 647.096), 17.459)))) * (1.0 - 0.014914406109543634) )
+      return 0;
+   t = tl;
+   return rho < (17873.72799560906 * (1.0 + 0.8157021355019343 * pow((1.0 - t / 647.096), 0.276) + 2.0434712177006693 * pow((1.0 - t / 647.096), 0.455) + -78.58278372496308 * pow((1.0 - t / 647.096), 7.127) + 1026.4273940070307 * pow((1.0 - t / 647.096), 9.846) + -2290.5642779377695 * pow((1.0 - t / 647.096), 11.707) + 8420.141408210317 * pow((1.0 - t / 647.096), 17.805))) * (1.0 + 0.012886826972695156);
+}
+
+/*
+ * R134a (TillnerRoth-JPCRD-1994)
+ */
+
+/** specific Helmholtz energy of R134a in J/kg */
+static DUAL helmholtz_R134a(
+   DUAL                  T,
+   DUAL                  D
+   )
+{
+   DUAL tau, delta, lnt, lnd, a0, ar, x, u, v, w;
+
+   tau = dualscale(dualpow(T, -1.0), 374.18);
+   delta = dualscale(D, 1.0 / (0.102032 * 4978.830171000001));
+   lnt = duallog(tau);
+   lnd = duallog(delta);
+   memset(&ar, 0, sizeof(ar));
+   (void)x; (void)u; (void)v; (void)w;
+
+   ar = dualaxpy(ar, 0.05586817, dualexp(duallin(2.0, lnd, -0.5, lnt)));
+   ar = dualaxpy(ar, 0.498223, dualexp(duallin(1.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, 0.02458698, dualexp(duallin(3.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, 0.0008570145, dualexp(duallin(6.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, 0.0004788584, dualexp(duallin(6.0, lnd, 1.5, lnt)));
+   ar = dualaxpy(ar, -1.800808, dualexp(duallin(1.0, lnd, 1.5, lnt)));
+   ar = dualaxpy(ar, 0.2671641, dualexp(duallin(1.0, lnd, 2.0, lnt)));
+   ar = dualaxpy(ar, -0.04781652, dualexp(duallin(2.0, lnd, 2.0, lnt)));
+   ar = dualaxpy(ar, 0.01423987, dualexp(dualaxpy(duallin(5.0, lnd, 1.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 0.3324062, dualexp(dualaxpy(duallin(2.0, lnd, 3.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.007485907, dualexp(dualaxpy(duallin(2.0, lnd, 5.0, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, 0.0001017263, dualexp(dualaxpy(duallin(4.0, lnd, 1.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.5184567, dualexp(dualaxpy(duallin(1.0, lnd, 5.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.08692288, dualexp(dualaxpy(duallin(4.0, lnd, 5.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.2057144, dualexp(dualaxpy(duallin(1.0, lnd, 6.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.005000457, dualexp(dualaxpy(duallin(2.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.0004603262, dualexp(dualaxpy(duallin(4.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.003497836, dualexp(dualaxpy(duallin(1.0, lnd, 10.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, 0.006995038, dualexp(dualaxpy(duallin(5.0, lnd, 18.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, -0.01452184, dualexp(dualaxpy(duallin(3.0, lnd, 22.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, -0.0001285458, dualexp(dualaxpy(duallin(10.0, lnd, 50.0, lnt), -1.0, dualexp(dualscale(lnd, 4.0)))));
+   a0 = dualaxpy(dualaxpy(dualshift(dualscale(tau, 9.047135), -1.019535), -1.629789, lnt), 1.0, lnd);
+   a0 = dualaxpy(a0, -9.723916, dualexp(dualscale(lnt, -0.5)));
+   a0 = dualaxpy(a0, -3.92717, dualexp(dualscale(lnt, -0.75)));
+   return dualscale(dualmul(T, dualaxpy(a0, 1.0, ar)), 8.314471 / 0.102032);
+}
+
+/** whether a state of R134a may be two-phase */
+static int twophase_R134a(
+   double                t,
+   double                D
+   )
+{
+   double rho = D / 0.102032;
+   double tl = t < 374.20999999999935 ? t : 374.20999999999935;
+   double tv = t < 374.20999999999935 ? t : 374.20999999999935;
+
+   if( t >= 374.20999999999935 )
+      return 0;
+   if( t < 169.85 )
+      return 1;
+   t = tv;
+   if( rho <= (5017.053 * exp(374.21 / t * (-5.147386240766544 * pow((1.0 - t / 374.21), 0.476) + 5.34618043286371 * pow((1.0 - t / 374.21), 0.966) + -7.611015272838434 * pow((1.0 - t / 374.21), 1.321) + -28.85436432788653 * pow((1.0 - t / 374.21), 8.491) + -9.079306067130748 * pow((1.0 - t / 374.21), 13.463) + 64.0 * pow((1.0 - t / 374.21), 13.463)))) * (1.0 - 0.06088759065278548) )
+      return 0;
+   t = tl;
+   return rho < (5017.053 * (1.0 + 18.772731940930015 * pow((1.0 - t / 374.21), 0.673) + -51.49939472178225 * pow((1.0 - t / 374.21), 0.994) + 40.793536440596085 * pow((1.0 - t / 374.21), 1.257) + -1481.6500471538966 * pow((1.0 - t / 374.21), 5.783) + 1600.534434298925 * pow((1.0 - t / 374.21), 5.943) + -67338.52423732559 * pow((1.0 - t / 374.21), 19.94))) * (1.0 + 0.10389202877542368);
+}
+
+/*
+ * Air (Lemmon-JPCRD-2000)
+ */
+
+/** specific Helmholtz energy of Air in J/kg */
+static DUAL helmholtz_Air(
+   DUAL                  T,
+   DUAL                  D
+   )
+{
+   DUAL tau, delta, lnt, lnd, a0, ar, x, u, v, w;
+
+   tau = dualscale(dualpow(T, -1.0), 132.6312);
+   delta = dualscale(D, 1.0 / (0.02896546 * 10447.7));
+   lnt = duallog(tau);
+   lnd = duallog(delta);
+   memset(&ar, 0, sizeof(ar));
+   (void)x; (void)u; (void)v; (void)w;
+
+   ar = dualaxpy(ar, 0.118160747229, dualexp(duallin(1.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, 0.713116392079, dualexp(duallin(1.0, lnd, 0.33, lnt)));
+   ar = dualaxpy(ar, -1.61824192067, dualexp(duallin(1.0, lnd, 1.01, lnt)));
+   ar = dualaxpy(ar, 0.0714140178971, dualexp(duallin(2.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, -0.0865421396646, dualexp(duallin(3.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, 0.134211176704, dualexp(duallin(3.0, lnd, 0.15, lnt)));
+   ar = dualaxpy(ar, 0.0112626704218, dualexp(duallin(4.0, lnd, 0.0, lnt)));
+   ar = dualaxpy(ar, -0.0420533228842, dualexp(duallin(4.0, lnd, 0.2, lnt)));
+   ar = dualaxpy(ar, 0.0349008431982, dualexp(duallin(4.0, lnd, 0.35, lnt)));
+   ar = dualaxpy(ar, 0.000164957183186, dualexp(duallin(6.0, lnd, 1.35, lnt)));
+   ar = dualaxpy(ar, -0.101365037912, dualexp(dualaxpy(duallin(1.0, lnd, 1.6, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.17381369097, dualexp(dualaxpy(duallin(3.0, lnd, 0.8, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.0472103183731, dualexp(dualaxpy(duallin(5.0, lnd, 0.95, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.0122523554253, dualexp(dualaxpy(duallin(6.0, lnd, 1.25, lnt), -1.0, dualexp(dualscale(lnd, 1.0)))));
+   ar = dualaxpy(ar, -0.146629609713, dualexp(dualaxpy(duallin(1.0, lnd, 3.6, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, -0.0316055879821, dualexp(dualaxpy(duallin(3.0, lnd, 6.0, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.000233594806142, dualexp(dualaxpy(duallin(11.0, lnd, 3.25, lnt), -1.0, dualexp(dualscale(lnd, 2.0)))));
+   ar = dualaxpy(ar, 0.0148287891978, dualexp(dualaxpy(duallin(1.0, lnd, 3.5, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   ar = dualaxpy(ar, -0.00938782884667, dualexp(dualaxpy(duallin(3.0, lnd, 15.0, lnt), -1.0, dualexp(dualscale(lnd, 3.0)))));
+   a0 = dualaxpy(dualaxpy(dualshift(dualscale(tau, 3.31112445645577), 10.3753039487406), 2.490888032, lnt), 1.0, lnd);
+   a0 = dualaxpy(a0, 6.057194e-08, dualexp(dualscale(lnt, -3.0)));
+   a0 = dualaxpy(a0, -2.10274769e-05, dualexp(dualscale(lnt, -2.0)));
+   a0 = dualaxpy(a0, -0.000158860716, dualexp(dualscale(lnt, -1.0)));
+   a0 = dualaxpy(a0, -13.841928076, dualexp(dualscale(lnt, 0.0)));
+   a0 = dualaxpy(a0, 17.275266575, dualexp(dualscale(lnt, 1.0)));
+   a0 = dualaxpy(a0, -0.00019536342, dualexp(dualscale(lnt, 1.5)));
+   a0 = dualaxpy(a0, 0.791309509, duallog(dualshift(dualscale(dualexp(dualscale(tau, -25.36365)), -1.0), 1.0)));
+   a0 = dualaxpy(a0, 0.212236768, duallog(dualshift(dualscale(dualexp(dualscale(tau, -16.90741)), -1.0), 1.0)));
+   a0 = dualaxpy(a0, -0.197938904, duallog(dualshift(dualscale(dualexp(dualscale(tau, 87.31279)), 1.0), 0.6666666666666666)));
+   return dualscale(dualmul(T, dualaxpy(a0, 1.0, ar)), 8.31451 / 0.02896546);
+}
+
+/** whether a state of Air may be two-phase */
+static int twophase_Air(
+   double                t,
+   double                D
+   )
+{
+   double rho = D / 0.02896546;
+   double tl = t < 132.5206 ? t : 132.5206;
+   double tv = t < 132.6312 ? t : 132.6312;
+
+   if( t >= 132.6312 )
+      return 0;
+   if( t < 59.75 )
+      return 1;
+   t = tv;
+   if( rho <= (10447.7 * exp(-2.0466 * pow((1.0 - t / 132.6312), 0.41) + -4.752 * pow((1.0 - t / 132.6312), 1.0) + -13.259 * pow((1.0 - t / 132.6312), 2.8) + -47.652 * pow((1.0 - t / 132.6312), 6.5))) * (1.0 - 0.03) )
+      return 0;
+   t = tl;
+   return rho < (11830.800000000001 * (1.0 + 23549.22872973586 * pow((1.0 - t / 132.5306), 0.052000000000000005) + -36125.479937395976 * pow((1.0 - t / 132.5306), 0.058) + 29748.003516251414 * pow((1.0 - t / 132.5306), 0.08600000000000001) + -25536.830521053136 * pow((1.0 - t / 132.5306), 0.10700000000000001) + 8367.433264822796 * pow((1.0 - t / 132.5306), 0.125) + 1.3265163441261232 * pow((1.0 - t / 132.5306), 8.0))) * (1.0 + 0.010595576770226814);
+}
+
+/** generated fluids */
+static const struct
+{
+   const char* name;
+   DUAL (*helmholtz)(DUAL T, DUAL D);
+   int (*twophase)(double T, double D);
+} eosgens[] =
+{
+   { "Water", helmholtz_Water, twophase_Water },
+   { "R134a", helmholtz_R134a, twophase_R134a },
+   { "Air", helmholtz_Air, twophase_Air },
+   { NULL, NULL, NULL }
+};
+
+static int eosgenindex(
+   const char*           Fluid
+   )
+{
+   int i;
+
+   for( i = 0; eosgens[i].name != NULL; ++i )
+      if( strcmp(eosgens[i].name, Fluid) == 0 )
+         return i;
+   return -1;
+}
+
+int eosgenhas(
+   const char*           Fluid
+   )
+{
+   return eosgenindex(Fluid) >= 0;
+}
+
+int eosgenprops(
+   const char*           Prop,
+   double                T,
+   double                D,
+   const char*           Fluid,
+   double                d[6]
+   )
+{
+   DUAL t, rho, a, r;
+   int i = eosgenindex(Fluid);
+
+   if( i < 0 )
+      return 1;
+   if( strcmp(Prop, "T") == 0 || strcmp(Prop, "D") == 0 || strcmp(Prop, "Dmass") == 0 )
+   {
+      memset(d, 0, 6 * sizeof(double));
+      d[0] = Prop[0] == 'T' ? T : D;
+      d[Prop[0] == 'T' ? 1 : 2] = 1.0;
+      return 0;
+   }
+   if( strcmp(Prop, "P") != 0 && !((Prop[0] == 'H' || Prop[0] == 'S' || Prop[0] == 'U')
+         && (Prop[1] == '\0' || strcmp(Prop + 1, "mass") == 0)) )
+      return 1;
+   if( eosgens[i].twophase(T, D) )
+      return 2;
+
+   memset(&t, 0, sizeof(t));
+   memset(&rho, 0, sizeof(rho));
+   t.c[0] = T;
+   t.c[1] = 1.0;
+   rho.c[0] = D;
+   rho.c[2] = 1.0;
+   a = eosgens[i].helmholtz(t, rho);
+
+   switch( Prop[0] )
+   {
+      case 'P' :
+         /* p = D^2 da/dD */
+         r = dualmul(dualmul(rho, rho), dualdiff(a, 1));
+         break;
+      case 'S' :
+         /* s = -da/dT */
+         r = dualscale(dualdiff(a, 0), -1.0);
+         break;
+      case 'U' :
+         /* u = a - T da/dT */
+         r = dualaxpy(a, -1.0, dualmul(t, dualdiff(a, 0)));
+         break;
+      default :
+         /* h = a - T da/dT + D da/dD */
+         r = dualaxpy(dualaxpy(a, -1.0, dualmul(t, dualdiff(a, 0))), 1.0, dualmul(rho, dualdiff(a, 1)));
+         break;
+   }
+
+   d[0] = r.c[0];
+   d[1] = r.c[1];
+   d[2] = r.c[2];
+   d[3] = 2.0 * r.c[3];
+   d[4] = r.c[4];
+   d[5] = 2.0 * r.c[5];
+   return 0;
+}
+
+int eosgencheck(
+   const char*           Fluid,
+   char*                 errmsg
+   )
+{
+   static const char* props[] = { "P", "H", "S" };
+   double T = 1.5 * Props1SI(Fluid, "Tcrit");
+   double D = 0.5 * Props1SI(Fluid, "rhomass_critical");
+   double d[6];
+   int i;
+
+   errmsg[0] = '\0';
+   for( i = 0; i < 3; ++i )
+   {
+      double ref = PropsSI(props[i], "T", T, "D", D, Fluid);
+      if( eosgenprops(props[i], T, D, Fluid, d) != 0 || !(fabs(d[0] - ref) <= 1e-8 * fabs(ref)) )
+      {
+         snprintf(errmsg, 255, "Generated equation of state for %s deviates from CoolProp in %s: %.10g vs. %.10g.",
+            Fluid, props[i], d[0], ref);
+         return 1;
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,53 @@
+/** Generated equations of state for selected fluids
+ *
+ * propssieosgen.c is created by eosgen.py from CoolProp's fluid data.
+ * For each fluid, the Helmholtz energy equation of state is written out
+ * term by term with the coefficients as literals, and is evaluated on
+ * forward-mode dual numbers in temperature and density. One pass gives
+ * a property together with its first and second derivatives, where HEOS
+ * needs an update and several partial derivative calls.
+ *
+ * The library uses the generated code for inputs D and T of the fluids
+ * listed in the environment variable PROPSSI_EOSGEN (e.g. "Water R134a").
+ * States below the critical temperature that may be two-phase are left
+ * to CoolProp.
+ */
+
+#ifndef PROPSSIEOSGEN_H_
+#define PROPSSIEOSGEN_H_
+
+/** Checks whether code was generated for a fluid
+ *
+ * @return 1 if available, 0 otherwise.
+ */
+int eosgenhas(
+   const char*           Fluid            /**< fluid name */
+   );
+
+/** Evaluates a property by the generated equation of state
+ *
+ * Prop is one of P, T, D, H, S, U (or Dmass, Hmass, Smass, Umass), in
+ * mass-based SI units. The derivatives in d are with respect to T and D.
+ *
+ * @return 0 if successful, 1 if fluid or property are not available, 2 if the state may be two-phase.
+ */
+int eosgenprops(
+   const char*           Prop,            /**< output property */
+   double                T,               /**< temperature */
+   double                D,               /**< mass density */
+   const char*           Fluid,           /**< fluid name */
+   double                d[6]             /**< buffer for f, df/dT, df/dD, d2f/dTdT, d2f/dTdD, d2f/dDdD */
+   );
+
+/** Compares the generated equation of state with CoolProp at a supercritical state
+ *
+ * This catches code generated from fluid data of another CoolProp version.
+ *
+ * @return 0 if the values agree, 1 otherwise (errmsg is set then).
+ */
+int eosgencheck(
+   const char*           Fluid,           /**< fluid name */
+   char*                 errmsg           /**< buffer of length 255 to store error message (as C string!) */
+   );
+
+#endif /* PROPSSIEOSGEN_H_ */
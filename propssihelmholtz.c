@@ -0,0 +1,1033 @@
+/** Batch evaluation of pure-fluid Helmholtz energy equations of state
+ *
+ * See propssihelmholtz.h.
+ *
+ * The reduced Helmholtz energy alpha = alpha0(tau, delta) + alphar(tau, delta)
+ * with tau = Tr/T and delta = rho/rhor is accumulated term by term over
+ * all points. For each point we keep
+ *   alpha, delta*alpha_delta, delta^2*alpha_deltadelta,
+ *   tau*alpha_tau, tau^2*alpha_tautau, delta*tau*alpha_deltatau,
+ * from which all supported properties follow without further iteration.
+ *
+ * Supported terms (CoolProp JSON types):
+ *   ResidualHelmholtzPower, ResidualHelmholtzExponential,
+ *   ResidualHelmholtzGaussian, ResidualHelmholtzNonAnalytic,
+ *   IdealGasHelmholtzLead, IdealGasHelmholtzEnthalpyEntropyOffset,
+ *   IdealGasHelmholtzLogTau, IdealGasHelmholtzPower,
+ *   IdealGasHelmholtzPlanckEinstein, IdealGasHelmholtzPlanckEinsteinGeneralized
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "CoolPropLib.h"
+#include "propssihelmholtz.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+# define KERNEL_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+# define KERNEL_CLONES
+#endif
+
+/* relative deviation from CoolProp accepted at the validation states */
+#define HELMHOLTZ_VALTOL 1e-8
+
+/** exponential terms n delta^d tau^t exp(-g delta^l); power terms have g = 0 or 1 */
+typedef struct
+{
+   int     n;
+   double* c;
+   double* d;
+   double* t;
+   double* g;
+   double* l;
+} EXPTERMS;
+
+/** Gaussian terms n delta^d tau^t exp(-eta (delta-epsilon)^2 - beta (tau-gamma)^2) */
+typedef struct
+{
+   int     n;
+   double* c;
+   double* d;
+   double* t;
+   double* eta;
+   double* epsilon;
+   double* beta;
+   double* gamma;
+} GAUSSTERMS;
+
+/** non-analytic terms of IAPWS-95 type */
+typedef struct
+{
+   int     n;
+   double* c;
+   double* a;
+   double* b;
+   double* beta;
+   double* A;
+   double* B;
+   double* C;
+   double* D;
+} NATERMS;
+
+/** saturated density ancillary, see CoolProp's SaturationAncillaryFunction */
+typedef struct
+{
+   int     n;
+   double* c;
+   double* t;
+   double  Tr;          /**< reducing temperature */
+   double  Tmin;
+   double  Tmax;
+   double  rhor;        /**< reducing molar density */
+   double  margin;      /**< relative uncertainty */
+   int     isexp;       /**< whether the sum is an exponent */
+   int     usetaur;     /**< whether the exponent is multiplied by Tr/T */
+} ANCILLARY;
+
+/** ideal-gas terms */
+typedef struct
+{
+   double  a1;          /**< constant, including offsets */
+   double  a2;          /**< factor of tau, including offsets */
+   double  logtau;      /**< factor of ln(tau) */
+   int     npow;
+   double* pown;        /**< n tau^t */
+   double* powt;
+   int     npe;
+   double* pen;         /**< n ln(c + d exp(t tau)) */
+   double* pet;
+   double* pec;
+   double* ped;
+} IDEALTERMS;
+
+struct HELMHOLTZ
+{
+   double     R;        /**< molar gas constant */
+   double     M;        /**< molar mass */
+   double     Tr;       /**< reducing temperature */
+   double     rhor;     /**< reducing molar density */
+   double     hoff;     /**< enthalpy offset to CoolProp's reference state */
+   double     soff;     /**< entropy offset to CoolProp's reference state */
+   EXPTERMS   exps;
+   GAUSSTERMS gauss;
+   NATERMS    na;
+   IDEALTERMS ideal;
+   ANCILLARY  rhoL;
+   ANCILLARY  rhoV;
+};
+
+/*
+ * minimal JSON reader for CoolProp's fluid data
+ */
+
+enum { JSON_OBJECT, JSON_ARRAY, JSON_NUMBER, JSON_STRING, JSON_OTHER };
+
+typedef struct JSONNODE
+{
+   int              type;
+   double           num;          /**< value of numbers */
+   const char*      str;          /**< start of strings (without quotes) and literals */
+   int              len;          /**< length of strings and literals */
+   const char*      key;          /**< member name within objects */
+   int              keylen;
+   struct JSONNODE* child;        /**< first element of objects and arrays */
+   struct JSONNODE* next;         /**< next element of the enclosing object or array */
+} JSONNODE;
+
+static void jsonfree(
+   JSONNODE*             node
+   )
+{
+   while( node != NULL )
+   {
+      JSONNODE* next = node->next;
+      jsonfree(node->child);
+      free(node);
+      node = next;
+   }
+}
+
+static void jsonspace(
+   const char**          p
+   )
+{
+   while( **p == ' ' || **p == '\t' || **p == '\n' || **p == '\r' )
+      ++*p;
+}
+
+static int jsonstring(
+   const char**          p,
+   const char**          str,
+   int*                  len
+   )
+{
+   if( **p != '"' )
+      return 1;
+   *str = ++*p;
+   while( **p != '"' )
+   {
+      if( **p == '\0' )
+         return 1;
+      if( **p == '\\' && (*p)[1] != '\0' )
+         ++*p;
+      ++*p;
+   }
+   *len = (int)(*p - *str);
+   ++*p;
+   return 0;
+}
+
+static JSONNODE* jsonparse(
+   const char**          p
+   )
+{
+   JSONNODE* node = calloc(1, sizeof(JSONNODE));
+   JSONNODE** last;
+
+   if( node == NULL )
+      return NULL;
+
+   jsonspace(p);
+   if( **p == '{' || **p == '[' )
+   {
+      char close = **p == '{' ? '}' : ']';
+      node->type = **p == '{' ? JSON_OBJECT : JSON_ARRAY;
+      last = &node->child;
+      ++*p;
+      jsonspace(p);
+      while( **p != close )
+      {
+         const char* key = NULL;
+         int keylen = 0;
+         JSONNODE* child;
+
+         if( node->type == JSON_OBJECT )
+         {
+            if( jsonstring(p, &key, &keylen) )
+               break;
+            jsonspace(p);
+            if( **p != ':' )
+               break;
+            ++*p;
+         }
+         child = jsonparse(p);
+         if( child == NULL )
+            break;
+         child->key = key;
+         child->keylen = keylen;
+         *last = child;
+         last = &child->next;
+         jsonspace(p);
+         if( **p == ',' )
+         {
+            ++*p;
+            jsonspace(p);
+         }
+         else if( **p != close )
+            break;
+      }
+      if( **p != close )
+      {
+         jsonfree(node);
+         return NULL;
+      }
+      ++*p;
+   }
+   else if( **p == '"' )
+   {
+      node->type = JSON_STRING;
+      if( jsonstring(p, &node->str, &node->len) )
+      {
+         jsonfree(node);
+         return NULL;
+      }
+   }
+   else if( **p == '-' || (**p >= '0' && **p <= '9') )
+   {
+      char* end;
+      node->type = JSON_NUMBER;
+      node->num = strtod(*p, &end);
+      *p = end;
+   }
+   else if( strncmp(*p, "true", 4) == 0 || strncmp(*p, "null", 4) == 0 || strncmp(*p, "false", 5) == 0 )
+   {
+      /* literals keep their text */
+      node->type = JSON_OTHER;
+      node->str = *p;
+      node->len = **p == 'f' ? 5 : 4;
+      *p += node->len;
+   }
+   else
+   {
+      jsonfree(node);
+      return NULL;
+   }
+   return node;
+}
+
+/** member of an object, or NULL */
+static const JSONNODE* jsonget(
+   const JSONNODE*       node,
+   const char*           key
+   )
+{
+   const JSONNODE* c;
+
+   if( node == NULL || node->type != JSON_OBJECT )
+      return NULL;
+   for( c = node->child; c != NULL; c = c->next )
+      if( (int)strlen(key) == c->keylen && strncmp(c->key, key, c->keylen) == 0 )
+         return c;
+   return NULL;
+}
+
+static int jsonis(
+   const JSONNODE*       node,
+   const char*           str
+   )
+{
+   return node != NULL && node->type == JSON_STRING && (int)strlen(str) == node->len && strncmp(node->str, str, node->len) == 0;
+}
+
+/** number member of an object */
+static int jsonnum(
+   const JSONNODE*       obj,
+   const char*           key,
+   double*               val
+   )
+{
+   const JSONNODE* node = jsonget(obj, key);
+
+   if( node == NULL || node->type != JSON_NUMBER )
+      return 1;
+   *val = node->num;
+   return 0;
+}
+
+/** appends the numbers of an array member of an object to a coefficient array */
+static int jsonappend(
+   const JSONNODE*       obj,
+   const char*           key,
+   double**              arr,
+   int                   oldn,
+   int*                  n
+   )
+{
+   const JSONNODE* node = jsonget(obj, key);
+   const JSONNODE* c;
+   double* grown;
+   int cnt = 0;
+
+   if( node == NULL || node->type != JSON_ARRAY )
+      return 1;
+   for( c = node->child; c != NULL; c = c->next )
+      if( c->type != JSON_NUMBER )
+         return 1;
+      else
+         ++cnt;
+   if( *n >= 0 && cnt != *n )
+      return 1;
+   *n = cnt;
+
+   grown = realloc(*arr, (oldn + cnt + 1) * sizeof(double));
+   if( grown == NULL )
+      return 1;
+   *arr = grown;
+   for( c = node->child; c != NULL; c = c->next )
+      grown[oldn++] = c->num;
+   return 0;
+}
+
+/** appends a constant to a coefficient array */
+static int appendconst(
+   double**              arr,
+   int                   oldn,
+   int                   n,
+   double                val
+   )
+{
+   double* grown = realloc(*arr, (oldn + n + 1) * sizeof(double));
+   int i;
+
+   if( grown == NULL )
+      return 1;
+   *arr = grown;
+   for( i = 0; i < n; ++i )
+      grown[oldn + i] = val;
+   return 0;
+}
+
+/** reads the residual terms */
+static int readalphar(
+   HELMHOLTZ*            eos,
+   const JSONNODE*       alphar,
+   char*                 errmsg
+   )
+{
+   const JSONNODE* term;
+
+   for( term = alphar->child; term != NULL; term = term->next )
+   {
+      const JSONNODE* type = jsonget(term, "type");
+      int n = -1;
+
+      if( jsonis(type, "ResidualHelmholtzPower") )
+      {
+         int i, old = eos->exps.n;
+         if( jsonappend(term, "n", &eos->exps.c, old, &n) || jsonappend(term, "d", &eos->exps.d, old, &n)
+            || jsonappend(term, "t", &eos->exps.t, old, &n) || jsonappend(term, "l", &eos->exps.l, old, &n)
+            || appendconst(&eos->exps.g, old, n, 1.0) )
+            break;
+         for( i = old; i < old + n; ++i )
+            if( eos->exps.l[i] == 0.0 )
+               eos->exps.g[i] = 0.0;
+         eos->exps.n += n;
+      }
+      else if( jsonis(type, "ResidualHelmholtzExponential") )
+      {
+         int old = eos->exps.n;
+         if( jsonappend(term, "n", &eos->exps.c, old, &n) || jsonappend(term, "d", &eos->exps.d, old, &n)
+            || jsonappend(term, "t", &eos->exps.t, old, &n) || jsonappend(term, "g", &eos->exps.g, old, &n)
+            || jsonappend(term, "l", &eos->exps.l, old, &n) )
+            break;
+         eos->exps.n += n;
+      }
+      else if( jsonis(type, "ResidualHelmholtzGaussian") )
+      {
+         int old = eos->gauss.n;
+         if( jsonappend(term, "n", &eos->gauss.c, old, &n) || jsonappend(term, "d", &eos->gauss.d, old, &n)
+            || jsonappend(term, "t", &eos->gauss.t, old, &n) || jsonappend(term, "eta", &eos->gauss.eta, old, &n)
+            || jsonappend(term, "epsilon", &eos->gauss.epsilon, old, &n) || jsonappend(term, "beta", &eos->gauss.beta, old, &n)
+            || jsonappend(term, "gamma", &eos->gauss.gamma, old, &n) )
+            break;
+         eos->gauss.n += n;
+      }
+      else if( jsonis(type, "ResidualHelmholtzNonAnalytic") )
+      {
+         int old = eos->na.n;
+         if( jsonappend(term, "n", &eos->na.c, old, &n) || jsonappend(term, "a", &eos->na.a, old, &n)
+            || jsonappend(term, "b", &eos->na.b, old, &n) || jsonappend(term, "beta", &eos->na.beta, old, &n)
+            || jsonappend(term, "A", &eos->na.A, old, &n) || jsonappend(term, "B", &eos->na.B, old, &n)
+            || jsonappend(term, "C", &eos->na.C, old, &n) || jsonappend(term, "D", &eos->na.D, old, &n) )
+            break;
+         eos->na.n += n;
+      }
+      else
+         break;
+   }
+   if( term != NULL )
+   {
+      const JSONNODE* type = jsonget(term, "type");
+      snprintf(errmsg, ENGINE_MSGSIZE, "Residual Helmholtz term %.*s not supported by batch kernel.",
+         type != NULL && type->type == JSON_STRING ? type->len : 1, type != NULL && type->type == JSON_STRING ? type->str : "?");
+      return 1;
+   }
+   return 0;
+}
+
+/** reads the ideal-gas terms */
+static int readalpha0(
+   HELMHOLTZ*            eos,
+   const JSONNODE*       alpha0,
+   char*                 errmsg
+   )
+{
+   IDEALTERMS* id = &eos->ideal;
+   const JSONNODE* term;
+
+   for( term = alpha0->child; term != NULL; term = term->next )
+   {
+      const JSONNODE* type = jsonget(term, "type");
+      double a1 = 0.0, a2 = 0.0;
+      int n = -1;
+
+      if( jsonis(type, "IdealGasHelmholtzLead") || jsonis(type, "IdealGasHelmholtzEnthalpyEntropyOffset") )
+      {
+         if( jsonnum(term, "a1", &a1) || jsonnum(term, "a2", &a2) )
+            break;
+         id->a1 += a1;
+         id->a2 += a2;
+      }
+      else if( jsonis(type, "IdealGasHelmholtzLogTau") )
+      {
+         if( jsonnum(term, "a1", &a1) && jsonnum(term, "a", &a1) )
+            break;
+         id->logtau += a1;
+      }
+      else if( jsonis(type, "IdealGasHelmholtzPower") )
+      {
+         if( jsonappend(term, "n", &id->pown, id->npow, &n) || jsonappend(term, "t", &id->powt, id->npow, &n) )
+            break;
+         id->npow += n;
+      }
+      else if( jsonis(type, "IdealGasHelmholtzPlanckEinstein") )
+      {
+         int i;
+         /* n ln(1 - exp(-t tau)) = n ln(-1 + exp(t tau)) - n t tau */
+         if( jsonappend(term, "n", &id->pen, id->npe, &n) || jsonappend(term, "t", &id->pet, id->npe, &n)
+            || appendconst(&id->pec, id->npe, n, -1.0) || appendconst(&id->ped, id->npe, n, 1.0) )
+            break;
+         for( i = id->npe; i < id->npe + n; ++i )
+            id->a2 -= id->pen[i] * id->pet[i];
+         id->npe += n;
+      }
+      else if( jsonis(type, "IdealGasHelmholtzPlanckEinsteinGeneralized") )
+      {
+         if( jsonappend(term, "n", &id->pen, id->npe, &n) || jsonappend(term, "t", &id->pet, id->npe, &n)
+            || jsonappend(term, "c", &id->pec, id->npe, &n) || jsonappend(term, "d", &id->ped, id->npe, &n) )
+            break;
+         id->npe += n;
+      }
+      else
+         break;
+   }
+   if( term != NULL )
+   {
+      const JSONNODE* type = jsonget(term, "type");
+      snprintf(errmsg, ENGINE_MSGSIZE, "Ideal-gas Helmholtz term %.*s not supported by batch kernel.",
+         type != NULL && type->type == JSON_STRING ? type->len : 1, type != NULL && type->type == JSON_STRING ? type->str : "?");
+      return 1;
+   }
+   return 0;
+}
+
+/** reads a saturated density ancillary */
+static int readancillary(
+   ANCILLARY*            anc,
+   const JSONNODE*       node
+   )
+{
+   const JSONNODE* type = jsonget(node, "type");
+   const JSONNODE* taur = jsonget(node, "using_tau_r");
+   double maxerr = 5.0;
+
+   anc->n = -1;
+   if( jsonappend(node, "n", &anc->c, 0, &anc->n) || jsonappend(node, "t", &anc->t, 0, &anc->n)
+      || jsonnum(node, "T_r", &anc->Tr) || jsonnum(node, "Tmin", &anc->Tmin) || jsonnum(node, "Tmax", &anc->Tmax)
+      || jsonnum(node, "reducing_value", &anc->rhor) || type == NULL || type->type != JSON_STRING )
+   {
+      anc->n = 0;
+      return 1;
+   }
+   jsonnum(node, "max_abserror_percentage", &maxerr);
+   anc->margin = 0.01 + 0.02 * maxerr;
+   anc->isexp = !jsonis(type, "rhoLnoexp");
+   anc->usetaur = taur != NULL && taur->type == JSON_OTHER && taur->len == 4 && strncmp(taur->str, "true", 4) == 0;
+   return 0;
+}
+
+/** evaluates a saturated density ancillary */
+static double ancillary(
+   const ANCILLARY*      anc,
+   double                T
+   )
+{
+   double theta, sum = 0.0;
+   int k;
+
+   if( T > anc->Tmax )
+      T = anc->Tmax;
+   theta = 1.0 - T / anc->Tr;
+   for( k = 0; k < anc->n; ++k )
+      sum += anc->c[k] * pow(theta, anc->t[k]);
+   if( !anc->isexp )
+      return anc->rhor * (1.0 + sum);
+   return anc->rhor * exp(anc->usetaur ? anc->Tr / T * sum : sum);
+}
+
+/*
+ * kernels
+ */
+
+/** accumulates the exponential and power terms */
+KERNEL_CLONES
+static void kernelexp(
+   const EXPTERMS*       e,
+   int                   n,
+   const double* restrict lndelta,
+   const double* restrict lntau,
+   double* restrict      a,
+   double* restrict      ad,
+   double* restrict      add,
+   double* restrict      at,
+   double* restrict      att,
+   double* restrict      adt
+   )
+{
+   int k, i;
+
+   for( k = 0; k < e->n; ++k )
+   {
+      const double c = e->c[k], d = e->d[k], t = e->t[k], g = e->g[k], l = e->l[k];
+
+#pragma omp simd
+      for( i = 0; i < n; ++i )
+      {
+         double dl = g != 0.0 ? exp(l * lndelta[i]) : 0.0;
+         double f = c * exp(d * lndelta[i] + t * lntau[i] - g * dl);
+         double A = d - g * l * dl;
+
+         a[i]   += f;
+         ad[i]  += f * A;
+         add[i] += f * (A * A - d - g * l * (l - 1.0) * dl);
+         at[i]  += f * t;
+         att[i] += f * t * (t - 1.0);
+         adt[i] += f * t * A;
+      }
+   }
+}
+
+/** accumulates the Gaussian terms */
+KERNEL_CLONES
+static void kernelgauss(
+   const GAUSSTERMS*     e,
+   int                   n,
+   const double* restrict delta,
+   const double* restrict tau,
+   const double* restrict lndelta,
+   const double* restrict lntau,
+   double* restrict      a,
+   double* restrict      ad,
+   double* restrict      add,
+   double* restrict      at,
+   double* restrict      att,
+   double* restrict      adt
+   )
+{
+   int k, i;
+
+   for( k = 0; k < e->n; ++k )
+   {
+      const double c = e->c[k], d = e->d[k], t = e->t[k];
+      const double eta = e->eta[k], eps = e->epsilon[k], beta = e->beta[k], gam = e->gamma[k];
+
+#pragma omp simd
+      for( i = 0; i < n; ++i )
+      {
+         double dd = delta[i] - eps;
+         double dt = tau[i] - gam;
+         double f = c * exp(d * lndelta[i] + t * lntau[i] - eta * dd * dd - beta * dt * dt);
+         double A = d - 2.0 * eta * delta[i] * dd;
+         double B = t - 2.0 * beta * tau[i] * dt;
+
+         a[i]   += f;
+         ad[i]  += f * A;
+         add[i] += f * (A * A - d - 2.0 * eta * delta[i] * delta[i]);
+         at[i]  += f * B;
+         att[i] += f * (B * B - t - 2.0 * beta * tau[i] * tau[i]);
+         adt[i] += f * A * B;
+      }
+   }
+}
+
+/** accumulates the non-analytic terms (IAPWS-95, Table 5) */
+static void kernelna(
+   const NATERMS*        e,
+   int                   n,
+   const double*         delta,
+   const double*         tau,
+   double*               a,
+   double*               ad,
+   double*               add,
+   double*               at,
+   double*               att,
+   double*               adt
+   )
+{
+   int k, i;
+
+   for( k = 0; k < e->n; ++k )
+   {
+      const double c = e->c[k], aa = e->a[k], b = e->b[k], beta = e->beta[k];
+      const double A = e->A[k], B = e->B[k], C = e->C[k], D = e->D[k];
+
+      for( i = 0; i < n; ++i )
+      {
+         double del = delta[i], ta = tau[i];
+         double dm1 = fabs(del - 1.0) < 1e-12 ? 1e-12 : del - 1.0;
+         double d2 = dm1 * dm1;
+         double tm1 = ta - 1.0;
+         double p1 = pow(d2, 0.5 / beta - 1.0);                  /* ((delta-1)^2)^(1/(2 beta) - 1) */
+         double theta = (1.0 - ta) + A * p1 * d2;
+         double Delta = theta * theta + B * pow(d2, aa);
+         double psi = exp(-C * d2 - D * tm1 * tm1);
+         double psid = -2.0 * C * dm1 * psi;
+         double psidd = (2.0 * C * d2 - 1.0) * 2.0 * C * psi;
+         double psit = -2.0 * D * tm1 * psi;
+         double psitt = (2.0 * D * tm1 * tm1 - 1.0) * 2.0 * D * psi;
+         double psidt = 4.0 * C * D * dm1 * tm1 * psi;
+         double Deltad = dm1 * (A * theta * 2.0 / beta * p1 + 2.0 * B * aa * pow(d2, aa - 1.0));
+         double Deltadd = Deltad / dm1 + d2 * (4.0 * B * aa * (aa - 1.0) * pow(d2, aa - 2.0)
+            + 2.0 * A * A / (beta * beta) * p1 * p1 + A * theta * 4.0 / beta * (0.5 / beta - 1.0) * p1 / d2);
+         double Db = pow(Delta, b);
+         double Db1 = b * pow(Delta, b - 1.0);
+         double Db2 = b * (b - 1.0) * pow(Delta, b - 2.0);
+         double Dbd = Db1 * Deltad;
+         double Dbdd = Db1 * Deltadd + Db2 * Deltad * Deltad;
+         double Dbt = -2.0 * theta * Db1;
+         double Dbtt = 2.0 * Db1 + 4.0 * theta * theta * Db2;
+         double Dbdt = -A * Db1 * 2.0 / beta * dm1 * p1 - 2.0 * theta * Db2 * Deltad;
+         double phi = c * Db * del * psi;
+         double phid = c * (Db * (psi + del * psid) + Dbd * del * psi);
+         double phidd = c * (Db * (2.0 * psid + del * psidd) + 2.0 * Dbd * (psi + del * psid) + Dbdd * del * psi);
+         double phit = c * del * (Dbt * psi + Db * psit);
+         double phitt = c * del * (Dbtt * psi + 2.0 * Dbt * psit + Db * psitt);
+         double phidt = c * (Db * (psit + del * psidt) + del * Dbd * psit + Dbt * (psi + del * psid) + Dbdt * del * psi);
+
+         a[i]   += phi;
+         ad[i]  += del * phid;
+         add[i] += del * del * phidd;
+         at[i]  += ta * phit;
+         att[i] += ta * ta * phitt;
+         adt[i] += del * ta * phidt;
+      }
+   }
+}
+
+/** computes the ideal-gas part */
+KERNEL_CLONES
+static void kernelideal(
+   const IDEALTERMS*     id,
+   int                   n,
+   const double* restrict tau,
+   const double* restrict lndelta,
+   const double* restrict lntau,
+   double* restrict      a,
+   double* restrict      at,
+   double* restrict      att
+   )
+{
+   int k, i;
+
+#pragma omp simd
+   for( i = 0; i < n; ++i )
+   {
+      a[i] = lndelta[i] + id->a1 + id->a2 * tau[i] + id->logtau * lntau[i];
+      at[i] = id->a2 * tau[i] + id->logtau;
+      att[i] = -id->logtau;
+   }
+   for( k = 0; k < id->npow; ++k )
+   {
+      const double c = id->pown[k], t = id->powt[k];
+#pragma omp simd
+      for( i = 0; i < n; ++i )
+      {
+         double f = c * exp(t * lntau[i]);
+         a[i] += f;
+         at[i] += f * t;
+         att[i] += f * t * (t - 1.0);
+      }
+   }
+   for( k = 0; k < id->npe; ++k )
+   {
+      const double c = id->pen[k], t = id->pet[k], cc = id->pec[k], dd = id->ped[k];
+#pragma omp simd
+      for( i = 0; i < n; ++i )
+      {
+         double e = dd * exp(t * tau[i]);
+         double q = cc + e;
+         a[i] += c * log(q);
+         at[i] += c * t * tau[i] * e / q;
+         att[i] += c * t * t * tau[i] * tau[i] * cc * e / (q * q);
+      }
+   }
+}
+
+int helmholtzbatch(
+   const HELMHOLTZ*      eos,
+   const char*           Prop,
+   int                   n,
+   const double*         T,
+   const double*         D,
+   double*               out
+   )
+{
+   double* buf;
+   double *delta, *tau, *lndelta, *lntau, *a0, *at0, *att0, *ar, *ad, *add, *at, *att, *adt;
+   double RM = eos->R / eos->M;
+   double Tsingle = eos->rhoL.Tmax > eos->rhoV.Tmax ? eos->rhoL.Tmax : eos->rhoV.Tmax;
+   double Tlow = eos->rhoL.Tmin > eos->rhoV.Tmin ? eos->rhoL.Tmin : eos->rhoV.Tmin;
+   char p = Prop[0];
+   int nout = 0;
+   int i;
+
+   if( Prop[0] == '\0' || Prop[1] != '\0' || strchr("PTDHSUCOA", p) == NULL )
+      return -1;
+   if( n <= 0 )
+      return 0;
+   if( p == 'T' || p == 'D' )
+   {
+      memcpy(out, p == 'T' ? T : D, n * sizeof(double));
+      return 0;
+   }
+
+   buf = malloc(13 * (size_t)n * sizeof(double));
+   if( buf == NULL )
+      return -1;
+   delta = buf;
+   tau = buf + n;
+   lndelta = buf + 2*n;
+   lntau = buf + 3*n;
+   a0 = buf + 4*n;
+   at0 = buf + 5*n;
+   att0 = buf + 6*n;
+   ar = buf + 7*n;
+   ad = buf + 8*n;
+   add = buf + 9*n;
+   at = buf + 10*n;
+   att = buf + 11*n;
+   adt = buf + 12*n;
+
+   for( i = 0; i < n; ++i )
+   {
+      delta[i] = D[i] / eos->M / eos->rhor;
+      tau[i] = eos->Tr / T[i];
+      lndelta[i] = log(delta[i]);
+      lntau[i] = log(tau[i]);
+   }
+   memset(ar, 0, 6 * (size_t)n * sizeof(double));
+
+   kernelideal(&eos->ideal, n, tau, lndelta, lntau, a0, at0, att0);
+   kernelexp(&eos->exps, n, lndelta, lntau, ar, ad, add, at, att, adt);
+   kernelgauss(&eos->gauss, n, delta, tau, lndelta, lntau, ar, ad, add, at, att, adt);
+   kernelna(&eos->na, n, delta, tau, ar, ad, add, at, att, adt);
+
+   for( i = 0; i < n; ++i )
+   {
+      double cv = -(att0[i] + att[i]);
+      double num = 1.0 + ad[i] - adt[i];
+      double den = 1.0 + 2.0 * ad[i] + add[i];
+
+      switch( p )
+      {
+         case 'P' :
+            out[i] = D[i] * RM * T[i] * (1.0 + ad[i]);
+            break;
+         case 'H' :
+            out[i] = RM * T[i] * (1.0 + at0[i] + at[i] + ad[i]) + eos->hoff;
+            break;
+         case 'U' :
+            out[i] = RM * T[i] * (at0[i] + at[i]) + eos->hoff;
+            break;
+         case 'S' :
+            out[i] = RM * (at0[i] + at[i] - a0[i] - ar[i]) + eos->soff;
+            break;
+         case 'O' :
+            out[i] = RM * cv;
+            break;
+         case 'C' :
+            out[i] = RM * (cv + num * num / den);
+            break;
+         default :
+            out[i] = sqrt(RM * T[i] * (den + num * num / cv));
+            break;
+      }
+
+      /* below the critical temperature, leave states that may be two-phase to CoolProp */
+      if( T[i] < Tsingle )
+      {
+         double rho = D[i] / eos->M;
+         if( T[i] < Tlow || (rho > ancillary(&eos->rhoV, T[i]) * (1.0 - eos->rhoV.margin)
+               && rho < ancillary(&eos->rhoL, T[i]) * (1.0 + eos->rhoL.margin)) )
+         {
+            out[i] = NAN;
+            ++nout;
+         }
+      }
+   }
+
+   free(buf);
+   return nout;
+}
+
+/*
+ * setup
+ */
+
+void helmholtzfree(
+   HELMHOLTZ*            eos
+   )
+{
+   if( eos == NULL )
+      return;
+   free(eos->exps.c); free(eos->exps.d); free(eos->exps.t); free(eos->exps.g); free(eos->exps.l);
+   free(eos->gauss.c); free(eos->gauss.d); free(eos->gauss.t); free(eos->gauss.eta);
+   free(eos->gauss.epsilon); free(eos->gauss.beta); free(eos->gauss.gamma);
+   free(eos->na.c); free(eos->na.a); free(eos->na.b); free(eos->na.beta);
+   free(eos->na.A); free(eos->na.B); free(eos->na.C); free(eos->na.D);
+   free(eos->ideal.pown); free(eos->ideal.powt);
+   free(eos->ideal.pen); free(eos->ideal.pet); free(eos->ideal.pec); free(eos->ideal.ped);
+   free(eos->rhoL.c); free(eos->rhoL.t); free(eos->rhoV.c); free(eos->rhoV.t);
+   free(eos);
+}
+
+/** compares the kernel with AbstractState_keyed_output at the validation states
+ *
+ * These are two supercritical states, and below the critical temperature a
+ * dilute vapour, a vapour, and a liquid state at three temperatures. The
+ * vapour and liquid states lie just outside the densities that
+ * helmholtzbatch() leaves to CoolProp, so they are the states closest to
+ * saturation that the kernel evaluates. The first state also fixes the
+ * enthalpy and entropy offsets to CoolProp's reference state, which may be
+ * set at runtime rather than in the fluid data.
+ */
+static int validate(
+   HELMHOLTZ*            eos,
+   const char*           Fluid,
+   char*                 errmsg
+   )
+{
+   static const char* props[] = { "P", "H", "S", "O", "C", "A" };
+   static const char* keys[] = { "P", "Hmass", "Smass", "Cvmass", "Cpmass", "speed_of_sound" };
+   static const double fracs[] = { 0.1, 0.5, 0.9 };
+   char buf[ENGINE_MSGSIZE];
+   double T[2 + 9], D[2 + 9], val;
+   double Tsingle = eos->rhoL.Tmax > eos->rhoV.Tmax ? eos->rhoL.Tmax : eos->rhoV.Tmax;
+   double Tlow = eos->rhoL.Tmin > eos->rhoV.Tmin ? eos->rhoL.Tmin : eos->rhoV.Tmin;
+   long handle, errcode = 0;
+   int nstates;
+   int i, j;
+
+   T[0] = 1.5 * Props1SI(Fluid, "Tcrit");
+   T[1] = 1.2 * Props1SI(Fluid, "Tcrit");
+   D[0] = 0.5 * Props1SI(Fluid, "rhomass_critical");
+   D[1] = 1.5 * Props1SI(Fluid, "rhomass_critical");
+   if( !isfinite(T[0]) || !isfinite(D[0]) )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "No critical point for %s.", Fluid);
+      return 1;
+   }
+   nstates = 2;
+   for( j = 0; j < 3 && Tlow < Tsingle; ++j )
+   {
+      double t = Tlow + fracs[j] * (Tsingle - Tlow);
+      double rhov = ancillary(&eos->rhoV, t) * (1.0 - eos->rhoV.margin) * (1.0 - 1e-3);
+      double rhol = ancillary(&eos->rhoL, t) * (1.0 + eos->rhoL.margin) * (1.0 + 1e-3);
+
+      T[nstates] = t;
+      D[nstates++] = 0.01 * rhov * eos->M;
+      T[nstates] = t;
+      D[nstates++] = rhov * eos->M;
+      T[nstates] = t;
+      D[nstates++] = rhol * eos->M;
+   }
+
+   handle = AbstractState_factory("HEOS", Fluid, &errcode, buf, sizeof(buf));
+   if( errcode != 0 )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "%s", buf);
+      return 1;
+   }
+
+   for( j = 0; j < nstates && errcode == 0; ++j )
+   {
+      AbstractState_update(handle, get_input_pair_index("DmassT_INPUTS"), D[j], T[j], &errcode, buf, sizeof(buf));
+      for( i = 0; i < 6 && errcode == 0; ++i )
+      {
+         double ref = AbstractState_keyed_output(handle, get_param_index(keys[i]), &errcode, buf, sizeof(buf));
+         if( errcode != 0 )
+            break;
+         helmholtzbatch(eos, props[i], 1, &T[j], &D[j], &val);
+         if( j == 0 && props[i][0] == 'H' )
+            eos->hoff = ref - val;
+         else if( j == 0 && props[i][0] == 'S' )
+            eos->soff = ref - val;
+         else if( !(fabs(val - ref) <= HELMHOLTZ_VALTOL * fabs(ref)) )
+         {
+            snprintf(errmsg, ENGINE_MSGSIZE, "Batch kernel for %s deviates from CoolProp in %s at T=%g K, D=%g kg/m3: %.10g vs. %.10g.",
+               Fluid, props[i], T[j], D[j], val, ref);
+            errcode = -1;
+         }
+      }
+   }
+   if( errcode > 0 )
+      snprintf(errmsg, ENGINE_MSGSIZE, "%s", buf);
+
+   AbstractState_free(handle, &errcode, buf, sizeof(buf));
+   return errmsg[0] != '\0';
+}
+
+HELMHOLTZ* helmholtzcreate(
+   const char*           Fluid,
+   char*                 errmsg
+   )
+{
+   HELMHOLTZ* eos;
+   JSONNODE* root = NULL;
+   const JSONNODE* eosnode;
+   const JSONNODE* alphar;
+   const JSONNODE* alpha0;
+   const JSONNODE* anc;
+   char* json = NULL;
+   const char* p;
+   int size;
+
+   errmsg[0] = '\0';
+
+   /* CoolProp does not copy if the buffer is too small */
+   for( size = 1 << 18; size <= 1 << 26; size <<= 2 )
+   {
+      json = malloc(size);
+      if( json == NULL )
+         break;
+      json[0] = '\0';
+      if( get_fluid_param_string(Fluid, "JSON", json, size) == 1 && json[0] != '\0' )
+         break;
+      free(json);
+      json = NULL;
+   }
+   if( json == NULL )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "No fluid data for %s.", Fluid);
+      return NULL;
+   }
+
+   p = json;
+   root = jsonparse(&p);
+   /* the fluid data may come as a list with one fluid */
+   anc = root != NULL && root->type == JSON_ARRAY ? root->child : root;
+   eosnode = jsonget(anc, "EOS");
+   anc = jsonget(anc, "ANCILLARIES");
+   eosnode = eosnode != NULL && eosnode->type == JSON_ARRAY ? eosnode->child : NULL;
+   alphar = jsonget(eosnode, "alphar");
+   alpha0 = jsonget(eosnode, "alpha0");
+   if( alphar == NULL || alpha0 == NULL || alphar->type != JSON_ARRAY || alpha0->type != JSON_ARRAY )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Cannot read equation of state of %s.", Fluid);
+      jsonfree(root);
+      free(json);
+      return NULL;
+   }
+
+   eos = calloc(1, sizeof(HELMHOLTZ));
+   if( eos == NULL )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Out of memory.");
+      jsonfree(root);
+      free(json);
+      return NULL;
+   }
+   eos->R = Props1SI(Fluid, "gas_constant");
+   eos->M = Props1SI(Fluid, "molar_mass");
+   eos->Tr = Props1SI(Fluid, "T_reducing");
+   eos->rhor = Props1SI(Fluid, "rhomolar_reducing");
+
+   if( readancillary(&eos->rhoL, jsonget(anc, "rhoL")) || readancillary(&eos->rhoV, jsonget(anc, "rhoV")) )
+      snprintf(errmsg, ENGINE_MSGSIZE, "No saturated density ancillaries for %s.", Fluid);
+   else if( readalphar(eos, alphar, errmsg) == 0 )
+      readalpha0(eos, alpha0, errmsg);
+   jsonfree(root);
+   free(json);
+
+   if( errmsg[0] == '\0' )
+      validate(eos, Fluid, errmsg);
+   if( errmsg[0] != '\0' )
+   {
+      helmholtzfree(eos);
+      return NULL;
+   }
+   return eos;
+}
@@ -0,0 +1,67 @@
+/** Batch evaluation of pure-fluid Helmholtz energy equations of state
+ *
+ * For building tables, prefetching grids, or finite-difference stencils,
+ * the same fluid is evaluated at many (T, rho) points. Instead of going
+ * through CoolProp point by point, helmholtzbatch() evaluates the ideal-gas
+ * and residual Helmholtz energy terms for all points at once, in
+ * structure-of-arrays form. The loops over the points are vectorized by
+ * the compiler; on x86-64 with GCC, AVX-512, AVX2, and scalar versions are
+ * built and the best one is selected at load time.
+ *
+ * The coefficients are read from CoolProp's fluid data. Fluids using terms
+ * that are not implemented here are rejected by helmholtzcreate(), as are
+ * fluids for which the kernel does not reproduce AbstractState_keyed_output
+ * at the validation states: two supercritical states, and dilute vapour,
+ * vapour, and liquid states next to the saturation dome at three
+ * temperatures. Callers then evaluate through CoolProp.
+ *
+ * The kernel evaluates the equation of state as is, so it does not know
+ * about phase equilibrium. Points below the critical temperature whose
+ * density is not clearly outside the saturation dome (judged by CoolProp's
+ * density ancillaries with their stated uncertainty) are left to the caller.
+ *
+ * Compile with -O3 -fopenmp-simd -fno-math-errno to have exp() and log()
+ * vectorized.
+ */
+
+#ifndef PROPSSIHELMHOLTZ_H_
+#define PROPSSIHELMHOLTZ_H_
+
+#include "propssiengine.h"
+
+/** Helmholtz energy equation of state of one fluid */
+typedef struct HELMHOLTZ HELMHOLTZ;
+
+/** Reads the equation of state of a fluid from CoolProp and validates the kernel against it
+ *
+ * @return equation of state, or NULL if the fluid is not supported (errmsg is set then).
+ */
+HELMHOLTZ* helmholtzcreate(
+   const char*           Fluid,           /**< fluid name */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Frees an equation of state */
+void helmholtzfree(
+   HELMHOLTZ*            eos              /**< equation of state, may be NULL */
+   );
+
+/** Evaluates a property at n (T, D) points
+ *
+ * Prop is one of the PropsSI names P, T, D, H, S, U, C (cp), O (cv), or A
+ * (speed of sound), in mass-based SI units.
+ *
+ * @return number of points that may be two-phase, for which out is NaN and the
+ *         caller has to use CoolProp, or -1 if Prop is not supported or memory
+ *         is exhausted (out is not written then).
+ */
+int helmholtzbatch(
+   const HELMHOLTZ*      eos,             /**< equation of state */
+   const char*           Prop,            /**< output property */
+   int                   n,               /**< number of points */
+   const double*         T,               /**< temperatures */
+   const double*         D,               /**< mass densities */
+   double*               out              /**< buffer to store n property values */
+   );
+
+#endif /* PROPSSIHELMHOLTZ_H_ */
@@ -0,0 +1,759 @@
+/** Mixtures for the extrinsic CoolProp library
+ *
+ * See propssimixture.h.
+ *
+ * CoolProp itself keeps the phase envelope of the current composition of
+ * a handle only, so switching fractions on a shared handle would rebuild
+ * it on every switch. We keep the envelopes of the last compositions
+ * instead and impose the phase on the flash ourselves.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "CoolPropLib.h"
+#include "propssiengine.h"
+#include "propssimixture.h"
+
+#define MIXTURE_MAXCOMP       20
+#define MIXTURE_MAXENVELOPES  8
+#define MIXTURE_MAXPOINTS     2000
+#define MIXTURE_NBINS         64
+#define MIXTURE_MAXCONFIG     64
+
+/* relative distance in temperature to the envelope within which the phase is not imposed */
+#define MIXTURE_PHASEMARGIN   0.005
+
+enum { PHASE_UNKNOWN, PHASE_LIQUID, PHASE_GAS, PHASE_TWOPHASE };
+
+MIXTURESTATS mixturestats;
+
+/** backend of a set of components */
+typedef struct
+{
+   char    components[ENGINE_MSGSIZE];  /**< component names separated by &, or * */
+   char    backend[8];
+} BACKENDCONFIG;
+
+/** binary interaction parameter of the cubic backends */
+typedef struct
+{
+   char    comp1[64];
+   char    comp2[64];
+   double  kij;
+} KIJCONFIG;
+
+/** alpha function of a component on the cubic backends */
+typedef struct
+{
+   char    comp[64];
+   char    form[8];                     /**< MC or TWU */
+   double  c[3];
+} ALPHACONFIG;
+
+static BACKENDCONFIG backends[MIXTURE_MAXCONFIG];
+static KIJCONFIG kijs[MIXTURE_MAXCONFIG];
+static ALPHACONFIG alphas[MIXTURE_MAXCONFIG];
+static int nbackends = 0;
+static int nkijs = 0;
+static int nalphas = 0;
+
+/** phase envelope of one composition as closed polygon in (T, ln p) */
+typedef struct
+{
+   double  z[MIXTURE_MAXCOMP];      /**< composition */
+   int     used;                    /**< whether a build was attempted for z */
+   int     built;                   /**< whether the envelope is available */
+   int     n;                       /**< number of points */
+   double* T;
+   double* lnp;
+   double  lnpmin;
+   double  lnpmax;
+   int     binstart[MIXTURE_NBINS+1]; /**< segments of bin b are segs[binstart[b]..binstart[b+1]-1] */
+   int*    segs;                    /**< segment i connects point i with point i+1 (mod n) */
+} ENVELOPE;
+
+struct MIXTURE
+{
+   long     handle;
+   char     components[ENGINE_MSGSIZE];  /**< component names separated by & */
+   int      ncomp;
+   double   z[MIXTURE_MAXCOMP];          /**< fractions set on the handle */
+   int      cubic;                       /**< whether the handle is on a cubic backend */
+   ENVELOPE env[MIXTURE_MAXENVELOPES];
+   int      nextenv;                     /**< slot to replace next */
+};
+
+/** Splits a mixture name into component names and fractions
+ *
+ * @return number of components, or -1 if the name is not a mixture with fractions.
+ */
+static int parsemixture(
+   const char*           Fluid,
+   char*                 components,
+   double*               z
+   )
+{
+   const char* p = Fluid;
+   int n = 0;
+
+   if( strncmp(p, "HEOS::", 6) == 0 )
+      p += 6;
+   components[0] = '\0';
+   while( *p != '\0' )
+   {
+      size_t len = strcspn(p, "[&");
+      char* end;
+
+      if( n == MIXTURE_MAXCOMP || p[len] != '[' || strlen(components) + len + 2 > ENGINE_MSGSIZE )
+         return -1;
+      if( n > 0 )
+         strcat(components, "&");
+      strncat(components, p, len);
+      p += len + 1;
+      z[n++] = strtod(p, &end);
+      if( end == p || *end != ']' )
+         return -1;
+      p = end + 1;
+      if( *p == '&' )
+         ++p;
+      else if( *p != '\0' )
+         return -1;
+   }
+   return n;
+}
+
+int mixtureconfig(
+   char*                 errmsg
+   )
+{
+   const char* name = getenv("PROPSSI_CUBIC");
+   char line[512];
+   FILE* f;
+   int lineno = 0;
+
+   nbackends = nkijs = nalphas = 0;
+   if( name == NULL || name[0] == '\0' )
+      return 0;
+   f = fopen(name, "r");
+   if( f == NULL )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Cannot open cubic configuration PROPSSI_CUBIC=%.150s.", name);
+      return 1;
+   }
+   while( fgets(line, sizeof(line), f) != NULL )
+   {
+      char word[16];
+      int ok = 0;
+      int n = -1;
+
+      ++lineno;
+      if( sscanf(line, "%15s", word) != 1 || word[0] == '#' )
+         continue;
+      if( strcmp(word, "backend") == 0 && nbackends < MIXTURE_MAXCONFIG )
+      {
+         BACKENDCONFIG* b = &backends[nbackends];
+         ok = sscanf(line, "%*s %255s %7s %n", b->components, b->backend, &n) == 2
+            && (strcmp(b->backend, "HEOS") == 0 || strcmp(b->backend, "PR") == 0 || strcmp(b->backend, "SRK") == 0);
+         nbackends += ok;
+      }
+      else if( strcmp(word, "kij") == 0 && nkijs < MIXTURE_MAXCONFIG )
+      {
+         KIJCONFIG* k = &kijs[nkijs];
+         ok = sscanf(line, "%*s %63s %63s %lf %n", k->comp1, k->comp2, &k->kij, &n) == 3;
+         nkijs += ok;
+      }
+      else if( strcmp(word, "alpha") == 0 && nalphas < MIXTURE_MAXCONFIG )
+      {
+         ALPHACONFIG* a = &alphas[nalphas];
+         ok = sscanf(line, "%*s %63s %7s %lf %lf %lf %n", a->comp, a->form, &a->c[0], &a->c[1], &a->c[2], &n) == 5
+            && (strcmp(a->form, "MC") == 0 || strcmp(a->form, "TWU") == 0);
+         nalphas += ok;
+      }
+      if( !ok || line[n] != '\0' )
+      {
+         snprintf(errmsg, ENGINE_MSGSIZE, "Invalid line %d in cubic configuration %.150s.", lineno, name);
+         fclose(f);
+         nbackends = nkijs = nalphas = 0;
+         return 1;
+      }
+   }
+   fclose(f);
+   return 0;
+}
+
+const char* mixturebackend(
+   const char*           Fluid
+   )
+{
+   char components[ENGINE_MSGSIZE];
+   double z[MIXTURE_MAXCOMP];
+   const char* backend = "HEOS";
+   int i;
+
+   if( nbackends == 0 || parsemixture(Fluid, components, z) < 0 )
+      return backend;
+   for( i = 0; i < nbackends; ++i )
+   {
+      if( strcmp(backends[i].components, components) == 0 )
+         return backends[i].backend;
+      if( strcmp(backends[i].components, "*") == 0 )
+         backend = backends[i].backend;
+   }
+   return backend;
+}
+
+int mixtureis(
+   const char*           Fluid
+   )
+{
+   return strchr(Fluid, '&') != NULL;
+}
+
+/** Splits component names separated by & */
+static void componentnames(
+   const char*           components,
+   int                   ncomp,
+   char                  names[MIXTURE_MAXCOMP][64]
+   )
+{
+   const char* p = components;
+   int i;
+
+   for( i = 0; i < ncomp; ++i )
+   {
+      size_t n = strcspn(p, "&");
+      snprintf(names[i], sizeof(names[i]), "%.*s", (int)n, p);
+      p += n + (p[n] == '&');
+   }
+}
+
+uint64_t mixtureparameters(
+   const char*           Fluid
+   )
+{
+   char components[ENGINE_MSGSIZE];
+   char names[MIXTURE_MAXCOMP][64];
+   char item[256];
+   double z[MIXTURE_MAXCOMP];
+   uint64_t h = 0xcbf29ce484222325ULL;   /* FNV-1a */
+   int napplied = 0;
+   int ncomp, i, j, k;
+
+   ncomp = parsemixture(Fluid, components, z);
+   if( ncomp < 2 )
+      return 0;
+   componentnames(components, ncomp, names);
+   /* in the order setcubic() applies them, since later lines override earlier ones */
+   for( k = 0; k < nkijs + nalphas; ++k )
+      for( i = 0; i < ncomp; ++i )
+         for( j = k < nkijs ? i+1 : i; j < ncomp; ++j )
+         {
+            const char* c;
+
+            if( k < nkijs && ((strcmp(kijs[k].comp1, names[i]) == 0 && strcmp(kijs[k].comp2, names[j]) == 0)
+                  || (strcmp(kijs[k].comp1, names[j]) == 0 && strcmp(kijs[k].comp2, names[i]) == 0)) )
+               snprintf(item, sizeof(item), "kij %d %d %.17g;", i, j, kijs[k].kij);
+            else if( k >= nkijs && j == i && strcmp(alphas[k-nkijs].comp, names[i]) == 0 )
+               snprintf(item, sizeof(item), "alpha %d %s %.17g %.17g %.17g;", i, alphas[k-nkijs].form,
+                  alphas[k-nkijs].c[0], alphas[k-nkijs].c[1], alphas[k-nkijs].c[2]);
+            else
+               continue;
+            for( c = item; *c != '\0'; ++c )
+               h = (h ^ (unsigned char)*c) * 0x100000001b3ULL;
+            ++napplied;
+         }
+   return napplied > 0 ? h : 0;
+}
+
+/** Sets the configured interaction and alpha parameters of the components on a cubic handle */
+static int setcubic(
+   MIXTURE*              mix,
+   char*                 errmsg
+   )
+{
+   char names[MIXTURE_MAXCOMP][64];
+   long errcode = 0;
+   int i, j, k;
+
+   componentnames(mix->components, mix->ncomp, names);
+   for( k = 0; k < nkijs && errcode == 0; ++k )
+      for( i = 0; i < mix->ncomp; ++i )
+         for( j = i+1; j < mix->ncomp; ++j )
+            if( (strcmp(kijs[k].comp1, names[i]) == 0 && strcmp(kijs[k].comp2, names[j]) == 0)
+               || (strcmp(kijs[k].comp1, names[j]) == 0 && strcmp(kijs[k].comp2, names[i]) == 0) )
+               AbstractState_set_binary_interaction_double(mix->handle, i, j, "kij", kijs[k].kij, &errcode, errmsg, ENGINE_MSGSIZE);
+   for( k = 0; k < nalphas && errcode == 0; ++k )
+      for( i = 0; i < mix->ncomp; ++i )
+         if( strcmp(alphas[k].comp, names[i]) == 0 )
+            AbstractState_set_cubic_alpha_C(mix->handle, i, alphas[k].form, alphas[k].c[0], alphas[k].c[1], alphas[k].c[2],
+               &errcode, errmsg, ENGINE_MSGSIZE);
+   return errcode != 0;
+}
+
+MIXTURE* mixturecreate(
+   const char*           Fluid,
+   const char*           backend,
+   char*                 errmsg
+   )
+{
+   MIXTURE* mix;
+   double z[MIXTURE_MAXCOMP];
+   long errcode = 0;
+
+   mix = calloc(1, sizeof(MIXTURE));
+   if( mix == NULL )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Out of memory.");
+      return NULL;
+   }
+   mix->ncomp = parsemixture(Fluid, mix->components, z);
+   if( mix->ncomp < 2 )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Mixture %.150s needs components with mole fractions, e.g. Methane[0.9]&Ethane[0.1].", Fluid);
+      free(mix);
+      return NULL;
+   }
+   mix->handle = AbstractState_factory(backend, mix->components, &errcode, errmsg, ENGINE_MSGSIZE);
+   if( errcode != 0 )
+   {
+      free(mix);
+      return NULL;
+   }
+   mix->cubic = strcmp(backend, "HEOS") != 0;
+   if( mix->cubic && setcubic(mix, errmsg) != 0 )
+   {
+      mixturefree(mix);
+      return NULL;
+   }
+   return mix;
+}
+
+void mixturefree(
+   MIXTURE*              mix
+   )
+{
+   char buf[ENGINE_MSGSIZE];
+   long errcode;
+   int i;
+
+   if( mix == NULL )
+      return;
+   AbstractState_free(mix->handle, &errcode, buf, sizeof(buf));
+   for( i = 0; i < MIXTURE_MAXENVELOPES; ++i )
+   {
+      free(mix->env[i].T);
+      free(mix->env[i].lnp);
+      free(mix->env[i].segs);
+   }
+   free(mix);
+}
+
+const char* mixturecomponents(
+   const MIXTURE*        mix
+   )
+{
+   return mix->components;
+}
+
+int mixturematches(
+   const MIXTURE*        mix,
+   const char*           Fluid
+   )
+{
+   char components[ENGINE_MSGSIZE];
+   double z[MIXTURE_MAXCOMP];
+
+   return parsemixture(Fluid, components, z) == mix->ncomp && strcmp(components, mix->components) == 0;
+}
+
+long mixturehandle(
+   MIXTURE*              mix,
+   const char*           Fluid,
+   char*                 errmsg
+   )
+{
+   char components[ENGINE_MSGSIZE];
+   double z[MIXTURE_MAXCOMP];
+   long errcode = 0;
+
+   if( parsemixture(Fluid, components, z) != mix->ncomp )
+   {
+      snprintf(errmsg, ENGINE_MSGSIZE, "Invalid mixture %.200s.", Fluid);
+      return -1;
+   }
+   if( memcmp(z, mix->z, mix->ncomp * sizeof(double)) != 0 )
+   {
+      AbstractState_set_fractions(mix->handle, z, mix->ncomp, &errcode, errmsg, ENGINE_MSGSIZE);
+      ++mixturestats.fractionsets;
+      if( errcode != 0 )
+      {
+         /* make sure the fractions are set again next time */
+         memset(mix->z, 0, sizeof(mix->z));
+         return -1;
+      }
+      memcpy(mix->z, z, mix->ncomp * sizeof(double));
+   }
+   return mix->handle;
+}
+
+/** Builds the phase envelope for the current fractions of the handle */
+static void buildenvelope(
+   MIXTURE*              mix,
+   ENVELOPE*             env
+   )
+{
+   char buf[ENGINE_MSGSIZE];
+   double *T, *p, *rhov, *rhol, *x, *y;
+   long errcode = 0;
+   int count[MIXTURE_NBINS];
+   int i, b, n;
+
+   memcpy(env->z, mix->z, sizeof(env->z));
+   env->used = 1;
+   env->built = 0;
+   env->n = 0;
+
+   T = malloc(MIXTURE_MAXPOINTS * sizeof(double));
+   p = malloc(MIXTURE_MAXPOINTS * sizeof(double));
+   rhov = malloc(MIXTURE_MAXPOINTS * sizeof(double));
+   rhol = malloc(MIXTURE_MAXPOINTS * sizeof(double));
+   x = malloc((size_t)MIXTURE_MAXPOINTS * mix->ncomp * sizeof(double));
+   y = malloc((size_t)MIXTURE_MAXPOINTS * mix->ncomp * sizeof(double));
+   if( T == NULL || p == NULL || rhov == NULL || rhol == NULL || x == NULL || y == NULL )
+      goto TERMINATE;
+
+   ++mixturestats.envelopes;
+   AbstractState_build_phase_envelope(mix->handle, "none", &errcode, buf, sizeof(buf));
+   if( errcode != 0 )
+      goto TERMINATE;
+   /* CoolProp fills only as many points as the envelope has */
+   for( i = 0; i < MIXTURE_MAXPOINTS; ++i )
+      T[i] = NAN;
+   AbstractState_get_phase_envelope_data(mix->handle, MIXTURE_MAXPOINTS, T, p, rhov, rhol, x, y, &errcode, buf, sizeof(buf));
+   if( errcode != 0 )
+      goto TERMINATE;
+   for( n = 0; n < MIXTURE_MAXPOINTS && isfinite(T[n]) && p[n] > 0.0; ++n )
+      ;
+   if( n < 3 )
+      goto TERMINATE;
+
+   free(env->T);
+   free(env->lnp);
+   free(env->segs);
+   env->T = malloc(n * sizeof(double));
+   env->lnp = malloc(n * sizeof(double));
+   env->segs = NULL;
+   if( env->T == NULL || env->lnp == NULL )
+      goto TERMINATE;
+
+   env->lnpmin = env->lnpmax = log(p[0]);
+   for( i = 0; i < n; ++i )
+   {
+      env->T[i] = T[i];
+      env->lnp[i] = log(p[i]);
+      if( env->lnp[i] < env->lnpmin )
+         env->lnpmin = env->lnp[i];
+      if( env->lnp[i] > env->lnpmax )
+         env->lnpmax = env->lnp[i];
+   }
+   env->n = n;
+
+   /* index the segments by the pressure bins they cover; two passes to count and fill */
+   memset(count, 0, sizeof(count));
+   for( b = 0; b < 2; ++b )
+   {
+      if( b == 1 )
+      {
+         env->binstart[0] = 0;
+         for( i = 0; i < MIXTURE_NBINS; ++i )
+            env->binstart[i+1] = env->binstart[i] + count[i];
+         env->segs = malloc((env->binstart[MIXTURE_NBINS] + 1) * sizeof(int));
+         if( env->segs == NULL )
+            goto TERMINATE;
+         memset(count, 0, sizeof(count));
+      }
+      for( i = 0; i < n; ++i )
+      {
+         double lo = env->lnp[i];
+         double hi = env->lnp[(i+1) % n];
+         double w = (env->lnpmax - env->lnpmin) / MIXTURE_NBINS;
+         int k, klo, khi;
+
+         if( lo > hi )
+         {
+            double t = lo;
+            lo = hi;
+            hi = t;
+         }
+         klo = w > 0.0 ? (int)((lo - env->lnpmin) / w) : 0;
+         khi = w > 0.0 ? (int)((hi - env->lnpmin) / w) : 0;
+         if( khi >= MIXTURE_NBINS )
+            khi = MIXTURE_NBINS - 1;
+         if( klo >= MIXTURE_NBINS )
+            klo = MIXTURE_NBINS - 1;
+         for( k = klo; k <= khi; ++k )
+         {
+            if( b == 1 )
+               env->segs[env->binstart[k] + count[k]] = i;
+            ++count[k];
+         }
+      }
+   }
+   env->built = 1;
+
+TERMINATE:
+   free(T);
+   free(p);
+   free(rhov);
+   free(rhol);
+   free(x);
+   free(y);
+}
+
+/** Returns the phase envelope for the current fractions, building it on first use */
+static ENVELOPE* envelope(
+   MIXTURE*              mix
+   )
+{
+   ENVELOPE* env;
+   int i;
+
+   /* failed builds are kept too, so they are not retried for the same composition */
+   for( i = 0; i < MIXTURE_MAXENVELOPES; ++i )
+      if( mix->env[i].used && memcmp(mix->env[i].z, mix->z, sizeof(mix->z)) == 0 )
+         return &mix->env[i];
+
+   env = &mix->env[mix->nextenv];
+   mix->nextenv = (mix->nextenv + 1) % MIXTURE_MAXENVELOPES;
+   buildenvelope(mix, env);
+   return env;
+}
+
+/** Classifies a pressure-temperature state by the phase envelope */
+static int classify(
+   const ENVELOPE*       env,
+   double                T,
+   double                p
+   )
+{
+   double lnp;
+   int right = 0;
+   int b, k;
+
+   if( !env->built || !(p > 0.0) )
+      return PHASE_UNKNOWN;
+   lnp = log(p);
+   /* the trace may have stopped early, and compressed liquids lie above it */
+   if( lnp >= env->lnpmax || lnp < env->lnpmin )
+      return PHASE_UNKNOWN;
+
+   b = (int)((lnp - env->lnpmin) / (env->lnpmax - env->lnpmin) * MIXTURE_NBINS);
+   if( b >= MIXTURE_NBINS )
+      b = MIXTURE_NBINS - 1;
+   for( k = env->binstart[b]; k < env->binstart[b+1]; ++k )
+   {
+      int i = env->segs[k];
+      int j = (i + 1) % env->n;
+      double Tcross;
+
+      /* half-open rule, so that a vertex on the ray is counted once */
+      if( (env->lnp[i] <= lnp) == (env->lnp[j] <= lnp) )
+         continue;
+      Tcross = env->T[i] + (env->T[j] - env->T[i]) * (lnp - env->lnp[i]) / (env->lnp[j] - env->lnp[i]);
+      if( fabs(Tcross - T) < MIXTURE_PHASEMARGIN * T )
+         return PHASE_UNKNOWN;
+      if( Tcross > T )
+         ++right;
+   }
+   if( right % 2 == 1 )
+      return PHASE_TWOPHASE;
+   return right == 0 ? PHASE_GAS : PHASE_LIQUID;
+}
+
+/** Updates the handle and evaluates a first partial derivative */
+static double partialat(
+   long                  handle,
+   long                  pair,
+   double                a,
+   double                b,
+   long                  of,
+   long                  wrt,
+   long                  constant,
+   long*                 errcode,
+   char*                 errmsg
+   )
+{
+   AbstractState_update(handle, pair, a, b, errcode, errmsg, ENGINE_MSGSIZE);
+   if( *errcode != 0 )
+      return NAN;
+   return AbstractState_first_partial_deriv(handle, of, wrt, constant, errcode, errmsg, ENGINE_MSGSIZE);
+}
+
+/** Updates the handle and evaluates a property */
+static double valueat(
+   long                  handle,
+   long                  pair,
+   int                   swap,
+   double                v1,
+   double                v2,
+   long                  of,
+   long*                 errcode,
+   char*                 errmsg
+   )
+{
+   AbstractState_update(handle, pair, swap ? v2 : v1, swap ? v1 : v2, errcode, errmsg, ENGINE_MSGSIZE);
+   if( *errcode != 0 )
+      return NAN;
+   return AbstractState_keyed_output(handle, of, errcode, errmsg, ENGINE_MSGSIZE);
+}
+
+/** Computes the derivatives by central differences of the values
+ *
+ * @return 0 if successful, 1 if a neighbouring state failed (errmsg is set then).
+ */
+static int valuediffs(
+   long                  handle,
+   long                  pair,
+   int                   swap,
+   double                Val1,
+   double                Val2,
+   long                  of,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   double h1 = 1e-5 * fabs(Val1) + 1e-8;
+   double h2 = 1e-5 * fabs(Val2) + 1e-8;
+   double f[3][3];
+   long errcode = 0;
+   int i, j;
+
+   /* f[i][j] at Val1 + (i-1) h1, Val2 + (j-1) h2; corners only for the mixed derivative */
+   f[1][1] = d[0];
+   for( i = 0; i < 3; ++i )
+      for( j = 0; j < 3 && errcode == 0; ++j )
+         if( (i != 1 || j != 1) && (derivrequest > 1 || i == 1 || j == 1) )
+            f[i][j] = valueat(handle, pair, swap, Val1 + (i-1) * h1, Val2 + (j-1) * h2, of, &errcode, errmsg);
+   if( errcode != 0 )
+      return 1;
+   d[1] = (f[2][1] - f[0][1]) / (2.0 * h1);
+   d[2] = (f[1][2] - f[1][0]) / (2.0 * h2);
+   if( derivrequest > 1 )
+   {
+      d[3] = (f[2][1] - 2.0 * f[1][1] + f[0][1]) / (h1 * h1);
+      d[4] = (f[2][2] - f[2][0] - f[0][2] + f[0][0]) / (4.0 * h1 * h2);
+      d[5] = (f[1][2] - 2.0 * f[1][1] + f[1][0]) / (h2 * h2);
+   }
+   return 0;
+}
+
+int mixtureeval(
+   MIXTURE*              mix,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   long handle, pair, of, wrt1, wrt2;
+   long errcode = 0;
+   int swap, imposed = 0;
+   int rc = 0;
+   int i;
+
+   handle = mixturehandle(mix, Fluid, errmsg);
+   if( handle < 0 )
+      return 1;
+   pair = inputpair(Name1, Name2, &swap);
+   of = get_param_index(Prop);
+   wrt1 = get_param_index(Name1);
+   wrt2 = get_param_index(Name2);
+   if( pair < 0 || of < 0 || wrt1 < 0 || wrt2 < 0 )
+      return -1;
+
+   ++mixturestats.flashes;
+   mixturestats.cubicflashes += mix->cubic;
+   if( pair == get_input_pair_index("PT_INPUTS") )
+   {
+      double p = swap ? Val2 : Val1;
+      double T = swap ? Val1 : Val2;
+      int phase = classify(envelope(mix), T, p);
+      if( phase != PHASE_UNKNOWN && phase != PHASE_TWOPHASE )
+      {
+         AbstractState_specify_phase(handle, phase == PHASE_LIQUID ? "phase_liquid" : "phase_gas", &errcode, errmsg, ENGINE_MSGSIZE);
+         imposed = errcode == 0;
+         mixturestats.imposed += imposed;
+         errcode = 0;
+      }
+   }
+
+   memset(d, 0, 6 * sizeof(double));
+#define UPDATE(v1, v2) AbstractState_update(handle, pair, swap ? (v2) : (v1), swap ? (v1) : (v2), &errcode, errmsg, ENGINE_MSGSIZE)
+   UPDATE(Val1, Val2);
+   if( errcode == 0 )
+      d[0] = AbstractState_keyed_output(handle, of, &errcode, errmsg, ENGINE_MSGSIZE);
+   if( errcode != 0 )
+      rc = 1;
+   if( rc == 0 && derivrequest > 0 )
+   {
+      d[1] = AbstractState_first_partial_deriv(handle, of, wrt1, wrt2, &errcode, errmsg, ENGINE_MSGSIZE);
+      if( errcode == 0 )
+         d[2] = AbstractState_first_partial_deriv(handle, of, wrt2, wrt1, &errcode, errmsg, ENGINE_MSGSIZE);
+      if( errcode != 0 )
+         rc = -1;
+   }
+   if( rc == 0 && derivrequest > 1 )
+   {
+      double h1 = 1e-5 * fabs(Val1) + 1e-8;
+      double h2 = 1e-5 * fabs(Val2) + 1e-8;
+      double s1 = swap ? Val2 : Val1;
+      double s2 = swap ? Val1 : Val2;
+      double a, b;
+      double f1p = 0.0, f1m = 0.0, f12p = 0.0, f12m = 0.0, f2p = 0.0, f2m = 0.0;
+
+      /* central differences of the first derivatives; the inputs are in CoolProp's order for partialat */
+      a = swap ? s1 : s1 + h1;  b = swap ? s2 + h1 : s2;
+      f1p = partialat(handle, pair, a, b, of, wrt1, wrt2, &errcode, errmsg);
+      a = swap ? s1 : s1 - h1;  b = swap ? s2 - h1 : s2;
+      if( errcode == 0 )
+         f1m = partialat(handle, pair, a, b, of, wrt1, wrt2, &errcode, errmsg);
+      a = swap ? s1 + h2 : s1;  b = swap ? s2 : s2 + h2;
+      if( errcode == 0 )
+         f12p = partialat(handle, pair, a, b, of, wrt1, wrt2, &errcode, errmsg);
+      if( errcode == 0 )
+         f2p = AbstractState_first_partial_deriv(handle, of, wrt2, wrt1, &errcode, errmsg, ENGINE_MSGSIZE);
+      a = swap ? s1 - h2 : s1;  b = swap ? s2 : s2 - h2;
+      if( errcode == 0 )
+         f12m = partialat(handle, pair, a, b, of, wrt1, wrt2, &errcode, errmsg);
+      if( errcode == 0 )
+         f2m = AbstractState_first_partial_deriv(handle, of, wrt2, wrt1, &errcode, errmsg, ENGINE_MSGSIZE);
+      if( errcode != 0 )
+         rc = -1;
+      else
+      {
+         d[3] = (f1p - f1m) / (2.0 * h1);
+         d[4] = (f12p - f12m) / (2.0 * h2);
+         d[5] = (f2p - f2m) / (2.0 * h2);
+      }
+   }
+#undef UPDATE
+
+   if( imposed )
+      AbstractState_unspecify_phase(handle, &errcode, errmsg, ENGINE_MSGSIZE);
+   /* PropsSI would not know the parameters of the cubic handle */
+   if( rc < 0 && mix->cubic )
+      rc = valuediffs(handle, pair, swap, Val1, Val2, of, derivrequest, d, errmsg);
+   for( i = 0; i < 6 && rc == 0; ++i )
+      if( !isfinite(d[i]) )
+         rc = -1;
+   return rc;
+}
@@ -0,0 +1,145 @@
+/** Mixtures for the extrinsic CoolProp library
+ *
+ * Mixtures are given in CoolProp's PropsSI notation with mole fractions,
+ * e.g. "Methane[0.9]&Ethane[0.1]". All mixtures of the same components
+ * share one HEOS AbstractState handle; its fractions are only set when
+ * they differ from the last evaluation.
+ *
+ * Mixture flashes are much slower than flashes of pure fluids, mostly
+ * because of the phase stability analysis. For each composition, the
+ * phase envelope is therefore built once and kept as a polygon in
+ * (T, ln p), indexed by pressure. Pressure-temperature inputs that are
+ * clearly outside the envelope, at a pressure within the range of the
+ * traced envelope, are flashed with the phase imposed; CoolProp decides
+ * the phase of all other states.
+ *
+ * For screening studies, mixtures may run on CoolProp's cubic backends
+ * instead. If PROPSSI_CUBIC names a configuration file, its lines
+ *
+ *   backend <components> <HEOS|PR|SRK>
+ *   kij <component> <component> <value>
+ *   alpha <component> <MC|TWU> <c1> <c2> <c3>
+ *
+ * select the backend for a set of components (separated by & in the
+ * order of the mixture name, or * for all other mixtures), and give
+ * binary interaction parameters and Mathias-Copeman or Twu alpha
+ * functions of the cubic backends. Lines starting with # are comments.
+ * The parameters are set once when the handle is created. States of the
+ * cubic backends are cached under the backend and a hash of the applied
+ * parameters, so processes sharing a state cache may use different
+ * configurations.
+ */
+
+#ifndef PROPSSIMIXTURE_H_
+#define PROPSSIMIXTURE_H_
+
+#include <stdint.h>
+
+/** counters of the mixture evaluations */
+typedef struct
+{
+   unsigned long         flashes;         /**< mixture states evaluated */
+   unsigned long         imposed;         /**< of those, flashed with the phase imposed from the envelope */
+   unsigned long         fractionsets;    /**< calls of AbstractState_set_fractions */
+   unsigned long         envelopes;       /**< phase envelopes built */
+   unsigned long         cubicflashes;    /**< of the flashes, on a cubic backend */
+} MIXTURESTATS;
+
+/** statistics of this process */
+extern MIXTURESTATS mixturestats;
+
+/** handle and phase envelopes of the mixtures of a set of components */
+typedef struct MIXTURE MIXTURE;
+
+/** Reads the configuration of the cubic backends from the file named by PROPSSI_CUBIC
+ *
+ * @return 0 if successful or not configured, <> 0 if the configuration is invalid (errmsg is set then).
+ */
+int mixtureconfig(
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Returns the backend configured for the components of a mixture: HEOS, PR, or SRK */
+const char* mixturebackend(
+   const char*           Fluid            /**< mixture name with fractions */
+   );
+
+/** Hashes the interaction and alpha parameters of PROPSSI_CUBIC that apply to the components of a mixture
+ *
+ * States of cubic backends depend on these parameters, so the hash is
+ * part of the fluid name their cache entries are keyed by.
+ *
+ * @return hash, 0 if no parameters apply.
+ */
+uint64_t mixtureparameters(
+   const char*           Fluid            /**< mixture name with fractions */
+   );
+
+/** Checks whether a fluid name denotes a mixture */
+int mixtureis(
+   const char*           Fluid            /**< fluid name */
+   );
+
+/** Creates the handle for the components of a mixture
+ *
+ * On the cubic backends, the configured interaction and alpha parameters
+ * of the components are set on the handle.
+ *
+ * @return mixture, or NULL if CoolProp does not know the components or parameters (errmsg is set then).
+ */
+MIXTURE* mixturecreate(
+   const char*           Fluid,           /**< mixture name with fractions */
+   const char*           backend,         /**< CoolProp backend, e.g. from mixturebackend() */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Frees a mixture */
+void mixturefree(
+   MIXTURE*              mix              /**< mixture, may be NULL */
+   );
+
+/** Returns the component names of a mixture, separated by & */
+const char* mixturecomponents(
+   const MIXTURE*        mix              /**< mixture */
+   );
+
+/** Checks whether a mixture name has the components of a mixture handle */
+int mixturematches(
+   const MIXTURE*        mix,             /**< mixture */
+   const char*           Fluid            /**< mixture name with fractions */
+   );
+
+/** Returns the AbstractState handle of a mixture with the fractions of a mixture name set
+ *
+ * @return handle, or -1 if the fractions are invalid (errmsg is set then).
+ */
+long mixturehandle(
+   MIXTURE*              mix,             /**< mixture */
+   const char*           Fluid,           /**< mixture name with fractions */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Evaluates a property of a mixture and its partial derivatives with respect to the two state inputs.
+ *
+ * See evalprops() for the derivatives. Second derivatives are central
+ * differences of CoolProp's first partial derivatives. On the cubic
+ * backends, derivatives that CoolProp does not provide (e.g. in the
+ * two-phase region) are central differences of the values.
+ *
+ * @return 0 if successful, 1 if CoolProp could not evaluate the state (errmsg is set then),
+ *         -1 if the derivatives are not available from the handle (e.g. in the two-phase region on HEOS).
+ */
+int mixtureeval(
+   MIXTURE*              mix,             /**< mixture */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< mixture name with fractions */
+   int                   derivrequest,    /**< highest derivative to compute */
+   double                d[6],            /**< buffer for f, df/d1, df/d2, d2f/d1d1, d2f/d1d2, d2f/d2d2 */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+#endif /* PROPSSIMIXTURE_H_ */
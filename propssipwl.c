@@ -0,0 +1,477 @@
+/** Piecewise-linear property approximations for MILP and LP models
+ *
+ * Computes breakpoints of a property over a range of one or two state
+ * inputs such that linear interpolation between them meets a target
+ * error, and writes them as a GAMS $include file. Models that cannot
+ * call PropsSI2 can then use the breakpoints in a piecewise-linear
+ * (SOS2 or lambda) formulation, e.g. in one input
+ *
+ *   SOS2 Variable lam(i);
+ *   x =e= sum(i, lam(i) * pwl_x(i));
+ *   f =e= sum(i, lam(i) * pwl_f(i));
+ *   sum(i, lam(i)) =e= 1;
+ *
+ * and in two inputs with lam(i,j), one SOS2 set each over the sums
+ * of lam along i and along j.
+ *
+ * Starting from a coarse grid, an interval is halved wherever the value
+ * at its midpoint deviates from the interpolation by more than the
+ * target error. In two inputs, the grid is the product of the
+ * breakpoints of both inputs, and the midpoints of the edges and the
+ * centers of the cells are checked. Since the lambda formulation may
+ * take any convex combination of the corners of a cell, the interpolation
+ * at a center ranges between the averages of the two diagonals, and both
+ * are checked. Values are kept as the grid is refined, so each iteration
+ * evaluates only the new breakpoints and midpoints. States are
+ * evaluated by the engine of the function library (see evalprops()) on
+ * parallel threads, so the state cache of PROPSSI_SHMCACHE is used and
+ * filled. States CoolProp cannot evaluate are written as NA; a
+ * piecewise-linear model should not cross them.
+ *
+ * Usage:
+ *
+ *   propssipwl [-a abserr] [-e relerr] [-j threads] [-n maxpoints] [-o outfile] [-p prefix]
+ *              output name1 lo1 hi1 name2 lo2 hi2 fluid
+ *
+ * e.g. "propssipwl -e 1e-4 -p hsteam H P 1e5 1e7 T 600 900 Water". If
+ * lo2 equals hi2, the approximation is in the first input only. The error
+ * defaults to a relative error of 1e-3 (a point meets the target if it
+ * meets either of the absolute or relative error), the number of
+ * breakpoints per input to 200, and the prefix of the GAMS symbols to pwl.
+ *
+ * Compilation:
+ *
+ *   gcc -O2 -o propssipwl propssipwl.c propssiengine.c propssicache.c
+ *       libCoolProp.[so|dylib] -lm -lpthread [-lrt on Linux]
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "propssiengine.h"
+
+#define PWL_MAXTHREADS  256
+#define PWL_INITPOINTS  5
+
+/** states to evaluate */
+typedef struct
+{
+   PROPSSICACHE*    cache;
+   const char*      prop;
+   const char*      name1;
+   const char*      name2;
+   const char*      fluid;
+   int              n;
+   const double*    v1;
+   const double*    v2;
+   double*          f;              /**< values, NaN if failed */
+} BATCH;
+
+/** work of one thread */
+typedef struct
+{
+   BATCH*   batch;
+   int      first;
+   int      last;
+} WORK;
+
+static int nthreads = 1;
+static double abserr = 0.0;
+static double relerr = 1e-3;
+
+static void* evalrange(
+   void*                 arg
+   )
+{
+   WORK* w = (WORK*)arg;
+   BATCH* b = w->batch;
+   char errmsg[ENGINE_MSGSIZE];
+   double d[6];
+   int i;
+
+   for( i = w->first; i < w->last; ++i )
+      b->f[i] = evalprops(b->cache, b->prop, b->name1, b->v1[i], b->name2, b->v2[i], b->fluid, 0, d, errmsg) == 0 ? d[0] : NAN;
+   return NULL;
+}
+
+/** Evaluates the states of a batch on all threads */
+static void evalbatch(
+   BATCH*                b
+   )
+{
+   WORK work[PWL_MAXTHREADS];
+   pthread_t threads[PWL_MAXTHREADS];
+   int started[PWL_MAXTHREADS];
+   int t;
+
+   for( t = 0; t < nthreads; ++t )
+   {
+      work[t].batch = b;
+      work[t].first = (int)((long)b->n * t / nthreads);
+      work[t].last = (int)((long)b->n * (t+1) / nthreads);
+      started[t] = t > 0 && pthread_create(&threads[t], NULL, evalrange, &work[t]) == 0;
+   }
+   evalrange(&work[0]);
+   for( t = 1; t < nthreads; ++t )
+      if( started[t] )
+         pthread_join(threads[t], NULL);
+      else
+         evalrange(&work[t]);
+}
+
+/** Checks a value against its interpolation, keeping track of the largest errors
+ *
+ * @return whether the target error is violated.
+ */
+static int violates(
+   double                f,
+   double                interp,
+   double*               maxabs,
+   double*               maxrel
+   )
+{
+   double err = fabs(f - interp);
+
+   if( !isfinite(f) || !isfinite(interp) )
+      return 0;
+   if( err > *maxabs )
+      *maxabs = err;
+   if( f != 0.0 && err / fabs(f) > *maxrel )
+      *maxrel = err / fabs(f);
+   return err > abserr && err > relerr * fabs(f);
+}
+
+/** Halves the marked intervals of the breakpoints
+ *
+ * Positions along an input are numbered 2i for breakpoint i and 2i+1 for
+ * the midpoint of interval i. For each position of the new breakpoints,
+ * map receives the position of the old breakpoints at the same value, or
+ * -1 if there is none.
+ *
+ * @return new number of breakpoints
+ */
+static int refine(
+   double*               x,
+   int                   n,
+   const int*            marked,
+   int*                  map
+   )
+{
+   double* old = malloc(n * sizeof(double));
+   int i, m = 0;
+
+   memcpy(old, x, n * sizeof(double));
+   for( i = 0; i < n; ++i )
+   {
+      map[2*m] = 2*i;
+      x[m++] = old[i];
+      if( i < n-1 && marked[i] )
+      {
+         map[2*m] = 2*i+1;
+         x[m++] = 0.5 * (old[i] + old[i+1]);
+      }
+   }
+   /* the midpoint of an interval that was not halved is an old midpoint */
+   for( i = 0; i < m-1; ++i )
+      map[2*i+1] = map[2*i] % 2 == 0 && map[2*i+2] == map[2*i] + 2 ? map[2*i] + 1 : -1;
+   free(old);
+   return m;
+}
+
+/** Writes the breakpoints as GAMS sets and parameters */
+static void writegams(
+   FILE*                 out,
+   const char*           prefix,
+   const char*           Prop,
+   const char*           Name1,
+   const double*         x,
+   int                   nx,
+   const char*           Name2,
+   const double*         y,
+   int                   ny,
+   const char*           Fluid,
+   const double*         F,
+   double                maxabs,
+   double                maxrel
+   )
+{
+   int i, j;
+
+   fprintf(out, "* Piecewise-linear approximation of %s(%s,%s) of %s, generated by propssipwl\n", Prop, Name1, Name2, Fluid);
+   if( ny == 1 )
+      fprintf(out, "* at %s = %.17g\n", Name2, y[0]);
+   fprintf(out, "* largest interpolation error found: %.3g (absolute), %.3g (relative)\n\n", maxabs, maxrel);
+
+   fprintf(out, "Set %s_i 'breakpoints of %s' / i1*i%d /;\n", prefix, Name1, nx);
+   if( ny > 1 )
+      fprintf(out, "Set %s_j 'breakpoints of %s' / j1*j%d /;\n", prefix, Name2, ny);
+   fprintf(out, "\nParameter %s_x(%s_i) '%s at the breakpoints' /\n", prefix, prefix, Name1);
+   for( i = 0; i < nx; ++i )
+      fprintf(out, "   i%d %.17g\n", i+1, x[i]);
+   fprintf(out, "   /;\n");
+   if( ny > 1 )
+   {
+      fprintf(out, "\nParameter %s_y(%s_j) '%s at the breakpoints' /\n", prefix, prefix, Name2);
+      for( j = 0; j < ny; ++j )
+         fprintf(out, "   j%d %.17g\n", j+1, y[j]);
+      fprintf(out, "   /;\n");
+      fprintf(out, "\nParameter %s_f(%s_i,%s_j) '%s at the breakpoints' /\n", prefix, prefix, prefix, Prop);
+   }
+   else
+      fprintf(out, "\nParameter %s_f(%s_i) '%s at the breakpoints' /\n", prefix, prefix, Prop);
+   for( i = 0; i < nx; ++i )
+      for( j = 0; j < ny; ++j )
+      {
+         if( ny > 1 )
+            fprintf(out, "   i%d.j%d ", i+1, j+1);
+         else
+            fprintf(out, "   i%d ", i+1);
+         if( isfinite(F[i*ny + j]) )
+            fprintf(out, "%.17g\n", F[i*ny + j]);
+         else
+            fprintf(out, "NA\n");
+      }
+   fprintf(out, "   /;\n");
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   static const char* usage = "usage: propssipwl [-a abserr] [-e relerr] [-j threads] [-n maxpoints] [-o outfile] [-p prefix]\n"
+      "                  output name1 lo1 hi1 name2 lo2 hi2 fluid\n";
+   const char* prefix = "pwl";
+   const char *Prop, *Name1, *Name2, *Fluid;
+   char msg[ENGINE_MSGSIZE];
+   FILE* out = stdout;
+   BATCH batch;
+   double lo1, hi1, lo2, hi2;
+   double *x, *y, *v1, *v2, *f, *G, *Gnew, *F;
+   int *markx, *marky, *mapx, *mapy, *todo;
+   int maxpoints = 200;
+   int gotrelerr = 0;
+   int nx, ny, mx, my, npoints, ntodo, nfailed;
+   int opt, iter;
+   int i, j, k;
+
+   nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   while( (opt = getopt(argc, argv, "a:e:j:n:o:p:")) != -1 )
+   {
+      switch( opt )
+      {
+         case 'a' :
+            abserr = atof(optarg);
+            break;
+         case 'e' :
+            relerr = atof(optarg);
+            gotrelerr = 1;
+            break;
+         case 'j' :
+            nthreads = atoi(optarg);
+            break;
+         case 'n' :
+            maxpoints = atoi(optarg);
+            break;
+         case 'o' :
+            out = fopen(optarg, "w");
+            if( out == NULL )
+            {
+               perror(optarg);
+               return 1;
+            }
+            break;
+         case 'p' :
+            prefix = optarg;
+            break;
+         default :
+            fputs(usage, stderr);
+            return 1;
+      }
+   }
+   if( argc - optind != 8 )
+   {
+      fputs(usage, stderr);
+      return 1;
+   }
+   Prop = argv[optind];
+   Name1 = argv[optind+1];
+   lo1 = atof(argv[optind+2]);
+   hi1 = atof(argv[optind+3]);
+   Name2 = argv[optind+4];
+   lo2 = atof(argv[optind+5]);
+   hi2 = atof(argv[optind+6]);
+   Fluid = argv[optind+7];
+   if( !(lo1 < hi1) || !(lo2 <= hi2) || maxpoints < 2 || (abserr <= 0.0 && relerr <= 0.0 && gotrelerr) )
+   {
+      fprintf(stderr, "propssipwl: need lo1 < hi1, lo2 <= hi2, at least 2 points, and a positive error\n");
+      return 1;
+   }
+   /* an absolute error alone replaces the default relative error */
+   if( abserr > 0.0 && !gotrelerr )
+      relerr = 0.0;
+   if( nthreads < 1 )
+      nthreads = 1;
+   if( nthreads > PWL_MAXTHREADS )
+      nthreads = PWL_MAXTHREADS;
+
+   memset(&batch, 0, sizeof(batch));
+   batch.cache = cachecreate(msg);
+   if( batch.cache == NULL && msg[0] != '\0' )
+      fprintf(stderr, "propssipwl: %s Continuing without the state cache.\n", msg);
+   batch.prop = Prop;
+   batch.name1 = Name1;
+   batch.name2 = Name2;
+   batch.fluid = Fluid;
+
+   x = malloc(maxpoints * sizeof(double));
+   y = malloc(maxpoints * sizeof(double));
+   markx = calloc(maxpoints, sizeof(int));
+   marky = calloc(maxpoints, sizeof(int));
+   mapx = malloc(2 * maxpoints * sizeof(int));
+   mapy = malloc(2 * maxpoints * sizeof(int));
+   nx = maxpoints < PWL_INITPOINTS ? maxpoints : PWL_INITPOINTS;
+   ny = lo2 < hi2 ? nx : 1;
+   for( i = 0; i < nx; ++i )
+      x[i] = lo1 + (hi1 - lo1) * i / (nx - 1);
+   for( j = 0; j < ny; ++j )
+      y[j] = ny > 1 ? lo2 + (hi2 - lo2) * j / (ny - 1) : lo2;
+
+   /* values at the breakpoints, midpoints of the edges, and cell centers:
+    * G[a*my + b] at position a along the first and b along the second input (see refine())
+    */
+   npoints = 4 * maxpoints * maxpoints;
+   G = malloc(npoints * sizeof(double));
+   Gnew = malloc(npoints * sizeof(double));
+   F = malloc(maxpoints * maxpoints * sizeof(double));
+   v1 = malloc(npoints * sizeof(double));
+   v2 = malloc(npoints * sizeof(double));
+   f = malloc(npoints * sizeof(double));
+   todo = malloc(npoints * sizeof(int));
+
+   /* CoolProp loads its fluid data on first use, which must not happen on several threads at once */
+   batch.n = 1;
+   batch.v1 = x;
+   batch.v2 = y;
+   batch.f = f;
+   {
+      WORK w = { &batch, 0, 1 };
+      evalrange(&w);
+   }
+
+   /* initially, all positions are new */
+   mx = 2 * nx - 1;
+   my = 2 * ny - 1;
+   for( ntodo = 0; ntodo < mx * my; ++ntodo )
+      todo[ntodo] = ntodo;
+
+   for( iter = 0; ; ++iter )
+   {
+      double maxabs = 0.0, maxrel = 0.0;
+      int nmarkx = 0, nmarky = 0;
+
+      for( k = 0; k < ntodo; ++k )
+      {
+         int a = todo[k] / my;
+         int b = todo[k] % my;
+         v1[k] = a % 2 == 0 ? x[a/2] : 0.5 * (x[a/2] + x[a/2+1]);
+         v2[k] = b % 2 == 0 ? y[b/2] : 0.5 * (y[b/2] + y[b/2+1]);
+      }
+      batch.n = ntodo;
+      batch.v1 = v1;
+      batch.v2 = v2;
+      batch.f = f;
+      evalbatch(&batch);
+      for( k = 0; k < ntodo; ++k )
+         G[todo[k]] = f[k];
+
+      memset(markx, 0, maxpoints * sizeof(int));
+      memset(marky, 0, maxpoints * sizeof(int));
+      for( i = 0; i < nx-1; ++i )
+         for( j = 0; j < ny; ++j )
+            if( violates(G[(2*i+1)*my + 2*j], 0.5 * (G[2*i*my + 2*j] + G[(2*i+2)*my + 2*j]), &maxabs, &maxrel) )
+               markx[i] = 1;
+      for( i = 0; i < nx; ++i )
+         for( j = 0; j < ny-1; ++j )
+            if( violates(G[2*i*my + 2*j+1], 0.5 * (G[2*i*my + 2*j] + G[2*i*my + 2*j+2]), &maxabs, &maxrel) )
+               marky[j] = 1;
+      for( i = 0; i < nx-1; ++i )
+         for( j = 0; j < ny-1; ++j )
+         {
+            double fc = G[(2*i+1)*my + 2*j+1];
+            /* evaluate both so that the largest error is tracked */
+            int diag1 = violates(fc, 0.5 * (G[2*i*my + 2*j] + G[(2*i+2)*my + 2*j+2]), &maxabs, &maxrel);
+            int diag2 = violates(fc, 0.5 * (G[(2*i+2)*my + 2*j] + G[2*i*my + 2*j+2]), &maxabs, &maxrel);
+            if( diag1 || diag2 )
+               markx[i] = marky[j] = 1;
+         }
+      for( i = 0; i < nx-1; ++i )
+         nmarkx += markx[i];
+      for( j = 0; j < ny-1; ++j )
+         nmarky += marky[j];
+
+      fprintf(stderr, "propssipwl: iteration %d: %d x %d breakpoints, %d states evaluated, error %.3g (absolute), %.3g (relative)\n",
+         iter, nx, ny, ntodo, maxabs, maxrel);
+      if( (nmarkx == 0 && nmarky == 0) || nx + nmarkx > maxpoints || ny + nmarky > maxpoints )
+      {
+         if( nmarkx > 0 || nmarky > 0 )
+            fprintf(stderr, "propssipwl: target error not met within %d breakpoints per input\n", maxpoints);
+         for( i = 0; i < nx; ++i )
+            for( j = 0; j < ny; ++j )
+               F[i*ny + j] = G[2*i*my + 2*j];
+         for( nfailed = 0, k = 0; k < nx * ny; ++k )
+            nfailed += !isfinite(F[k]);
+         if( nfailed > 0 )
+            fprintf(stderr, "propssipwl: %d breakpoints failed and are written as NA\n", nfailed);
+         writegams(out, prefix, Prop, Name1, x, nx, Name2, y, ny, Fluid, F, maxabs, maxrel);
+         break;
+      }
+      nx = refine(x, nx, markx, mapx);
+      ny = refine(y, ny, marky, mapy);
+
+      /* carry over the values at positions that were evaluated already */
+      ntodo = 0;
+      for( i = 0; i < 2*nx-1; ++i )
+         for( j = 0; j < 2*ny-1; ++j )
+         {
+            k = i * (2*ny-1) + j;
+            if( mapx[i] >= 0 && mapy[j] >= 0 )
+               Gnew[k] = G[mapx[i]*my + mapy[j]];
+            else
+               todo[ntodo++] = k;
+         }
+      mx = 2 * nx - 1;
+      my = 2 * ny - 1;
+      {
+         double* tmp = G;
+         G = Gnew;
+         Gnew = tmp;
+      }
+   }
+
+   if( out != stdout )
+      fclose(out);
+   cachefree(batch.cache);
+   free(x);
+   free(y);
+   free(markx);
+   free(marky);
+   free(mapx);
+   free(mapy);
+   free(G);
+   free(Gnew);
+   free(F);
+   free(v1);
+   free(v2);
+   free(f);
+   free(todo);
+   return 0;
+}
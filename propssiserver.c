@@ -0,0 +1,172 @@
+/** Client side of the local property server
+ *
+ * See propssiserver.h.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "propssiserver.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* a stalled server must not stall the solve; we then fall back to in-process evaluation */
+#define SERVER_TIMEOUT 10
+
+/* a vanished server must not raise SIGPIPE in the GAMS process */
+#if defined(MSG_NOSIGNAL)
+# define SERVER_SENDFLAGS MSG_NOSIGNAL
+#else
+# define SERVER_SENDFLAGS 0
+#endif
+
+int serverconnect(
+   const char*           path
+   )
+{
+   struct sockaddr_un addr;
+   struct timeval tv = { SERVER_TIMEOUT, 0 };
+   int fd;
+
+   if( strlen(path) >= sizeof(addr.sun_path) )
+      return -1;
+
+   fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if( fd < 0 )
+      return -1;
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+   if( connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 )
+   {
+      close(fd);
+      return -1;
+   }
+   setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+   setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#if defined(SO_NOSIGPIPE)
+   {
+      int on = 1;
+      setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+   }
+#endif
+
+   return fd;
+}
+
+void serverclose(
+   int                   fd
+   )
+{
+   if( fd >= 0 )
+      close(fd);
+}
+
+int serverio(
+   int                   fd,
+   void*                 buf,
+   size_t                len,
+   int                   writing
+   )
+{
+   char* p = (char*)buf;
+
+   while( len > 0 )
+   {
+      ssize_t n = writing ? send(fd, p, len, SERVER_SENDFLAGS) : recv(fd, p, len, 0);
+      if( n < 0 && errno == EINTR )
+         continue;
+      if( n <= 0 )
+         return -1;
+      p += n;
+      len -= (size_t)n;
+   }
+   return 0;
+}
+
+#else
+
+int serverconnect(
+   const char*           path
+   )
+{
+   (void)path;
+   return -1;
+}
+
+void serverclose(
+   int                   fd
+   )
+{
+   (void)fd;
+}
+
+int serverio(
+   int                   fd,
+   void*                 buf,
+   size_t                len,
+   int                   writing
+   )
+{
+   (void)fd; (void)buf; (void)len; (void)writing;
+   return -1;
+}
+
+#endif
+
+int serverevalprops(
+   int                   fd,
+   const char*           Prop,
+   const char*           Name1,
+   double                Val1,
+   const char*           Name2,
+   double                Val2,
+   const char*           Fluid,
+   int                   derivrequest,
+   double                d[6],
+   char*                 errmsg
+   )
+{
+   SERVERREQUEST request;
+   SERVERRESPONSE response;
+
+   if( strlen(Prop) >= sizeof(request.prop) || strlen(Name1) >= sizeof(request.name1)
+      || strlen(Name2) >= sizeof(request.name2) || strlen(Fluid) >= sizeof(request.fluid) )
+   {
+      return -2;
+   }
+
+   memset(&request, 0, sizeof(request));
+   strcpy(request.prop, Prop);
+   strcpy(request.name1, Name1);
+   strcpy(request.name2, Name2);
+   strcpy(request.fluid, Fluid);
+   request.val1 = Val1;
+   request.val2 = Val2;
+   request.derivrequest = derivrequest;
+
+   if( serverio(fd, &request, sizeof(request), 1) != 0 || serverio(fd, &response, sizeof(response), 0) != 0 )
+   {
+      serverclose(fd);
+      return -1;
+   }
+
+   memcpy(d, response.d, sizeof(response.d));
+   if( response.status != 0 )
+   {
+      response.msg[ENGINE_MSGSIZE-1] = '\0';
+      strcpy(errmsg, response.msg);
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,86 @@
+/** Local property server of the extrinsic CoolProp library
+ *
+ * If the environment variable PROPSSI_SERVER names the Unix domain socket
+ * of a running property server (propssid), the function library forwards
+ * state evaluations to it instead of evaluating them in-process. The
+ * server keeps warm AbstractState handles and a state cache for all its
+ * clients and batches value requests that arrive together. If no server
+ * is listening, or the connection fails later, the library evaluates
+ * in-process as usual.
+ *
+ * Requests and responses are fixed-size records in native byte order;
+ * the socket is local to the node.
+ */
+
+#ifndef PROPSSISERVER_H_
+#define PROPSSISERVER_H_
+
+#include "propssiengine.h"
+
+/** default socket path of the property server */
+#define SERVER_DEFPATH "/tmp/propssi.sock"
+
+/** state evaluation request */
+typedef struct
+{
+   char   prop[16];        /**< output property */
+   char   name1[16];       /**< first input property */
+   char   name2[16];       /**< second input property */
+   char   fluid[64];       /**< fluid name */
+   double val1;            /**< first input value */
+   double val2;            /**< second input value */
+   int    derivrequest;    /**< highest derivative to compute */
+} SERVERREQUEST;
+
+/** state evaluation response */
+typedef struct
+{
+   int    status;                  /**< 0 if successful, <> 0 if CoolProp failed */
+   double d[6];                    /**< value and derivatives as in evalprops() */
+   char   msg[ENGINE_MSGSIZE];     /**< error message if status <> 0 */
+} SERVERRESPONSE;
+
+/** Connects to the property server
+ *
+ * @return socket descriptor, or -1 if no server is listening at path.
+ */
+int serverconnect(
+   const char*           path             /**< socket path */
+   );
+
+/** Closes the connection to the property server */
+void serverclose(
+   int                   fd               /**< socket descriptor */
+   );
+
+/** Evaluates a state on the property server
+ *
+ * @return 0 if successful, 1 if CoolProp failed on the server (errmsg is set),
+ *         -1 if the connection failed (the socket is closed then),
+ *         -2 if the names do not fit into a request (the state is to be evaluated in-process).
+ */
+int serverevalprops(
+   int                   fd,              /**< socket descriptor */
+   const char*           Prop,            /**< output property */
+   const char*           Name1,           /**< first input property */
+   double                Val1,            /**< first input value */
+   const char*           Name2,           /**< second input property */
+   double                Val2,            /**< second input value */
+   const char*           Fluid,           /**< fluid name */
+   int                   derivrequest,    /**< highest derivative to compute */
+   double                d[6],            /**< buffer for value and derivatives */
+   char*                 errmsg           /**< buffer of length ENGINE_MSGSIZE to store error message (as C string!) */
+   );
+
+/** Reads or writes a complete record on a socket
+ *
+ * @return 0 if successful, -1 if the connection failed.
+ */
+int serverio(
+   int                   fd,              /**< socket descriptor */
+   void*                 buf,             /**< record */
+   size_t                len,             /**< record length */
+   int                   writing          /**< whether to write (or read) */
+   );
+
+#endif /* PROPSSISERVER_H_ */
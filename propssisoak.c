@@ -0,0 +1,398 @@
+/** Soak test of the function library
+ *
+ * In production, the library lives for the whole GAMS job and sees tens
+ * of millions of calls, so any growth of CoolProp handles, caches, or
+ * buffers eventually degrades the node. This driver calls the library
+ * through its GAMS API, as the execution system does, in two phases:
+ *
+ *   1. cycles of xcreate, libinit, a batch of PropsSI2 calls, and xfree,
+ *      after each of which no AbstractState handle may be left,
+ *   2. one instance answering a long run of PropsSI2 calls.
+ *
+ * The calls evaluate density, enthalpy, or entropy at random pressure-
+ * temperature states of the fluids of FLUID2 in propssicclib.c, mixtures
+ * at one call in a hundred. A tenth of the calls have inputs CoolProp
+ * cannot evaluate (negative pressure, temperature below the range of the
+ * equation of state, or an unknown fluid), a fifth repeat one of the
+ * last states, and the derivative request cycles through 0, 1, and 2.
+ *
+ * Unless PROPSSI_SPECULATE is set, every other cycle evaluates states
+ * speculatively in the background (PROPSSI_SPECULATE=1), so that xfree
+ * meets the speculative thread in the middle of its work.
+ *
+ * Resident memory, heap in use, live AbstractState handles, and the
+ * occupied slots of the state cache are printed before xfree of every
+ * tenth cycle and at every sample interval of the long run. The test
+ * fails if handles or threads are left after xfree, or if resident memory grows by
+ * more than the bound from the end of the first tenth of the cycles to
+ * the last cycle, or from the first to the last sample of the long run.
+ * The first cycles and calls warm up CoolProp and the allocator. The
+ * configuration of the library is taken from the environment as usual,
+ * e.g. PROPSSI_CACHESIZE or PROPSSI_HANDLEMEM.
+ *
+ * Usage:
+ *
+ *   propssisoak [-c cycles] [-b calls per cycle] [-n calls] [-s interval] [-m MB]
+ *
+ * The defaults are 200 cycles of 1000 calls, a run of 5000000 calls
+ * sampled every 500000 calls, and a bound of 16 MB.
+ *
+ * Compilation (Linux; live handles and the cache are observed by wrapping
+ * the functions creating them at link time):
+ *
+ *   gcc -O2 -o propssisoak propssisoak.c propssicclib.c propssicache.c propssiengine.c
+ *       propssiserver.c propssieosgen.c propssimixture.c propssicheb.c libCoolProp.so
+ *       -lm -lpthread -lrt -Wl,--wrap=AbstractState_factory,--wrap=AbstractState_free
+ *       -Wl,--wrap=cachecreate,--wrap=cachefree
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2
+#endif
+
+#include "extrfunc.h"
+#include "CoolPropLib.h"
+#include "propssicache.h"
+#include "propssimixture.h"
+
+#define SOAK_MAXFLUIDS  20
+#define SOAK_HISTORY    64
+
+EXTRFUNC_DECL_FUNCCALL(PropsSI2);
+EXTRFUNC_API void EXTRFUNC_CALLCONV xcreate(EXTRFUNC_DATA** data);
+EXTRFUNC_API void EXTRFUNC_CALLCONV xfree(EXTRFUNC_DATA** data);
+EXTRFUNC_API int EXTRFUNC_CALLCONV libinit(EXTRFUNC_DATA* data, int version, char* msg);
+
+extern char* FLUID2[];
+
+/* observed through the wrapped functions */
+static long livehandles = 0;
+static long peakhandles = 0;
+static PROPSSICACHE* livecache = NULL;
+
+long __real_AbstractState_factory(const char* backend, const char* fluids, long* errcode, char* message_buffer, const long buffer_length);
+void __real_AbstractState_free(const long handle, long* errcode, char* message_buffer, const long buffer_length);
+PROPSSICACHE* __real_cachecreate(char* msg);
+void __real_cachefree(PROPSSICACHE* cache);
+
+long __wrap_AbstractState_factory(
+   const char*           backend,
+   const char*           fluids,
+   long*                 errcode,
+   char*                 message_buffer,
+   const long            buffer_length
+   )
+{
+   long handle = __real_AbstractState_factory(backend, fluids, errcode, message_buffer, buffer_length);
+
+   if( *errcode == 0 && ++livehandles > peakhandles )
+      peakhandles = livehandles;
+   return handle;
+}
+
+void __wrap_AbstractState_free(
+   const long            handle,
+   long*                 errcode,
+   char*                 message_buffer,
+   const long            buffer_length
+   )
+{
+   __real_AbstractState_free(handle, errcode, message_buffer, buffer_length);
+   if( *errcode == 0 )
+      --livehandles;
+}
+
+PROPSSICACHE* __wrap_cachecreate(
+   char*                 msg
+   )
+{
+   return livecache = __real_cachecreate(msg);
+}
+
+void __wrap_cachefree(
+   PROPSSICACHE*         cache
+   )
+{
+   if( cache == livecache )
+      livecache = NULL;
+   __real_cachefree(cache);
+}
+
+/** fluids and their temperature ranges */
+static int nfluids = 0;
+static double Tlo[SOAK_MAXFLUIDS];
+static double Thi[SOAK_MAXFLUIDS];
+static int mixture[SOAK_MAXFLUIDS];
+
+/** last states, for repeated calls */
+static double history[SOAK_HISTORY][6];
+static unsigned long ncalls = 0;
+static unsigned long nerrors = 0;
+
+static EXTRFUNC_RETURN EXTRFUNC_CALLCONV counterror(
+   EXTRFUNC_RETURN       retcode,
+   EXTRFUNC_EVALERROR    exccode,
+   char*                 msg,
+   void*                 usrmem
+   )
+{
+   (void)exccode;
+   (void)msg;
+   (void)usrmem;
+   ++nerrors;
+   return retcode;
+}
+
+/** Resident memory of the process in MB */
+static double rss(void)
+{
+   long pages = 0, resident = 0;
+   FILE* f = fopen("/proc/self/statm", "r");
+
+   if( f == NULL )
+      return 0.0;
+   if( fscanf(f, "%ld %ld", &pages, &resident) != 2 )
+      resident = 0;
+   fclose(f);
+   return resident * (double)sysconf(_SC_PAGESIZE) / 1048576.0;
+}
+
+/** Threads of the process, -1 if unknown */
+static long threads(void)
+{
+   char line[128];
+   long n = -1;
+   FILE* f = fopen("/proc/self/status", "r");
+
+   if( f == NULL )
+      return -1;
+   while( fgets(line, sizeof(line), f) != NULL )
+      if( sscanf(line, "Threads: %ld", &n) == 1 )
+         break;
+   fclose(f);
+   return n;
+}
+
+/** Heap in use in MB, 0 if unknown */
+static double heap(void)
+{
+#if defined(HAVE_MALLINFO2)
+   struct mallinfo2 mi = mallinfo2();
+   return (mi.uordblks + mi.hblkhd) / 1048576.0;
+#else
+   return 0.0;
+#endif
+}
+
+static double uniform(
+   double                lo,
+   double                hi
+   )
+{
+   return lo + (hi - lo) * rand() / (double)RAND_MAX;
+}
+
+/** Calls PropsSI2 once with the next inputs of the mix */
+static void call(
+   EXTRFUNC_DATA*        data
+   )
+{
+   static const double props[3] = { 2, 4, 5 };   /* D, H, S in PROPERTY */
+   double x[6], f, gradient[6], hessian[36];
+   int r = rand() % 100;
+   int fluid;
+
+   if( r < 20 && ncalls >= SOAK_HISTORY )
+      memcpy(x, history[rand() % SOAK_HISTORY], sizeof(x));
+   else
+   {
+      do
+         fluid = rand() % nfluids;
+      while( mixture[fluid] && rand() % 100 != 0 );
+      x[0] = props[rand() % 3];
+      x[1] = 0;                                  /* P */
+      x[2] = exp(uniform(log(1e5), log(5e6)));
+      x[3] = 1;                                  /* T */
+      x[4] = uniform(Tlo[fluid], Thi[fluid]);
+      x[5] = fluid;
+      if( r >= 90 )
+      {
+         if( r < 94 )
+            x[2] = -x[2];
+         else if( r < 97 )
+            x[4] = 0.5 * Tlo[fluid];
+         else
+            x[5] = nfluids;                     /* the empty entry ending FLUID2 */
+      }
+      memcpy(history[ncalls % SOAK_HISTORY], x, sizeof(x));
+   }
+   PropsSI2(data, (int)(ncalls % 3), 6, x, &f, gradient, hessian, counterror, NULL);
+   ++ncalls;
+}
+
+static void report(
+   const char*           phase,
+   unsigned long         step,
+   double                t
+   )
+{
+   uint64_t nslots;
+   uint64_t used = cacheused(livecache, &nslots);
+
+   printf("%-6s %10lu %10.1f %9.1f %9.1f %8ld %10llu/%llu\n", phase, step, t, rss(), heap(), livehandles,
+      (unsigned long long)used, (unsigned long long)nslots);
+   fflush(stdout);
+}
+
+static double elapsed(
+   const struct timespec* start
+   )
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (now.tv_sec - start->tv_sec) + 1e-9 * (now.tv_nsec - start->tv_nsec);
+}
+
+int main(
+   int                   argc,
+   char**                argv
+   )
+{
+   struct timespec start;
+   EXTRFUNC_DATA* data;
+   char msg[256];
+   int cycles = 200;
+   long batch = 1000;
+   long calls = 5000000;
+   long interval = 500000;
+   double bound = 16.0;
+   double rss0 = 0.0, growth;
+   int failed = 0;
+   int speculate = getenv("PROPSSI_SPECULATE") == NULL;
+   long nthreads = threads();
+   int opt, c;
+   long i;
+
+   while( (opt = getopt(argc, argv, "c:b:n:s:m:")) != -1 )
+   {
+      if( (opt == 'c' && (cycles = atoi(optarg)) >= 0)
+         || (opt == 'b' && (batch = atol(optarg)) > 0)
+         || (opt == 'n' && (calls = atol(optarg)) >= 0)
+         || (opt == 's' && (interval = atol(optarg)) > 0)
+         || (opt == 'm' && (bound = atof(optarg)) > 0.0) )
+         continue;
+      fprintf(stderr, "usage: propssisoak [-c cycles] [-b calls per cycle] [-n calls] [-s interval] [-m MB]\n");
+      return 1;
+   }
+
+   for( nfluids = 0; nfluids < SOAK_MAXFLUIDS && FLUID2[nfluids] != NULL && FLUID2[nfluids][0] != '\0'; ++nfluids )
+   {
+      mixture[nfluids] = mixtureis(FLUID2[nfluids]);
+      Tlo[nfluids] = mixture[nfluids] ? NAN : Props1SI(FLUID2[nfluids], "Tmin");
+      Thi[nfluids] = mixture[nfluids] ? NAN : Props1SI(FLUID2[nfluids], "Tmax");
+      if( !isfinite(Tlo[nfluids]) || !isfinite(Thi[nfluids]) || !(Tlo[nfluids] < Thi[nfluids]) )
+      {
+         Tlo[nfluids] = 250.0;
+         Thi[nfluids] = 450.0;
+      }
+      else
+      {
+         /* keep clear of the limits of the equation of state */
+         double w = Thi[nfluids] - Tlo[nfluids];
+         Tlo[nfluids] += 0.05 * w;
+         Thi[nfluids] -= 0.05 * w;
+      }
+   }
+   if( nfluids == 0 )
+   {
+      fprintf(stderr, "propssisoak: no fluids\n");
+      return 1;
+   }
+   srand(1);
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   printf("%-6s %10s %10s %9s %9s %8s %10s\n", "phase", "step", "time [s]", "RSS [MB]", "heap [MB]", "handles", "cache");
+
+   for( c = 1; c <= cycles; ++c )
+   {
+      if( speculate )
+         setenv("PROPSSI_SPECULATE", c % 2 == 0 ? "1" : "0", 1);
+      xcreate(&data);
+      if( libinit(data, 1, msg) != 0 )
+      {
+         fprintf(stderr, "propssisoak: libinit: %.*s\n", (int)(unsigned char)msg[0], msg+1);
+         return 1;
+      }
+      for( i = 0; i < batch; ++i )
+         call(data);
+      if( c == 1 || c == cycles || c % 10 == 0 )
+         report("cycle", (unsigned long)c, elapsed(&start));
+      xfree(&data);
+      if( livehandles != 0 )
+      {
+         fprintf(stderr, "propssisoak: %ld handles left after xfree in cycle %d\n", livehandles, c);
+         failed = 1;
+      }
+      if( threads() != nthreads )
+      {
+         fprintf(stderr, "propssisoak: %ld threads left after xfree in cycle %d\n", threads() - nthreads, c);
+         failed = 1;
+      }
+      if( c == (cycles >= 10 ? cycles / 10 : 1) )
+         rss0 = rss();
+   }
+   if( speculate )
+      unsetenv("PROPSSI_SPECULATE");
+   if( cycles > 1 )
+   {
+      growth = rss() - rss0;
+      printf("cycles: resident memory grew by %.1f MB (bound %.1f MB)\n", growth, bound);
+      if( growth > bound )
+         failed = 1;
+   }
+
+   if( calls > 0 )
+   {
+      xcreate(&data);
+      if( libinit(data, 1, msg) != 0 )
+      {
+         fprintf(stderr, "propssisoak: libinit: %.*s\n", (int)(unsigned char)msg[0], msg+1);
+         return 1;
+      }
+      for( i = 1; i <= calls; ++i )
+      {
+         call(data);
+         if( i % interval == 0 || i == calls )
+         {
+            if( i == (interval < calls ? interval : calls) )
+               rss0 = rss();
+            report("run", (unsigned long)i, elapsed(&start));
+         }
+      }
+      growth = rss() - rss0;
+      xfree(&data);
+      printf("run: resident memory grew by %.1f MB (bound %.1f MB)\n", growth, bound);
+      if( growth > bound )
+         failed = 1;
+      if( livehandles != 0 )
+      {
+         fprintf(stderr, "propssisoak: %ld handles left after xfree\n", livehandles);
+         failed = 1;
+      }
+   }
+
+   printf("%lu calls (%lu failed), at most %ld live handles: %s\n", ncalls, nerrors, peakhandles,
+      failed ? "FAILED" : "passed");
+   return failed;
+}